@@ -0,0 +1,632 @@
+/**
+ * pareto_sweep.cpp
+ *
+ * 精度 / 速度 Pareto 扫描 - 为生产环境挑选采样参数
+ *
+ * 扫描四个可调参数:
+ *   numRays          每部雷达射线数
+ *   losSamples       视线检查采样数 (SamplingSettings::losSamples, 默认 40)
+ *   rangeTolerance   二分搜索容差   (SamplingSettings::rangeTolerance, 默认 0.01;
+ *                    src/main.cpp 中独立实现的演示模型使用 0.02)
+ *   simplifyEpsilon  Douglas-Peucker 简化阈值
+ *
+ * 每个组合在各场景上运行完整的 CoverageMergeManager 流水线（取多次运行的中位数），
+ * 并与高分辨率参考结果比较:
+ *   area_error     |A - A_ref| / A_ref
+ *   symdiff_error  area(A xor A_ref) / A_ref
+ *   hausdorff      边界间对称 Hausdorff 距离（边界按固定步长加密后计算）
+ * 参考结果不做简化（simplifyEpsilon 是扫描轴），但与被测配置一样按场景设置平滑，
+ * 使误差只反映被扫描参数，而非后处理的差异；平滑次数不参与扫描。
+ *
+ * 在 (耗时, symdiff_error, hausdorff) 三个目标上求非支配解，输出:
+ *   <out>.csv   全部组合（pareto 列标记前沿）
+ *   <out>.json  Pareto 前沿（按耗时升序）
+ *
+ * 用法:
+ *   radar_coverage_pareto [--rays 36,72,144,360] [--samples 10,20,40,80]
+ *                         [--tolerance 0.02,0.01,0.005,0.0025] [--epsilon 0,1,2,5]
+ *                         [--reps 3] [--ref-rays 1440] [--ref-samples 200]
+ *                         [--ref-tolerance 0.001] [--out pareto] [--no-builtin]
+ *                         [scenario files...]
+ */
+
+#include "polygon_boolean.hpp"
+#include "radar_coverage.hpp"
+#include "scenario.hpp"
+#include "parallel_for.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace polygon_ops;
+namespace rc = radar_coverage;
+
+namespace {
+
+// ============================================================================
+// 命令行
+// ============================================================================
+
+struct SweepOptions {
+    std::vector<int> rays = {36, 72, 144, 360};
+    std::vector<int> samples = {10, 20, 40, 80};
+    std::vector<double> tolerances = {0.02, 0.01, 0.005, 0.0025};
+    std::vector<double> epsilons = {0.0, 1.0, 2.0, 5.0};
+    int reps = 3;
+    int refRays = 1440;
+    int refSamples = 200;
+    double refTolerance = 0.001;
+    std::string out = "pareto";
+    bool builtin = true;
+    std::vector<std::string> files;
+};
+
+template <typename T>
+std::vector<T> parseList(const std::string& text) {
+    std::vector<T> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        std::istringstream is(item);
+        T v;
+        if (!(is >> v)) throw std::runtime_error("invalid list value: " + item);
+        values.push_back(v);
+    }
+    if (values.empty()) throw std::runtime_error("empty list");
+    return values;
+}
+
+SweepOptions parseOptions(int argc, char** argv) {
+    SweepOptions opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--rays") opt.rays = parseList<int>(next());
+        else if (arg == "--samples") opt.samples = parseList<int>(next());
+        else if (arg == "--tolerance") opt.tolerances = parseList<double>(next());
+        else if (arg == "--epsilon") opt.epsilons = parseList<double>(next());
+        else if (arg == "--reps") opt.reps = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--ref-rays") opt.refRays = std::atoi(next().c_str());
+        else if (arg == "--ref-samples") opt.refSamples = std::atoi(next().c_str());
+        else if (arg == "--ref-tolerance") opt.refTolerance = std::atof(next().c_str());
+        else if (arg == "--out") opt.out = next();
+        else if (arg == "--no-builtin") opt.builtin = false;
+        else if (!arg.empty() && arg[0] == '-') throw std::runtime_error("unknown option " + arg);
+        else opt.files.push_back(arg);
+    }
+    return opt;
+}
+
+// ============================================================================
+// 标准场景
+// ============================================================================
+
+/**
+ * 与 radar_coverage_demo 相同的 5 雷达 / 3 山峰布局
+ */
+rc::Scenario demoScenario() {
+    rc::Scenario sc;
+    sc.name = "demo";
+    sc.settings.smoothIterations = 1;
+    sc.obstacles = {
+        {{400, 280}, 100, 80, 800, "中央大山"},
+        {{250, 400}, 50, 60, 400, "左下小山"},
+        {{550, 420}, 60, 50, 450, "右下小山"},
+    };
+    sc.radars = {
+        {1, "雷达 A", {200, 200}, 180, 80},
+        {2, "雷达 B", {600, 180}, 160, 100},
+        {3, "雷达 C", {150, 400}, 140, 70},
+        {4, "雷达 D", {650, 380}, 150, 90},
+        {5, "雷达 E", {400, 500}, 170, 85},
+    };
+    return sc;
+}
+
+/**
+ * 山脊地形：沿几条折线排布的高斯山峰，雷达在 4x3 网格上
+ */
+rc::Scenario ridgeScenario() {
+    rc::Scenario sc;
+    sc.name = "ridges";
+    sc.settings.smoothIterations = 1;
+
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<double> jitter(-150.0, 150.0);
+    std::uniform_real_distribution<double> radius(120.0, 350.0);
+    std::uniform_real_distribution<double> height(150.0, 700.0);
+    for (int ridge = 0; ridge < 4; ridge++) {
+        Point2D start(500.0 + ridge * 1800.0, 300.0);
+        Point2D dir(0.35, 1.0);
+        for (int k = 0; k < 10; k++) {
+            Point2D c(start.x + dir.x * k * 550.0 + jitter(rng),
+                      start.y + dir.y * k * 550.0 + jitter(rng));
+            sc.obstacles.emplace_back(c, radius(rng), radius(rng), height(rng));
+        }
+    }
+
+    int id = 1;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 4; col++) {
+            Point2D p(900.0 + col * 1900.0, 1200.0 + row * 2000.0);
+            sc.radars.emplace_back(id, "R" + std::to_string(id), p, 1600.0, 60.0);
+            id++;
+        }
+    }
+    return sc;
+}
+
+// ============================================================================
+// 误差度量
+// ============================================================================
+
+double multiPolygonArea(const MultiPolygon& mp) {
+    return PolygonStats::compute(mp).totalArea;
+}
+
+ClipperPaths toEvenOddPaths(const MultiPolygon& mp) {
+    ClipperPaths paths;
+    for (const auto& pwh : mp) {
+        paths.push_back(CoordinateConverter::toClipperPath(pwh.outer));
+        for (const auto& hole : pwh.holes) {
+            paths.push_back(CoordinateConverter::toClipperPath(hole));
+        }
+    }
+    return paths;
+}
+
+/**
+ * 对称差面积；孔洞方向与外环一致（classifyResult 输出），故使用 EvenOdd 填充规则
+ */
+double symmetricDifferenceArea(const MultiPolygon& a, const MultiPolygon& b) {
+    ClipperPaths solution;
+    Clipper2Lib::ClipperD clipper;
+    clipper.AddSubject(toEvenOddPaths(a));
+    clipper.AddClip(toEvenOddPaths(b));
+    clipper.Execute(Clipper2Lib::ClipType::Xor, Clipper2Lib::FillRule::EvenOdd, solution);
+
+    double area = 0.0;
+    for (const auto& path : solution) {
+        area += PolygonUtils::signedArea(CoordinateConverter::fromClipperPath(path));
+    }
+    return std::abs(area);
+}
+
+struct Segment {
+    Point2D a, b;
+};
+
+std::vector<Segment> boundarySegments(const MultiPolygon& mp) {
+    std::vector<Segment> segs;
+    auto addRing = [&segs](const Polygon& ring) {
+        for (size_t i = 0; i < ring.size(); i++) {
+            segs.push_back({ring[i], ring[(i + 1) % ring.size()]});
+        }
+    };
+    for (const auto& pwh : mp) {
+        addRing(pwh.outer);
+        for (const auto& hole : pwh.holes) addRing(hole);
+    }
+    return segs;
+}
+
+double pointSegmentDistance(const Point2D& p, const Segment& s) {
+    Point2D d = s.b - s.a;
+    double len2 = d.x * d.x + d.y * d.y;
+    double t = len2 > 0 ? ((p.x - s.a.x) * d.x + (p.y - s.a.y) * d.y) / len2 : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    return (p - (s.a + d * t)).length();
+}
+
+/**
+ * 线段均匀网格索引：由近及远逐圈搜索最近线段
+ *
+ * cellSize 不为正（如量程全为 0）或过小时改用线段范围的 1/kMaxCellsPerAxis。
+ */
+class SegmentGrid {
+public:
+    static constexpr double kMaxCellsPerAxis = 1024;
+
+    SegmentGrid(std::vector<Segment> segs, double cellSize)
+        : segs_(std::move(segs)), cell_(cellSize) {
+        minX_ = minY_ = std::numeric_limits<double>::max();
+        double maxX = std::numeric_limits<double>::lowest(), maxY = maxX;
+        for (const auto& s : segs_) {
+            minX_ = std::min({minX_, s.a.x, s.b.x});
+            minY_ = std::min({minY_, s.a.y, s.b.y});
+            maxX = std::max({maxX, s.a.x, s.b.x});
+            maxY = std::max({maxY, s.a.y, s.b.y});
+        }
+        if (segs_.empty()) minX_ = minY_ = maxX = maxY = 0.0;
+        const double extent = std::max(maxX - minX_, maxY - minY_);
+        const double minCell = extent > 0 ? extent / kMaxCellsPerAxis : 1.0;
+        if (!(cell_ >= minCell)) cell_ = minCell;
+        cols_ = static_cast<int>((maxX - minX_) / cell_) + 1;
+        rows_ = static_cast<int>((maxY - minY_) / cell_) + 1;
+        cells_.resize(static_cast<size_t>(cols_) * rows_);
+
+        for (size_t i = 0; i < segs_.size(); i++) {
+            const Segment& s = segs_[i];
+            int c0 = cellX(std::min(s.a.x, s.b.x)), c1 = cellX(std::max(s.a.x, s.b.x));
+            int r0 = cellY(std::min(s.a.y, s.b.y)), r1 = cellY(std::max(s.a.y, s.b.y));
+            for (int r = r0; r <= r1; r++) {
+                for (int c = c0; c <= c1; c++) {
+                    cells_[static_cast<size_t>(r) * cols_ + c].push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    }
+
+    double nearest(const Point2D& p) const {
+        int pc = cellX(p.x), pr = cellY(p.y);
+        double best = std::numeric_limits<double>::infinity();
+        int maxRing = std::max(cols_, rows_);
+        for (int ring = 0; ring <= maxRing; ring++) {
+            // 第 ring 圈之外的线段距离至少为 ring * cell
+            if (best <= (ring - 1) * cell_) break;
+            for (int r = pr - ring; r <= pr + ring; r++) {
+                if (r < 0 || r >= rows_) continue;
+                bool edgeRow = (r == pr - ring || r == pr + ring);
+                int step = edgeRow ? 1 : 2 * ring;
+                for (int c = pc - ring; c <= pc + ring; c += std::max(step, 1)) {
+                    if (c < 0 || c >= cols_) continue;
+                    for (uint32_t i : cells_[static_cast<size_t>(r) * cols_ + c]) {
+                        best = std::min(best, pointSegmentDistance(p, segs_[i]));
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    int cellX(double x) const {
+        return std::max(0, std::min(cols_ - 1, static_cast<int>((x - minX_) / cell_)));
+    }
+    int cellY(double y) const {
+        return std::max(0, std::min(rows_ - 1, static_cast<int>((y - minY_) / cell_)));
+    }
+
+    std::vector<Segment> segs_;
+    double cell_;
+    double minX_, minY_;
+    int cols_, rows_;
+    std::vector<std::vector<uint32_t>> cells_;
+};
+
+/**
+ * 有向 Hausdorff 距离：from 的边界按 step 加密后到 to 边界的最大距离
+ */
+double directedHausdorff(const std::vector<Segment>& from, const SegmentGrid& to, double step) {
+    double worst = 0.0;
+    for (const auto& s : from) {
+        double len = (s.b - s.a).length();
+        int n = std::max(1, static_cast<int>(std::ceil(len / step)));
+        for (int k = 0; k < n; k++) {
+            Point2D p = s.a + (s.b - s.a) * (static_cast<double>(k) / n);
+            worst = std::max(worst, to.nearest(p));
+        }
+    }
+    return worst;
+}
+
+// ============================================================================
+// 扫描
+// ============================================================================
+
+struct Config {
+    int rays;
+    int samples;
+    double tolerance;
+    double epsilon;
+};
+
+struct Measurement {
+    double timeMs = 0.0;
+    double areaError = 0.0;
+    double symDiffError = 0.0;
+    double hausdorff = 0.0;
+};
+
+struct Result {
+    Config config;
+    Measurement total;                  // 耗时求和，面积误差取均值，Hausdorff 取最大
+    std::vector<Measurement> perScenario;
+    bool pareto = false;
+};
+
+struct Reference {
+    MultiPolygon merged;
+    double area;
+    std::vector<Segment> segments;
+    SegmentGrid grid;
+    double step;
+};
+
+void applyConfig(rc::CoverageMergeManager& manager, const Config& c) {
+    manager.setNumRays(c.rays);
+    rc::SamplingSettings sampling;
+    sampling.losSamples = c.samples;
+    sampling.rangeTolerance = c.tolerance;
+    manager.setSamplingSettings(sampling);
+    manager.setSimplifyEpsilon(c.epsilon);
+}
+
+/**
+ * 参考结果：各雷达并行生成（仅一次，不计入扫描耗时）
+ */
+Reference buildReference(const rc::Scenario& sc, const SweepOptions& opt) {
+    rc::CoverageMergeManager manager;
+    rc::applyScenario(sc, manager);
+    rc::SamplingSettings sampling;
+    sampling.losSamples = opt.refSamples;
+    sampling.rangeTolerance = opt.refTolerance;
+    manager.setSamplingSettings(sampling);
+
+    const auto& radars = manager.getRadars();
+    std::vector<Polygon> coverages(radars.size());
+    parallelFor(radars.size(), 0, [&](size_t i, unsigned) {
+        coverages[i] = rc::generateCoveragePolygon(radars[i], manager.terrain(), opt.refRays);
+    }, 1);
+
+    // 与 CoverageMergeManager 相同的后处理，简化阈值取 0
+    MultiPolygon merged = PolygonBoolean::unionAll(coverages);
+    if (manager.getSmoothIterations() > 0) {
+        merged = PolygonProcessor::smoothAll(merged, manager.getSmoothIterations());
+    }
+    double meanRange = 0.0;
+    for (const auto& r : radars) meanRange += r.range;
+    meanRange /= std::max<size_t>(radars.size(), 1);
+
+    // 加密步长与网格单元取平均量程的 0.2% / 1%
+    double step = std::max(meanRange * 0.002, 1e-6);
+    std::vector<Segment> segments = boundarySegments(merged);
+    SegmentGrid grid(segments, meanRange * 0.01);
+    double area = multiPolygonArea(merged);
+    return {std::move(merged), area, std::move(segments), std::move(grid), step};
+}
+
+Measurement measure(const rc::Scenario& sc, const Reference& ref, const Config& c, int reps) {
+    std::vector<double> times;
+    MultiPolygon merged;
+    for (int r = 0; r < reps; r++) {
+        rc::CoverageMergeManager manager;
+        rc::applyScenario(sc, manager);
+        applyConfig(manager, c);
+
+        auto start = std::chrono::steady_clock::now();
+        merged = manager.getMergedCoverage();
+        times.push_back(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    Measurement m;
+    m.timeMs = times[times.size() / 2];
+    double area = multiPolygonArea(merged);
+    m.areaError = ref.area > 0 ? std::abs(area - ref.area) / ref.area : 0.0;
+    m.symDiffError = ref.area > 0 ? symmetricDifferenceArea(merged, ref.merged) / ref.area : 0.0;
+
+    std::vector<Segment> segments = boundarySegments(merged);
+    if (segments.empty() || ref.segments.empty()) {
+        m.hausdorff = segments.size() == ref.segments.size()
+            ? 0.0 : std::numeric_limits<double>::infinity();
+    } else {
+        SegmentGrid grid(segments, ref.step * 5);
+        m.hausdorff = std::max(directedHausdorff(segments, ref.grid, ref.step),
+                               directedHausdorff(ref.segments, grid, ref.step));
+    }
+    return m;
+}
+
+bool dominates(const Measurement& a, const Measurement& b) {
+    bool noWorse = a.timeMs <= b.timeMs && a.symDiffError <= b.symDiffError &&
+                   a.hausdorff <= b.hausdorff;
+    bool better = a.timeMs < b.timeMs || a.symDiffError < b.symDiffError ||
+                  a.hausdorff < b.hausdorff;
+    return noWorse && better;
+}
+
+void markParetoFront(std::vector<Result>& results) {
+    for (auto& r : results) {
+        r.pareto = std::none_of(results.begin(), results.end(), [&](const Result& o) {
+            return dominates(o.total, r.total);
+        });
+    }
+}
+
+// ============================================================================
+// 输出
+// ============================================================================
+
+void writeNumber(rc::BufferedWriter& out, double v) {
+    if (std::isfinite(v)) {
+        out.writeDouble(v, 6);
+    } else {
+        out.writeLiteral("null");
+    }
+}
+
+void writeCSV(const std::string& path, const std::vector<Result>& results,
+              const std::vector<rc::Scenario>& scenarios) {
+    rc::BufferedWriter out(path);
+    out.writeLiteral("rays,los_samples,range_tolerance,simplify_epsilon,time_ms,"
+                     "area_error,symdiff_error,hausdorff,pareto");
+    for (const auto& sc : scenarios) {
+        out.write("," + sc.name + "_time_ms," + sc.name + "_symdiff_error," +
+                  sc.name + "_hausdorff");
+    }
+    out.put('\n');
+
+    for (const auto& r : results) {
+        out.writeInt(r.config.rays);
+        out.put(',');
+        out.writeInt(r.config.samples);
+        out.put(',');
+        out.writeDouble(r.config.tolerance);
+        out.put(',');
+        out.writeDouble(r.config.epsilon);
+        for (double v : {r.total.timeMs, r.total.areaError, r.total.symDiffError,
+                         r.total.hausdorff}) {
+            out.put(',');
+            out.writeDouble(v, 6);
+        }
+        out.put(',');
+        out.put(r.pareto ? '1' : '0');
+        for (const auto& m : r.perScenario) {
+            for (double v : {m.timeMs, m.symDiffError, m.hausdorff}) {
+                out.put(',');
+                out.writeDouble(v, 6);
+            }
+        }
+        out.put('\n');
+    }
+    out.close();
+}
+
+void writeFrontJSON(const std::string& path, std::vector<Result> results,
+                    const std::vector<rc::Scenario>& scenarios, const SweepOptions& opt) {
+    results.erase(std::remove_if(results.begin(), results.end(),
+                                 [](const Result& r) { return !r.pareto; }),
+                  results.end());
+    std::sort(results.begin(), results.end(), [](const Result& a, const Result& b) {
+        return a.total.timeMs < b.total.timeMs;
+    });
+
+    rc::BufferedWriter out(path);
+    out.writeLiteral("{\n  \"reference\": {\"rays\": ");
+    out.writeInt(opt.refRays);
+    out.writeLiteral(", \"losSamples\": ");
+    out.writeInt(opt.refSamples);
+    out.writeLiteral(", \"rangeTolerance\": ");
+    out.writeDouble(opt.refTolerance);
+    out.writeLiteral("},\n  \"scenarios\": [");
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        if (i > 0) out.writeLiteral(", ");
+        rc::writeJsonString(out, scenarios[i].name);
+    }
+    out.writeLiteral("],\n  \"front\": [");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        if (i > 0) out.put(',');
+        out.writeLiteral("\n    {\"numRays\": ");
+        out.writeInt(r.config.rays);
+        out.writeLiteral(", \"losSamples\": ");
+        out.writeInt(r.config.samples);
+        out.writeLiteral(", \"rangeTolerance\": ");
+        out.writeDouble(r.config.tolerance);
+        out.writeLiteral(", \"simplifyEpsilon\": ");
+        out.writeDouble(r.config.epsilon);
+        out.writeLiteral(", \"timeMs\": ");
+        writeNumber(out, r.total.timeMs);
+        out.writeLiteral(", \"areaError\": ");
+        writeNumber(out, r.total.areaError);
+        out.writeLiteral(", \"symDiffError\": ");
+        writeNumber(out, r.total.symDiffError);
+        out.writeLiteral(", \"hausdorff\": ");
+        writeNumber(out, r.total.hausdorff);
+        out.put('}');
+    }
+    out.writeLiteral("\n  ]\n}\n");
+    out.close();
+}
+
+} // namespace
+
+// ============================================================================
+// 主程序
+// ============================================================================
+
+int main(int argc, char** argv) {
+    try {
+        SweepOptions opt = parseOptions(argc, argv);
+
+        std::vector<rc::Scenario> scenarios;
+        if (opt.builtin) {
+            scenarios.push_back(demoScenario());
+            scenarios.push_back(ridgeScenario());
+        }
+        for (const auto& f : opt.files) {
+            rc::Scenario sc = rc::loadScenario(f);
+            if (sc.name.empty()) sc.name = "scenario" + std::to_string(scenarios.size());
+            scenarios.push_back(std::move(sc));
+        }
+        if (scenarios.empty()) throw std::runtime_error("no scenarios");
+
+        std::cout << "[1] 计算参考结果 (rays=" << opt.refRays << ", samples=" << opt.refSamples
+                  << ", tolerance=" << opt.refTolerance << ")...\n";
+        std::vector<Reference> refs;
+        for (const auto& sc : scenarios) {
+            refs.push_back(buildReference(sc, opt));
+            std::cout << "    - " << sc.name << ": " << sc.radars.size() << " 部雷达, 面积 "
+                      << std::fixed << std::setprecision(0) << refs.back().area << "\n";
+        }
+
+        std::vector<Config> configs;
+        for (int rays : opt.rays)
+            for (int samples : opt.samples)
+                for (double tol : opt.tolerances)
+                    for (double eps : opt.epsilons)
+                        configs.push_back({rays, samples, tol, eps});
+
+        std::cout << "[2] 扫描 " << configs.size() << " 个组合 x " << scenarios.size()
+                  << " 个场景 (每项 " << opt.reps << " 次取中位数)...\n";
+        std::vector<Result> results;
+        results.reserve(configs.size());
+        for (size_t i = 0; i < configs.size(); i++) {
+            Result r;
+            r.config = configs[i];
+            for (size_t s = 0; s < scenarios.size(); s++) {
+                Measurement m = measure(scenarios[s], refs[s], configs[i], opt.reps);
+                r.total.timeMs += m.timeMs;
+                r.total.areaError += m.areaError / scenarios.size();
+                r.total.symDiffError += m.symDiffError / scenarios.size();
+                r.total.hausdorff = std::max(r.total.hausdorff, m.hausdorff);
+                r.perScenario.push_back(m);
+            }
+            results.push_back(std::move(r));
+            if ((i + 1) % 32 == 0 || i + 1 == configs.size()) {
+                std::cout << "    - " << (i + 1) << " / " << configs.size() << "\n";
+            }
+        }
+
+        markParetoFront(results);
+        writeCSV(opt.out + ".csv", results, scenarios);
+        writeFrontJSON(opt.out + ".json", results, scenarios, opt);
+
+        std::cout << "\n[Pareto 前沿]\n";
+        std::cout << "    rays  samples  tolerance  epsilon    time(ms)  symdiff   hausdorff\n";
+        std::vector<const Result*> front;
+        for (const auto& r : results) {
+            if (r.pareto) front.push_back(&r);
+        }
+        std::sort(front.begin(), front.end(), [](const Result* a, const Result* b) {
+            return a->total.timeMs < b->total.timeMs;
+        });
+        for (const Result* r : front) {
+            std::cout << "    " << std::setw(4) << r->config.rays
+                      << std::setw(9) << r->config.samples
+                      << std::setw(11) << std::setprecision(4) << r->config.tolerance
+                      << std::setw(9) << std::setprecision(1) << r->config.epsilon
+                      << std::setw(12) << std::setprecision(2) << r->total.timeMs
+                      << std::setw(9) << std::setprecision(4) << r->total.symDiffError
+                      << std::setw(12) << std::setprecision(2) << r->total.hausdorff << "\n";
+        }
+        std::cout << "\n已导出: " << opt.out << ".csv, " << opt.out << ".json\n";
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,605 @@
+/**
+ * radar_coverage_bench.cpp
+ *
+ * 覆盖计算流水线热点的微基准 (Google Benchmark)
+ *
+ * 参数维度:
+ *   obstacles  地形障碍数量      -> getElevation / LOS / 最大可视距离
+ *   dem        分形 DEM 边长     -> 真实遮挡与内存占用下的最大可视距离
+ *   rays       每部雷达射线数    -> 覆盖多边形生成 / 合并
+ *   radars     雷达数量          -> unionAll
+ *   vertices   多边形总顶点数    -> 分类 / 简化 / 平滑 / 统计 / 导出
+ *   synthetic  合成场景雷达数    -> 端到端 updateIfDirty（scenario_generator.hpp）
+ *   moving     移动雷达数        -> step()：数百部静止雷达中少量移动（目标 10-50 Hz）
+ *
+ * 运行:
+ *   ./radar_coverage_bench --benchmark_filter=UnionAll
+ *   ./radar_coverage_bench --benchmark_format=csv > bench.csv
+ *
+ * 所有输入由固定种子生成，不同运行之间可直接比较。
+ */
+
+#include <benchmark/benchmark.h>
+#include "polygon_boolean.hpp"
+#include "radar_coverage.hpp"
+#include "geojson_writer.hpp"
+#include "wkb_io.hpp"
+#include "mvt_encoder.hpp"
+#include "scenario_generator.hpp"
+#include "geodetic.hpp"
+#include "tiled_coverage.hpp"
+#include "tiled_dem.hpp"
+#include "dem_prefetch.hpp"
+#include "horizon_store.hpp"
+#include <filesystem>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace polygon_ops;
+using namespace radar_coverage;
+
+namespace {
+
+// ============================================================================
+// 合成输入
+// ============================================================================
+
+constexpr double kExtent = 10000.0;   // 场景边长 (米)
+constexpr double kRadarRange = 1500.0;
+
+TerrainModel makeTerrain(int numObstacles) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> pos(0.0, kExtent);
+    std::uniform_real_distribution<double> radius(100.0, 600.0);
+    std::uniform_real_distribution<double> height(100.0, 900.0);
+
+    TerrainModel terrain;
+    for (int i = 0; i < numObstacles; i++) {
+        terrain.addObstacle({pos(rng), pos(rng)}, radius(rng), radius(rng), height(rng));
+    }
+    return terrain;
+}
+
+/**
+ * 雷达均匀分布在方格网上，相邻覆盖区互相重叠
+ */
+std::vector<RadarParams> makeRadars(int numRadars) {
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numRadars))));
+    double spacing = kRadarRange * 1.5;
+    std::vector<RadarParams> radars;
+    radars.reserve(numRadars);
+    for (int i = 0; i < numRadars; i++) {
+        Point2D p((i % side) * spacing, (i / side) * spacing);
+        radars.emplace_back(i, "R", p, kRadarRange, 50.0);
+    }
+    return radars;
+}
+
+std::vector<Polygon> makeCoverages(int numRadars, int numRays, int numObstacles) {
+    TerrainModel terrain = makeTerrain(numObstacles);
+    std::vector<Polygon> coverages;
+    for (const auto& radar : makeRadars(numRadars)) {
+        coverages.push_back(generateCoveragePolygon(radar, terrain, numRays));
+    }
+    return coverages;
+}
+
+/**
+ * 带径向噪声的圆（外环），每个区域含一个孔洞；总顶点数约为 totalVertices
+ */
+MultiPolygon makeRegions(int numRegions, int totalVertices) {
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<double> noise(0.9, 1.1);
+    int perRing = std::max(8, totalVertices / (numRegions * 2));
+
+    MultiPolygon mp(numRegions);
+    for (int r = 0; r < numRegions; r++) {
+        Point2D c((r % 16) * 300.0, (r / 16) * 300.0);
+        for (int i = 0; i < perRing; i++) {
+            double a = 2 * M_PI * i / perRing;
+            double k = noise(rng);
+            mp[r].outer.push_back({c.x + 120 * k * std::cos(a), c.y + 120 * k * std::sin(a)});
+        }
+        Polygon hole;
+        for (int i = 0; i < perRing; i++) {
+            double a = 2 * M_PI * i / perRing;
+            hole.push_back({c.x + 40 * std::cos(a), c.y + 40 * std::sin(a)});
+        }
+        mp[r].holes.push_back(std::move(hole));
+    }
+    return mp;
+}
+
+size_t vertexCount(const MultiPolygon& mp) {
+    size_t n = 0;
+    for (const auto& pwh : mp) {
+        n += pwh.outer.size();
+        for (const auto& h : pwh.holes) n += h.size();
+    }
+    return n;
+}
+
+BufferedWriter::SinkFunction discardSink(size_t& bytes) {
+    return [&bytes](const char*, size_t size) { bytes += size; };
+}
+
+// ============================================================================
+// 地形与视线
+// ============================================================================
+
+void BM_GetElevation(benchmark::State& state) {
+    TerrainModel terrain = makeTerrain(static_cast<int>(state.range(0)));
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> pos(0.0, kExtent);
+    std::vector<Point2D> points(4096);
+    for (auto& p : points) p = {pos(rng), pos(rng)};
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Point2D& p = points[i++ & 4095];
+        benchmark::DoNotOptimize(terrain.getElevation(p.x, p.y));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetElevation)->ArgName("obstacles")->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_IsLineOfSightBlocked(benchmark::State& state) {
+    TerrainModel terrain = makeTerrain(static_cast<int>(state.range(0)));
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> pos(0.0, kExtent);
+    std::vector<std::pair<Point2D, Point2D>> segments(1024);
+    for (auto& s : segments) s = {{pos(rng), pos(rng)}, {pos(rng), pos(rng)}};
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& s = segments[i++ & 1023];
+        benchmark::DoNotOptimize(terrain.isLineOfSightBlocked(s.first, 50.0, s.second));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsLineOfSightBlocked)->ArgName("obstacles")->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_ComputeMaxVisibleRange(benchmark::State& state) {
+    TerrainModel terrain = makeTerrain(static_cast<int>(state.range(0)));
+    std::vector<RadarParams> radars = makeRadars(64);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const RadarParams& r = radars[i & 63];
+        double azimuth = 2 * M_PI * static_cast<double>(i % 360) / 360.0;
+        benchmark::DoNotOptimize(
+            terrain.computeMaxVisibleRange(r.position, r.height, azimuth, r.range));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ComputeMaxVisibleRange)->ArgName("obstacles")->RangeMultiplier(4)->Range(1, 256);
+
+void BM_ComputeMaxVisibleRangeFractalDEM(benchmark::State& state) {
+    FractalTerrainOptions options;
+    options.seed = 99;
+    options.cols = options.rows = static_cast<uint32_t>(state.range(0));
+    options.cellSize = kExtent / (options.cols - 1);
+    options.relief = 400.0;
+    auto dem = std::make_shared<const ElevationGrid>(generateFractalTerrain(options));
+
+    TerrainModel terrain;
+    terrain.setElevationFunction(ElevationGrid::asFunction(dem));
+
+    // 天线架设在地面以上 30 米
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> pos(0.0, kExtent);
+    std::vector<RadarParams> radars;
+    for (int i = 0; i < 64; i++) {
+        Point2D p(pos(rng), pos(rng));
+        radars.emplace_back(i, "R", p, kRadarRange, dem->sample(p.x, p.y) + 30.0);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const RadarParams& r = radars[i & 63];
+        double azimuth = 2 * M_PI * static_cast<double>(i % 360) / 360.0;
+        benchmark::DoNotOptimize(
+            terrain.computeMaxVisibleRange(r.position, r.height, azimuth, r.range));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["dem_MiB"] = dem->memoryBytes() / (1024.0 * 1024.0);
+}
+BENCHMARK(BM_ComputeMaxVisibleRangeFractalDEM)->ArgName("dem")->Arg(257)->Arg(1025)->Arg(4097);
+
+/**
+ * 经纬度 DEM 上生成一部雷达的覆盖：0 = 每个采样点经高程函数单独反投影，
+ * 1 = GeodeticCoverageGenerator（射线剖面批量反投影）
+ */
+void BM_GeodeticCoverage(benchmark::State& state) {
+    FractalTerrainOptions options;
+    options.seed = 7;
+    options.cols = options.rows = 1025;
+    options.cellSize = 1.0 / 1024;                  // 1° x 1°，约 100 m 像元
+    options.originX = 100.0;
+    options.originY = 30.0;
+    options.relief = 400.0;
+    auto dem = std::make_shared<const ElevationGrid>(generateFractalTerrain(options));
+
+    AeqdFrame work({30.5, 100.5});
+    RadarParams radar(1, "R", work.forward(GeoPoint{30.5, 100.5}), 30000, 430);
+
+    TerrainModel terrain;
+    terrain.setElevationFunction([dem, work](double x, double y) {
+        GeoPoint p = work.inverse(Point2D(x, y));
+        return dem->sample(p.lon, p.lat);
+    });
+    GeodeticCoverageGenerator generator(work, geographicGridSampler(dem));
+
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            benchmark::DoNotOptimize(generateCoveragePolygon(radar, terrain, 72));
+        } else {
+            benchmark::DoNotOptimize(generator(radar, terrain, 72, nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 72);
+}
+BENCHMARK(BM_GeodeticCoverage)->ArgName("batched")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// 分块 DEM：缓存上限为 budgetTiles 块时的重算耗时与命中率；prefetch = 1 时沿射线预取
+void BM_TiledDemCoverage(benchmark::State& state) {
+    FractalTerrainOptions options;
+    options.seed = 5;
+    options.cols = options.rows = 1025;
+    options.cellSize = 100.0;
+    options.relief = 800.0;
+    std::string path = (std::filesystem::temp_directory_path() / "rc_bench.rctdem").string();
+    TiledDem::write(generateFractalTerrain(options), path, 64);
+    auto dem = std::make_shared<TiledDem>(path, static_cast<size_t>(state.range(0)) * 65 * 65 * sizeof(float));
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> pos(5000.0, 97000.0);
+    CoverageMergeManager manager;
+    manager.setNumRays(72);
+    manager.terrain().setElevationFunction(TiledDem::asFunction(dem));
+    for (int i = 0; i < 200; i++) manager.addRadar(RadarParams(i, "R", {pos(rng), pos(rng)}, 15000, 30));
+    std::unique_ptr<DemPrefetcher> prefetcher;
+    if (state.range(1)) {
+        prefetcher.reset(new DemPrefetcher(dem, 2));
+        manager.setScheduleHook(prefetcher->hook());
+    }
+
+    for (auto _ : state) {
+        manager.invalidate();
+        benchmark::DoNotOptimize(manager.getMergedCoverage());
+    }
+    DemCacheStats stats = dem->stats();
+    state.counters["hitRate"] = stats.hitRate();
+    state.counters["MBread"] = static_cast<double>(stats.bytesRead) / state.iterations() / (1 << 20);
+    manager.setScheduleHook({});
+    prefetcher.reset();
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_TiledDemCoverage)->ArgNames({"budgetTiles", "prefetch"})
+    ->ArgsProduct({{16, 64, 256}, {0, 1}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 只改量程：horizon = 1 时由缓存的地平剖面得出，不再投射射线
+void BM_RangeChange(benchmark::State& state) {
+    CoverageMergeManager manager;
+    manager.terrain() = makeTerrain(64);
+    manager.setHorizonCache(state.range(0) != 0);
+    manager.setSimplifyEpsilon(0);
+    manager.setSmoothIterations(0);
+    std::vector<RadarParams> radars = makeRadars(16);
+    manager.addRadars(radars);
+    manager.getMergedCoverage();
+
+    size_t tick = 0;
+    for (auto _ : state) {
+        double scale = (++tick & 1) ? 0.8 : 1.0;
+        for (const auto& r : radars) {
+            RadarParams changed = r;
+            changed.range = r.range * scale;
+            manager.updateRadar(r.id, changed);
+        }
+        benchmark::DoNotOptimize(manager.getIndividualCoverages().size());
+    }
+    state.SetItemsProcessed(state.iterations() * radars.size());
+}
+BENCHMARK(BM_RangeChange)->ArgName("horizon")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// 进程启动后的首次计算：store = 1 时打开已有的剖面存储（映射 + 建索引），不再采样地形
+void BM_HorizonStartup(benchmark::State& state) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "radar_coverage_bench.rchz").string();
+    std::filesystem::remove(path);
+    const TerrainModel terrain = makeTerrain(64);
+    const std::vector<RadarParams> radars = makeRadars(16);
+    const uint64_t demChecksum = 1;     // 解析地形，没有 DEM 文件
+    auto startup = [&](HorizonStore* store) {
+        CoverageMergeManager manager;
+        manager.terrain() = terrain;
+        manager.setHorizonCache(true);
+        manager.setSimplifyEpsilon(0);
+        manager.setSmoothIterations(0);
+        if (store) manager.setHorizonStore(store->hooks());
+        manager.addRadars(radars);
+        return manager.getIndividualCoverages().size();
+    };
+    {
+        HorizonStore store(path, demChecksum);
+        startup(&store);
+    }
+
+    for (auto _ : state) {
+        if (state.range(0)) {
+            HorizonStore store(path, demChecksum);
+            benchmark::DoNotOptimize(startup(&store));
+        } else {
+            benchmark::DoNotOptimize(startup(nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * radars.size());
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_HorizonStartup)->ArgName("store")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// 覆盖多边形生成与合并
+// ============================================================================
+
+void BM_GenerateCoveragePolygon(benchmark::State& state) {
+    int numRays = static_cast<int>(state.range(0));
+    TerrainModel terrain = makeTerrain(static_cast<int>(state.range(1)));
+    std::vector<RadarParams> radars = makeRadars(64);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(generateCoveragePolygon(radars[i++ & 63], terrain, numRays));
+    }
+    state.SetItemsProcessed(state.iterations() * numRays);
+}
+BENCHMARK(BM_GenerateCoveragePolygon)
+    ->ArgNames({"rays", "obstacles"})
+    ->ArgsProduct({{36, 72, 180, 360}, {4, 32, 256}});
+
+void BM_UnionAll(benchmark::State& state) {
+    std::vector<Polygon> coverages = makeCoverages(static_cast<int>(state.range(0)),
+                                                   static_cast<int>(state.range(1)), 32);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolygonBoolean::unionAll(coverages));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_UnionAll)
+    ->ArgNames({"radars", "rays"})
+    ->ArgsProduct({{4, 16, 64, 256}, {72, 360}})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ClassifyResult(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(static_cast<int>(state.range(0)),
+                                  static_cast<int>(state.range(1)));
+    // 外环正向、孔洞反向，与 Clipper2 输出一致
+    ClipperPaths paths;
+    for (const auto& pwh : mp) {
+        paths.push_back(CoordinateConverter::toClipperPath(pwh.outer));
+        Polygon hole = pwh.holes[0];
+        std::reverse(hole.begin(), hole.end());
+        paths.push_back(CoordinateConverter::toClipperPath(hole));
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolygonBoolean::classifyResult(paths));
+    }
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_ClassifyResult)
+    ->ArgNames({"regions", "vertices"})
+    ->ArgsProduct({{1, 16, 256}, {1 << 12, 1 << 16}})
+    ->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// 后处理与统计
+// ============================================================================
+
+void BM_SimplifyAll(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolygonProcessor::simplifyAll(mp, 2.0));
+    }
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_SimplifyAll)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SmoothAll(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolygonProcessor::smoothAll(mp, 1));
+    }
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_SmoothAll)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PolygonStatsCompute(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolygonStats::compute(mp));
+    }
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_PolygonStatsCompute)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 22)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PolygonStatsComputeParallel(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PolygonStats::computeParallel(mp));
+    }
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_PolygonStatsComputeParallel)->ArgName("vertices")->RangeMultiplier(8)
+    ->Range(1 << 16, 1 << 22)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// ============================================================================
+// 导出
+// ============================================================================
+
+void BM_ExportGeoJSON(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        BufferedWriter out(discardSink(bytes));
+        writeGeoJSON(out, mp, GeoJSONOptions{3});
+        out.flush();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_ExportGeoJSON)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ExportWKB(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        BufferedWriter out(discardSink(bytes));
+        writeWKB(out, mp);
+        out.flush();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_ExportWKB)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ExportSVG(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    PolygonUtils::BoundingBox bounds = {-200, -200, 16 * 300.0, 300.0};
+    SvgViewport viewport = SvgViewport::fitTo(bounds, 1600, 400);
+    TerrainModel terrain;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        BufferedWriter out(discardSink(bytes));
+        benchmark::DoNotOptimize(exportToSVG(out, {}, {}, mp, terrain, viewport));
+        out.flush();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_ExportSVG)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_EncodeMVTTile(benchmark::State& state) {
+    MultiPolygon mp = makeRegions(16, static_cast<int>(state.range(0)));
+    PolygonUtils::BoundingBox bounds = {-200, -200, 16 * 300.0, 300.0};
+    TileGrid grid = TileGrid::fromBounds(bounds);
+    MVTEncoder encoder;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string tile = encoder.encodeTile(mp, grid, TileId{0, 0, 0});
+        bytes += tile.size();
+        benchmark::DoNotOptimize(tile);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * vertexCount(mp));
+}
+BENCHMARK(BM_EncodeMVTTile)->ArgName("vertices")->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// 端到端：合成场景
+// ============================================================================
+
+void BM_ManagerUpdateSynthetic(benchmark::State& state) {
+    SyntheticScenarioOptions options;
+    options.seed = 2024;
+    options.numRadars = static_cast<size_t>(state.range(0));
+    options.numObstacles = 256;
+    options.settings.numRays = 36;
+    Scenario sc = generateSyntheticScenario(options);
+
+    CoverageMergeManager manager;
+    applyScenario(sc, manager);
+    for (auto _ : state) {
+        manager.invalidate();
+        benchmark::DoNotOptimize(manager.getMergedCoverage());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ManagerUpdateSynthetic)->ArgName("radars")->RangeMultiplier(10)->Range(10, 1000)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_StepMovingRadars(benchmark::State& state) {
+    SyntheticScenarioOptions options;
+    options.seed = 2024;
+    options.numRadars = 400;
+    options.numObstacles = 128;
+    options.settings.numRays = 36;
+    Scenario sc = generateSyntheticScenario(options);
+
+    CoverageMergeManager manager;
+    applyScenario(sc, manager);
+    manager.getMergedCoverage();
+
+    // 前 moving 部雷达每步沿各自航向移动 50 米
+    const size_t moving = static_cast<size_t>(state.range(0));
+    std::vector<RadarPose> poses(moving);
+    for (size_t i = 0; i < moving; i++) {
+        const RadarParams& r = sc.radars[i];
+        poses[i] = {r.id, r.position, r.height};
+    }
+    size_t tick = 0;
+    for (auto _ : state) {
+        tick++;
+        for (size_t i = 0; i < moving; i++) {
+            double heading = 0.1 * static_cast<double>(i);
+            poses[i].position = sc.radars[i].position +
+                Point2D(std::cos(heading), std::sin(heading)) * (50.0 * tick);
+        }
+        benchmark::DoNotOptimize(manager.step(0.05, poses).coverage.size());
+    }
+    state.counters["Hz"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                              benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_StepMovingRadars)->ArgName("moving")->Arg(8)->Arg(32)->Arg(64)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 大范围分块：tileKm = 0 表示整体一次合并（对照）
+void BM_TiledCoverage(benchmark::State& state) {
+    SyntheticScenarioOptions options;
+    options.seed = 2024;
+    options.numRadars = 400;
+    options.numObstacles = 256;
+    options.extentX = options.extentY = 800000.0;
+    options.settings.numRays = 36;
+    Scenario sc = generateSyntheticScenario(options);
+
+    CoverageMergeManager manager;
+    applyScenario(sc, manager);
+    TiledCoverageOptions tiled;
+    tiled.tileSize = state.range(0) * 1000.0;
+    tiled.numRays = 36;
+
+    size_t maxVertices = 0;
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            manager.invalidate();
+            benchmark::DoNotOptimize(manager.getMergedCoverage());
+        } else {
+            size_t tiles = 0;
+            TiledCoverageStats stats = computeTiledCoverage(sc.radars, manager.terrain(), tiled,
+                                                            [&](CoverageTile&&) { tiles++; });
+            maxVertices = stats.maxTileVertices;
+            benchmark::DoNotOptimize(tiles);
+        }
+    }
+    state.counters["maxTileVertices"] = static_cast<double>(maxVertices);
+    state.SetItemsProcessed(state.iterations() * options.numRadars);
+}
+BENCHMARK(BM_TiledCoverage)->ArgName("tileKm")->Arg(0)->Arg(100)->Arg(200)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,231 @@
+/**
+ * async_coverage.hpp
+ *
+ * 异步双缓冲覆盖计算 - 读取方永不等待重算
+ *
+ * - 后台工作线程独占一个 CoverageMergeManager（后缓冲），按顺序执行调用方提交的修改，
+ *   攒批后做一次增量重算，再把结果作为不可变快照发布（前缓冲）
+ * - 快照通过原子交换的 shared_ptr 发布：snapshot() 只是一次原子读取，
+ *   读者持有的旧快照在其释放前一直有效
+ * - 每次提交分配递增的代号；快照携带其已包含的最新代号，
+ *   调用方据此判断快照是否为最新（isCurrent）或等待某一代完成（waitFor）
+ *
+ * 用法:
+ *   AsyncCoverageManager async;
+ *   uint64_t gen = async.addRadar(radar);
+ *   auto snap = async.snapshot();        // 立即返回，可能是旧结果
+ *   auto fresh = async.waitFor(gen);     // 阻塞到包含 gen 的结果发布
+ *
+ * 依赖: radar_coverage.hpp
+ */
+
+#pragma once
+
+#include "radar_coverage.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 快照
+// ============================================================================
+
+struct CoverageSnapshot {
+    uint64_t generation = 0;        // 已包含的最后一次提交
+    MultiPolygon coverage;
+    UpdateTimings timings;          // 产生本快照的那次重算；本批未触发重算时为全零
+    CoverageDelta delta;            // 管理器开启增量跟踪且本批触发重算时为相对上一次重算的增量
+    PerfStats perf;                 // 管理器累计计数
+    uint64_t step = 0;
+    double time = 0.0;
+    size_t radarCount = 0;
+    std::string error;              // 本批失败修改的错误信息（每条一行）；重算本身失败时
+                                    // coverage 沿用上一个快照
+};
+
+// ============================================================================
+// 异步管理器
+// ============================================================================
+
+class AsyncCoverageManager {
+public:
+    using Edit = std::function<void(CoverageMergeManager&)>;
+
+    explicit AsyncCoverageManager(CoverageMergeManager manager = CoverageMergeManager())
+        : manager_(std::move(manager)),
+          snapshot_(std::make_shared<const CoverageSnapshot>()) {
+        worker_ = std::thread([this]() { run(); });
+    }
+
+    ~AsyncCoverageManager() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        worker_.join();
+
+        // 唤醒仍在 waitFor 中的线程，等它们离开后才销毁成员
+        std::unique_lock<std::mutex> lock(mutex_);
+        published_.notify_all();
+        published_.wait(lock, [&]() { return waiters_ == 0; });
+    }
+
+    AsyncCoverageManager(const AsyncCoverageManager&) = delete;
+    AsyncCoverageManager& operator=(const AsyncCoverageManager&) = delete;
+
+    /**
+     * 提交一次修改（在工作线程上按提交顺序执行），返回其代号
+     */
+    uint64_t submit(Edit edit) {
+        uint64_t gen;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            gen = ++submitted_;
+            pending_.push_back(std::move(edit));
+        }
+        wake_.notify_all();
+        return gen;
+    }
+
+    uint64_t addRadar(const RadarParams& radar) {
+        return submit([radar](CoverageMergeManager& m) { m.addRadar(radar); });
+    }
+
+    uint64_t updateRadar(int id, const RadarParams& params) {
+        return submit([id, params](CoverageMergeManager& m) { m.updateRadar(id, params); });
+    }
+
+    uint64_t removeRadar(int id) {
+        return submit([id](CoverageMergeManager& m) { m.removeRadar(id); });
+    }
+
+    /**
+     * 异步步进；连续多个步进在工作线程上合并为一次重算
+     */
+    uint64_t step(double dt, std::vector<RadarPose> poses) {
+        return submit([dt, poses = std::move(poses)](CoverageMergeManager& m) {
+            m.applyPoses(dt, poses);
+        });
+    }
+
+    /**
+     * 最新发布的快照（无锁，永不阻塞）
+     */
+    std::shared_ptr<const CoverageSnapshot> snapshot() const {
+        return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+    }
+
+    /** 最后一次提交的代号 */
+    uint64_t generation() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return submitted_;
+    }
+
+    bool isCurrent(const CoverageSnapshot& snap) const { return snap.generation == generation(); }
+
+    /**
+     * 阻塞直到包含 generation 的快照发布；对象析构时立即返回当前快照
+     */
+    std::shared_ptr<const CoverageSnapshot> waitFor(uint64_t generation) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_++;
+        published_.wait(lock, [&]() { return publishedGeneration_ >= generation || stop_; });
+        std::shared_ptr<const CoverageSnapshot> snap = snapshot();
+        if (--waiters_ == 0 && stop_) published_.notify_all();
+        return snap;
+    }
+
+    std::shared_ptr<const CoverageSnapshot> waitForCurrent() const { return waitFor(generation()); }
+
+private:
+    void run() {
+        std::deque<Edit> batch;
+        for (;;) {
+            uint64_t gen;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&]() { return stop_ || !pending_.empty(); });
+                if (stop_) return;
+                batch.swap(pending_);
+                gen = submitted_;
+            }
+            recompute(batch, gen);
+            batch.clear();
+        }
+    }
+
+    /**
+     * 逐个执行修改：失败的修改只记录错误，批内其余修改照常执行
+     */
+    void recompute(std::deque<Edit>& batch, uint64_t gen) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("asyncRecompute", "manager", "edits", batch.size());
+        auto next = std::make_shared<CoverageSnapshot>();
+        next->generation = gen;
+        auto addError = [&next](const std::string& what) {
+            if (!next->error.empty()) next->error += '\n';
+            next->error += what;
+        };
+        for (auto& edit : batch) {
+            try {
+                edit(manager_);
+            } catch (const std::exception& e) {
+                addError(e.what());
+            } catch (...) {
+                addError("unknown exception");
+            }
+        }
+        try {
+            next->coverage = manager_.getMergedCoverage();
+            uint64_t version = manager_.getCoverageVersion();
+            if (version != coverageVersion_) {
+                coverageVersion_ = version;
+                next->timings = manager_.getLastUpdateTimings();
+                if (manager_.getDeltaTracking()) next->delta = manager_.getCoverageDelta();
+            }
+        } catch (const std::exception& e) {
+            addError(e.what());
+            next->coverage = snapshot()->coverage;
+        } catch (...) {
+            addError("unknown exception");
+            next->coverage = snapshot()->coverage;
+        }
+        next->perf = manager_.getPerfStats();
+        next->step = manager_.getStepCount();
+        next->time = manager_.getSimTime();
+        next->radarCount = manager_.getRadars().size();
+
+        std::atomic_store_explicit(&snapshot_, std::shared_ptr<const CoverageSnapshot>(std::move(next)),
+                                   std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            publishedGeneration_ = gen;
+        }
+        published_.notify_all();
+    }
+
+    CoverageMergeManager manager_;                      // 仅工作线程访问
+    uint64_t coverageVersion_ = 0;                      // 上一次发布时管理器的覆盖版本
+    std::shared_ptr<const CoverageSnapshot> snapshot_;  // 原子读写
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    mutable std::condition_variable published_;
+    std::deque<Edit> pending_;
+    uint64_t submitted_ = 0;
+    uint64_t publishedGeneration_ = 0;
+    mutable size_t waiters_ = 0;                        // 正在 waitFor 中的线程数
+    bool stop_ = false;
+
+    std::thread worker_;
+};
+
+} // namespace radar_coverage
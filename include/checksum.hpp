@@ -0,0 +1,117 @@
+/**
+ * checksum.hpp
+ *
+ * 64 位内容校验和（非加密）：缓存键与数据文件指纹
+ *
+ * 逐 8 字节混合，结果与分段方式无关（同一字节序列分几次 update 结果相同）；
+ * 数值按主机字节序参与计算，只用于同一平台上的比较。
+ *
+ * 依赖: 无
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace radar_coverage {
+
+class Hasher64 {
+public:
+    explicit Hasher64(uint64_t seed = 0) : state_(0x9E3779B97F4A7C15ull ^ seed) {}
+
+    Hasher64& update(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        length_ += size;
+        if (pending_ > 0) {
+            size_t take = std::min(size, 8 - pending_);
+            std::memcpy(buffer_ + pending_, p, take);
+            pending_ += take;
+            p += take;
+            size -= take;
+            if (pending_ < 8) return *this;
+            mixWord(buffer_);
+            pending_ = 0;
+        }
+        for (; size >= 8; p += 8, size -= 8) mixWord(p);
+        std::memcpy(buffer_, p, size);
+        pending_ = size;
+        return *this;
+    }
+
+    template <typename T>
+    Hasher64& add(const T& value) {
+        static_assert(std::is_arithmetic<T>::value, "Hasher64::add expects arithmetic type");
+        return update(&value, sizeof(T));
+    }
+
+    Hasher64& add(const std::string& s) {
+        add<uint64_t>(s.size());
+        return update(s.data(), s.size());
+    }
+
+    uint64_t digest() const {
+        uint64_t h = state_;
+        if (pending_ > 0) {
+            uint8_t tail[8] = {0};
+            std::memcpy(tail, buffer_, pending_);
+            uint64_t w;
+            std::memcpy(&w, tail, 8);
+            h = round(h, w);
+        }
+        // murmur3 fmix64
+        h ^= length_;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+private:
+    static uint64_t round(uint64_t h, uint64_t w) {
+        w *= 0x87C37B91114253D5ull;
+        w = (w << 31) | (w >> 33);
+        h ^= w * 0x4CF5AD432745937Full;
+        h = (h << 27) | (h >> 37);
+        return h * 5 + 0x52DCE729;
+    }
+
+    void mixWord(const uint8_t* p) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        state_ = round(state_, w);
+    }
+
+    uint64_t state_;
+    uint64_t length_ = 0;
+    uint8_t buffer_[8] = {0};
+    size_t pending_ = 0;
+};
+
+/**
+ * 整个文件内容的校验和（按 1 MB 分块读取，不整体载入内存）
+ *
+ * @throws std::runtime_error 文件无法读取
+ */
+inline uint64_t fileChecksum(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) throw std::runtime_error("fileChecksum: cannot open " + path);
+    Hasher64 hasher;
+    std::vector<char> buf(1 << 20);
+    size_t n;
+    while ((n = std::fread(buf.data(), 1, buf.size(), f)) > 0) hasher.update(buf.data(), n);
+    bool failed = std::ferror(f) != 0;
+    std::fclose(f);
+    if (failed) throw std::runtime_error("fileChecksum: read error on " + path);
+    return hasher.digest();
+}
+
+} // namespace radar_coverage
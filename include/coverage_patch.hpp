@@ -0,0 +1,325 @@
+/**
+ * coverage_patch.hpp
+ *
+ * 覆盖增量补丁 - CoverageDelta 的紧凑二进制编码，以及客户端侧的应用
+ *
+ * 下游客户端持有某一版本的合并结果后，只需接收相邻版本间的补丁：
+ *   base' = (base - lost) ∪ gained
+ *
+ * 格式（小端）:
+ *   "RCPATCH1"                            8 字节魔数
+ *   u64 fromVersion, u64 toVersion
+ *   f64 region minX, minY, maxX, maxY
+ *   f64 resolution                        坐标量化步长 (米)；0 = 无损 f64 坐标
+ *   gained, lost                          各为一个 MultiPolygon:
+ *     varint 区域数 { varint 环数（外边界 + 孔洞） { varint 点数, 点... } }
+ *
+ * 量化时坐标相对 region 左下角取整为 resolution 的整数倍，逐点写 zigzag varint 差分，
+ * 游标跨环延续（与 MVT 几何编码相同）；量化后重复的相邻点与退化环被丢弃。
+ * 量化补丁在 region 内引入不超过 resolution / 2 的误差，客户端应定期用完整结果重新同步。
+ *
+ * 依赖: radar_coverage.hpp, wkb_io.hpp
+ */
+
+#pragma once
+
+#include "radar_coverage.hpp"
+#include "wkb_io.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace radar_coverage {
+
+namespace patch {
+
+constexpr char kMagic[8] = {'R', 'C', 'P', 'A', 'T', 'C', 'H', '1'};
+
+inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// ============================================================================
+// 编码器
+// ============================================================================
+
+class Encoder {
+public:
+    Encoder(std::vector<uint8_t>& bytes, const PolygonUtils::BoundingBox& region, double resolution)
+        : bytes_(bytes), out_(bytes), originX_(region.minX), originY_(region.minY),
+          resolution_(resolution) {}
+
+    template <typename T>
+    void writeLE(T v) { out_.writeLE<T>(v); }
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            bytes_.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        bytes_.push_back(static_cast<uint8_t>(v));
+    }
+
+    void writeMultiPolygon(const MultiPolygon& mp) {
+        // 量化后可能整体退化，先编码到临时环再决定是否写出
+        std::vector<std::vector<Ring>> regions;
+        regions.reserve(mp.size());
+        for (const auto& pwh : mp) {
+            std::vector<Ring> rings;
+            Ring outer = quantize(pwh.outer);
+            if (outer.size() < 3) continue;
+            rings.push_back(std::move(outer));
+            for (const auto& hole : pwh.holes) {
+                Ring r = quantize(hole);
+                if (r.size() >= 3) rings.push_back(std::move(r));
+            }
+            regions.push_back(std::move(rings));
+        }
+
+        varint(regions.size());
+        for (const auto& rings : regions) {
+            varint(rings.size());
+            for (const auto& ring : rings) writeRing(ring);
+        }
+    }
+
+private:
+    struct Coord {
+        int64_t qx, qy;     // 量化模式
+        double x, y;        // 无损模式
+    };
+    using Ring = std::vector<Coord>;
+
+    Ring quantize(const Polygon& poly) const {
+        Ring ring;
+        ring.reserve(poly.size());
+        for (const auto& p : poly) {
+            Coord c{0, 0, p.x, p.y};
+            if (resolution_ > 0) {
+                c.qx = std::llround((p.x - originX_) / resolution_);
+                c.qy = std::llround((p.y - originY_) / resolution_);
+                if (!ring.empty() && ring.back().qx == c.qx && ring.back().qy == c.qy) continue;
+            }
+            ring.push_back(c);
+        }
+        if (resolution_ > 0 && ring.size() > 1 &&
+            ring.front().qx == ring.back().qx && ring.front().qy == ring.back().qy) {
+            ring.pop_back();
+        }
+        return ring;
+    }
+
+    void writeRing(const Ring& ring) {
+        varint(ring.size());
+        for (const auto& c : ring) {
+            if (resolution_ > 0) {
+                varint(zigzag(c.qx - cursorX_));
+                varint(zigzag(c.qy - cursorY_));
+                cursorX_ = c.qx;
+                cursorY_ = c.qy;
+            } else {
+                out_.writeLE<double>(c.x);
+                out_.writeLE<double>(c.y);
+            }
+        }
+    }
+
+    std::vector<uint8_t>& bytes_;
+    wkb::ByteVectorAdapter out_;
+    double originX_, originY_;
+    double resolution_;
+    int64_t cursorX_ = 0, cursorY_ = 0;
+};
+
+// ============================================================================
+// 解码器
+// ============================================================================
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    CoverageDelta readPatch() {
+        require(sizeof(kMagic));
+        if (std::memcmp(data_, kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("coverage patch: bad magic");
+        }
+        pos_ = sizeof(kMagic);
+
+        CoverageDelta delta;
+        delta.fromVersion = read<uint64_t>();
+        delta.toVersion = read<uint64_t>();
+        delta.region.minX = read<double>();
+        delta.region.minY = read<double>();
+        delta.region.maxX = read<double>();
+        delta.region.maxY = read<double>();
+        resolution_ = read<double>();
+        if (!(resolution_ >= 0) || !std::isfinite(resolution_)) {
+            throw std::runtime_error("coverage patch: invalid resolution");
+        }
+        originX_ = delta.region.minX;
+        originY_ = delta.region.minY;
+
+        delta.gained = readMultiPolygon();
+        delta.lost = readMultiPolygon();
+        return delta;
+    }
+
+    size_t consumed() const { return pos_; }
+
+private:
+    MultiPolygon readMultiPolygon() {
+        uint64_t count = varint();
+        require(count);                     // 每个区域至少 1 字节
+        MultiPolygon mp;
+        mp.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t rings = varint();
+            require(rings);
+            PolygonWithHoles pwh;
+            for (uint64_t r = 0; r < rings; r++) {
+                Polygon ring = readRing();
+                if (r == 0) {
+                    pwh.outer = std::move(ring);
+                } else {
+                    pwh.holes.push_back(std::move(ring));
+                }
+            }
+            if (!pwh.outer.empty()) mp.push_back(std::move(pwh));
+        }
+        return mp;
+    }
+
+    Polygon readRing() {
+        uint64_t n = varint();
+        // 先按剩余字节限制点数再预留：量化坐标每点至少 2 字节，无损坐标 16 字节
+        const uint64_t pointBytes = resolution_ > 0 ? 2 : 16;
+        if (n > (size_ - pos_) / pointBytes) throw std::runtime_error("coverage patch: truncated input");
+        Polygon ring;
+        ring.reserve(n);
+        for (uint64_t i = 0; i < n; i++) {
+            if (resolution_ > 0) {
+                cursorX_ += unzigzag(varint());
+                cursorY_ += unzigzag(varint());
+                ring.emplace_back(originX_ + cursorX_ * resolution_, originY_ + cursorY_ * resolution_);
+            } else {
+                double x = read<double>();
+                double y = read<double>();
+                ring.emplace_back(x, y);
+            }
+        }
+        return ring;
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            require(1);
+            uint8_t b = data_[pos_++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw std::runtime_error("coverage patch: varint too long");
+    }
+
+    void require(uint64_t n) const {
+        if (n > size_ - pos_) throw std::runtime_error("coverage patch: truncated input");
+    }
+
+    template <typename T>
+    T read() {
+        require(sizeof(T));
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        if (!BufferedWriter::isLittleEndian()) {
+            for (size_t i = 0; i < sizeof(T) / 2; i++) {
+                std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+        }
+        T v;
+        std::memcpy(&v, bytes, sizeof(T));
+        return v;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    double resolution_ = 0.0;
+    double originX_ = 0.0, originY_ = 0.0;
+    int64_t cursorX_ = 0, cursorY_ = 0;
+};
+
+} // namespace patch
+
+// ============================================================================
+// 补丁编码 / 解码 / 应用
+// ============================================================================
+
+/**
+ * 编码增量补丁
+ *
+ * @param resolution 坐标量化步长 (米)；0 写出无损 f64 坐标
+ */
+inline std::vector<uint8_t> toCoveragePatch(const CoverageDelta& delta, double resolution = 0.01) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("toCoveragePatch", "export", "regions",
+                                   delta.gained.size() + delta.lost.size());
+    if (!(resolution >= 0) || !std::isfinite(resolution)) {
+        throw std::invalid_argument("toCoveragePatch: resolution must be finite and >= 0");
+    }
+    std::vector<uint8_t> bytes(patch::kMagic, patch::kMagic + sizeof(patch::kMagic));
+    patch::Encoder encoder(bytes, delta.region, resolution);
+    encoder.writeLE<uint64_t>(delta.fromVersion);
+    encoder.writeLE<uint64_t>(delta.toVersion);
+    encoder.writeLE<double>(delta.region.minX);
+    encoder.writeLE<double>(delta.region.minY);
+    encoder.writeLE<double>(delta.region.maxX);
+    encoder.writeLE<double>(delta.region.maxY);
+    encoder.writeLE<double>(resolution);
+    encoder.writeMultiPolygon(delta.gained);
+    encoder.writeMultiPolygon(delta.lost);
+    return bytes;
+}
+
+/**
+ * 解码增量补丁
+ *
+ * @throws std::runtime_error 魔数错误或输入截断
+ */
+inline CoverageDelta readCoveragePatch(const uint8_t* data, size_t size) {
+    patch::Decoder decoder(data, size);
+    return decoder.readPatch();
+}
+
+inline CoverageDelta readCoveragePatch(const std::vector<uint8_t>& bytes) {
+    return readCoveragePatch(bytes.data(), bytes.size());
+}
+
+/**
+ * 在客户端持有的结果上应用增量：(base - lost) ∪ gained
+ *
+ * 不检查版本；调用方应先确认 base 的版本等于 delta.fromVersion。
+ */
+inline MultiPolygon applyCoveragePatch(const MultiPolygon& base, const CoverageDelta& delta) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("applyCoveragePatch", "export", "regions", base.size());
+    if (delta.empty()) return base;
+
+    polygon_ops::ClipperPaths paths = PolygonBoolean::toPaths(base);
+    if (!delta.lost.empty()) {
+        paths = PolygonBoolean::combine(Clipper2Lib::ClipType::Difference,
+                                        paths, PolygonBoolean::toPaths(delta.lost));
+    }
+    if (!delta.gained.empty()) {
+        paths = PolygonBoolean::combine(Clipper2Lib::ClipType::Union,
+                                        paths, PolygonBoolean::toPaths(delta.gained));
+    }
+    return PolygonBoolean::classifyResult(paths);
+}
+
+} // namespace radar_coverage
@@ -0,0 +1,278 @@
+/**
+ * dem_prefetch.hpp
+ *
+ * 分块 DEM 预取 - 沿射线方向提前读入 generateCoveragePolygon 将要访问的瓦片
+ *
+ * 每条射线的路径在开始计算前就已确定（站址、方位、量程），其经过的瓦片可以预先算出。
+ * DemPrefetcher 在独立的 I/O 线程池上按调度顺序读取这些瓦片，计算线程与读盘重叠：
+ * - 单部雷达的瓦片按离站址由近到远排列（射线行进与视线检查都从站址向外）
+ * - 多部雷达按管理器的调度顺序（Hilbert 序）依次排队，重复瓦片只排一次
+ * - 预取最多领先计算 lookaheadTiles 块（按计算线程实际用到的预取序号推进），
+ *   避免提前读入的瓦片在用到之前被 LRU 淘汰
+ *
+ * 预取只是提示：读取失败或被取消时，计算线程照常按需读盘。
+ *
+ * 用法:
+ *   auto dem = std::make_shared<TiledDem>("country.rctdem", size_t(8) << 30);
+ *   DemPrefetcher prefetcher(dem, 4);
+ *   manager.terrain().setElevationFunction(TiledDem::asFunction(dem));
+ *   manager.setScheduleHook(prefetcher.hook());     // prefetcher 须比 manager 的使用期长
+ *
+ * 依赖: tiled_dem.hpp, radar_coverage.hpp
+ */
+
+#pragma once
+
+#include "tiled_dem.hpp"
+#include "radar_coverage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 射线经过的瓦片
+// ============================================================================
+
+struct DemTileRef {
+    uint32_t tx = 0, ty = 0;
+};
+
+/**
+ * 雷达各射线（与 generateCoveragePolygon 的方位相同）从站址到量程经过的瓦片，由近到远、去重
+ */
+inline std::vector<DemTileRef> rayTiles(const TiledDem& dem, const RadarParams& radar, int numRays) {
+    const double tileSize = dem.tileCells() * dem.cellSize();
+    const double x0 = (radar.position.x - dem.originX()) / tileSize;
+    const double y0 = (radar.position.y - dem.originY()) / tileSize;
+    const double reach = radar.range / tileSize;
+
+    // 量程包围盒内的瓦片 -> 首次进入时离站址的距离（瓦片单位）
+    const int64_t minTx = std::max<int64_t>(0, static_cast<int64_t>(std::floor(x0 - reach)));
+    const int64_t minTy = std::max<int64_t>(0, static_cast<int64_t>(std::floor(y0 - reach)));
+    const int64_t maxTx = std::min<int64_t>(dem.tilesX() - 1, static_cast<int64_t>(std::floor(x0 + reach)));
+    const int64_t maxTy = std::min<int64_t>(dem.tilesY() - 1, static_cast<int64_t>(std::floor(y0 + reach)));
+    if (minTx > maxTx || minTy > maxTy || numRays <= 0) return {};
+    const int64_t width = maxTx - minTx + 1;
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> entry(static_cast<size_t>(width * (maxTy - minTy + 1)), inf);
+    auto visit = [&](int64_t tx, int64_t ty, double t) {
+        if (tx < minTx || ty < minTy || tx > maxTx || ty > maxTy) return;
+        double& e = entry[static_cast<size_t>((ty - minTy) * width + (tx - minTx))];
+        e = std::min(e, t);
+    };
+
+    const double azimuthStep = (radar.azimuthEnd - radar.azimuthStart) / numRays;
+    for (int i = 0; i < numRays; i++) {
+        double azimuth = radar.azimuthStart + i * azimuthStep;
+        double dx = std::cos(azimuth), dy = std::sin(azimuth);
+
+        // 网格遍历（Amanatides & Woo）：逐个跨越瓦片边界
+        int64_t tx = static_cast<int64_t>(std::floor(x0));
+        int64_t ty = static_cast<int64_t>(std::floor(y0));
+        const int stepX = dx > 0 ? 1 : -1, stepY = dy > 0 ? 1 : -1;
+        double deltaX = dx != 0 ? std::abs(1.0 / dx) : inf;
+        double deltaY = dy != 0 ? std::abs(1.0 / dy) : inf;
+        double nextX = dx != 0 ? ((stepX > 0 ? tx + 1 - x0 : x0 - tx) * deltaX) : inf;
+        double nextY = dy != 0 ? ((stepY > 0 ? ty + 1 - y0 : y0 - ty) * deltaY) : inf;
+
+        double t = 0.0;
+        visit(tx, ty, t);
+        while (true) {
+            if (nextX < nextY) {
+                t = nextX;
+                nextX += deltaX;
+                tx += stepX;
+            } else {
+                t = nextY;
+                nextY += deltaY;
+                ty += stepY;
+            }
+            if (t > reach) break;
+            visit(tx, ty, t);
+        }
+    }
+
+    std::vector<std::pair<double, DemTileRef>> order;
+    for (size_t i = 0; i < entry.size(); i++) {
+        if (entry[i] == inf) continue;
+        order.push_back({entry[i], {static_cast<uint32_t>(minTx + static_cast<int64_t>(i) % width),
+                                    static_cast<uint32_t>(minTy + static_cast<int64_t>(i) / width)}});
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<double, DemTileRef>& a, const std::pair<double, DemTileRef>& b) {
+                         return a.first < b.first;
+                     });
+
+    std::vector<DemTileRef> tiles;
+    tiles.reserve(order.size());
+    for (const auto& o : order) tiles.push_back(o.second);
+    return tiles;
+}
+
+// ============================================================================
+// 预取器
+// ============================================================================
+
+class DemPrefetcher {
+public:
+    /**
+     * @param ioThreads      I/O 线程数（至少 1）
+     * @param lookaheadTiles 预取领先计算的最大瓦片数；0 = 缓存容量的四分之一
+     */
+    explicit DemPrefetcher(std::shared_ptr<const TiledDem> dem, size_t ioThreads = 2,
+                           size_t lookaheadTiles = 0)
+        : dem_(std::move(dem)) {
+        if (!dem_) throw std::invalid_argument("DemPrefetcher: null DEM");
+        lookahead_ = lookaheadTiles ? lookaheadTiles
+                                    : std::max<size_t>(1, dem_->stats().budgetBytes / dem_->tileBytes() / 4);
+        listener_ = dem_->addProgressListener([this]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_.notify_all();
+        });
+        for (size_t i = 0; i < std::max<size_t>(1, ioThreads); i++) {
+            workers_.emplace_back([this]() { run(); });
+        }
+    }
+
+    DemPrefetcher(const DemPrefetcher&) = delete;
+    DemPrefetcher& operator=(const DemPrefetcher&) = delete;
+
+    ~DemPrefetcher() {
+        dem_->removeProgressListener(listener_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            queue_.clear();
+        }
+        wake_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    /**
+     * 以新的调度替换尚未读取的队列（order 为 radars 的下标，按处理顺序）
+     */
+    void schedule(const std::vector<RadarParams>& radars, const std::vector<size_t>& order, int numRays) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("schedulePrefetch", "io", "radars", order.size());
+        std::vector<Pending> tiles;
+        std::vector<bool> seen(static_cast<size_t>(dem_->tilesX()) * dem_->tilesY(), false);
+        for (size_t i : order) {
+            for (const DemTileRef& t : rayTiles(*dem_, radars.at(i), numRays)) {
+                size_t key = static_cast<size_t>(t.ty) * dem_->tilesX() + t.tx;
+                if (!seen[key]) {
+                    seen[key] = true;
+                    tiles.push_back({t, 0});
+                }
+            }
+        }
+        uint64_t base;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.clear();
+            // 序号保持单调：已读入但未用到的旧瓦片仍带着旧序号，重新编号会与之重复
+            base = nextSeq_ = std::max(nextSeq_, dem_->prefetchProgress());
+            for (auto& p : tiles) {
+                p.seq = ++nextSeq_;
+                queue_.push_back(p);
+            }
+        }
+        // 进度推进到新队列之前，旧序号不再推动窗口，新窗口立即可用（回调会取 mutex_，须在锁外）
+        dem_->skipPrefetchTo(base);
+        wake_.notify_all();
+    }
+
+    /**
+     * 适配 CoverageMergeManager::setScheduleHook
+     */
+    CoverageMergeManager::ScheduleHook hook() {
+        return [this](const std::vector<RadarParams>& radars, const std::vector<size_t>& order, int numRays) {
+            schedule(radars, order, numRays);
+        };
+    }
+
+    /**
+     * 丢弃尚未读取的瓦片
+     */
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        idle_.notify_all();
+    }
+
+    /**
+     * 等待队列中当前可读（领先窗口内）的瓦片全部读完
+     */
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [&]() { return active_ == 0 && (queue_.empty() || !windowOpenLocked()); });
+    }
+
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    size_t lookaheadTiles() const { return lookahead_; }
+
+private:
+    struct Pending {
+        DemTileRef tile;
+        uint64_t seq;
+    };
+
+    bool windowOpenLocked() const {
+        return !queue_.empty() && queue_.front().seq <= dem_->prefetchProgress() + lookahead_;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            if (queue_.empty()) {
+                idle_.notify_all();
+                wake_.wait(lock, [&]() { return stop_ || !queue_.empty(); });
+                continue;
+            }
+            // 领先窗口已满：等计算线程用到已预取的瓦片（TiledDem 推进进度时唤醒）
+            if (!windowOpenLocked()) {
+                if (active_ == 0) idle_.notify_all();
+                wake_.wait(lock, [&]() { return stop_ || queue_.empty() || windowOpenLocked(); });
+                continue;
+            }
+            Pending p = queue_.front();
+            queue_.pop_front();
+            active_++;
+            lock.unlock();
+            try {
+                dem_->prefetch(p.tile.tx, p.tile.ty, p.seq);
+            } catch (...) {
+                // 预取失败不影响计算：计算线程按需读盘时会重新报告错误
+            }
+            lock.lock();
+            active_--;
+        }
+    }
+
+    std::shared_ptr<const TiledDem> dem_;
+    size_t lookahead_ = 1;
+    uint64_t listener_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Pending> queue_;
+    uint64_t nextSeq_ = 0;
+    size_t active_ = 0;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace radar_coverage
@@ -0,0 +1,376 @@
+/**
+ * geodetic.hpp
+ *
+ * 大地坐标输入 - 逐雷达局部方位等距坐标系、批量正反投影、WGS84 导出
+ *
+ * - AeqdFrame: 以某点为中心的方位等距投影（球面，半径取该纬度的高斯平均曲率半径），
+ *   x 朝东、y 朝北，单位米；自中心出发的距离与方位不变形，与射线模型一致
+ * - 正反投影均提供结构数组批量版本：循环体无分支、常量预先计算，
+ *   在 -O3 -ffast-math 且有向量数学库（glibc libmvec）时可由编译器向量化
+ * - GeodeticCoverageGenerator: 接到 CoverageMergeManager::setCoverageGenerator 后，
+ *   每部雷达在以自身为中心的局部坐标系中投射射线：全部射线采样点一次批量反投影到
+ *   经纬度并批量查询 DEM，得到极坐标高程剖面，视线检查只做剖面插值；
+ *   生成的覆盖多边形再批量投影回管理器的工作坐标系
+ * - toWgs84: 导出前把整个结果一次批量反投影为经纬度（x = 经度，y = 纬度）
+ *
+ * 用法:
+ *   AeqdFrame work({39.9, 116.4});                           // 工作坐标系（合并用）
+ *   auto dem = std::make_shared<const ElevationGrid>(ElevationGrid::load("srtm.rcdem"));
+ *   manager.setCoverageGenerator(GeodeticCoverageGenerator(work, geographicGridSampler(dem)));
+ *   radar.position = work.forward({40.1, 116.2});
+ *   manager.addRadar(radar);
+ *   writeGeoJSON(out, toWgs84(manager.getMergedCoverage(), work));
+ *
+ * 依赖: radar_coverage.hpp, terrain_raster.hpp
+ */
+
+#pragma once
+
+#include "radar_coverage.hpp"
+#include "terrain_raster.hpp"
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// WGS84 常量
+// ============================================================================
+
+struct GeoPoint {
+    double lat = 0.0;   // 度
+    double lon = 0.0;   // 度
+};
+
+namespace wgs84 {
+
+constexpr double kSemiMajor = 6378137.0;
+constexpr double kFlattening = 1.0 / 298.257223563;
+constexpr double kE2 = kFlattening * (2.0 - kFlattening);
+constexpr double kDegToRad = M_PI / 180.0;
+constexpr double kRadToDeg = 180.0 / M_PI;
+
+/**
+ * 纬度 lat (弧度) 处的高斯平均曲率半径 sqrt(M * N)
+ */
+inline double gaussianRadius(double lat) {
+    double s = std::sin(lat);
+    return kSemiMajor * std::sqrt(1.0 - kE2) / (1.0 - kE2 * s * s);
+}
+
+} // namespace wgs84
+
+// ============================================================================
+// 方位等距投影
+// ============================================================================
+
+class AeqdFrame {
+public:
+    explicit AeqdFrame(GeoPoint origin = GeoPoint())
+        : origin_(origin),
+          lat0_(origin.lat * wgs84::kDegToRad),
+          lon0_(origin.lon * wgs84::kDegToRad),
+          sinLat0_(std::sin(lat0_)),
+          cosLat0_(std::cos(lat0_)),
+          radius_(wgs84::gaussianRadius(lat0_)) {}
+
+    const GeoPoint& origin() const { return origin_; }
+    double radius() const { return radius_; }
+
+    /**
+     * 经纬度 -> 平面；输出数组可与输入同址
+     */
+    void forward(const double* lat, const double* lon, double* x, double* y, size_t n) const {
+        for (size_t i = 0; i < n; i++) {
+            double phi = lat[i] * wgs84::kDegToRad;
+            double dLon = lon[i] * wgs84::kDegToRad - lon0_;
+            double sinPhi = std::sin(phi), cosPhi = std::cos(phi);
+            double cosDLon = std::cos(dLon);
+            double cosC = sinLat0_ * sinPhi + cosLat0_ * cosPhi * cosDLon;
+            cosC = std::min(1.0, std::max(-1.0, cosC));
+            double c = std::acos(cosC);
+            double sinC = std::sin(c);
+            double k = sinC > 1e-12 ? radius_ * c / sinC : radius_;
+            x[i] = k * cosPhi * std::sin(dLon);
+            y[i] = k * (cosLat0_ * sinPhi - sinLat0_ * cosPhi * cosDLon);
+        }
+    }
+
+    /**
+     * 平面 -> 经纬度（经度归一化到 [-180, 180]）；输出数组可与输入同址
+     */
+    void inverse(const double* x, const double* y, double* lat, double* lon, size_t n) const {
+        const double invRadius = 1.0 / radius_;
+        for (size_t i = 0; i < n; i++) {
+            double px = x[i], py = y[i];
+            double rho = std::sqrt(px * px + py * py);
+            double c = rho * invRadius;
+            double sinC = std::sin(c), cosC = std::cos(c);
+            double k = rho > 1e-9 ? sinC / rho : invRadius;        // sin(c) / rho
+            double phi = std::asin(std::min(1.0, std::max(-1.0, cosC * sinLat0_ + py * k * cosLat0_)));
+            double lambda = lon0_ + std::atan2(px * k, cosLat0_ * cosC - py * k * sinLat0_);
+            double deg = lambda * wgs84::kRadToDeg;
+            lat[i] = phi * wgs84::kRadToDeg;
+            lon[i] = deg > 180.0 ? deg - 360.0 : (deg < -180.0 ? deg + 360.0 : deg);
+        }
+    }
+
+    /**
+     * 沿一组射线等距反投影：第 k 条射线方位为 azimuths[k]（自正东逆时针，弧度），
+     * 第 j 个点距原点 j * step；输出按 [k * samples + j] 排列
+     *
+     * 各射线共享同一组 sin(c) / cos(c)，每点只剩 asin 与 atan2。
+     */
+    void inverseRays(const double* azimuths, size_t rays, double step, size_t samples,
+                     double* lat, double* lon) const {
+        std::vector<double> sinC(samples), cosC(samples);
+        for (size_t j = 0; j < samples; j++) {
+            double c = j * step / radius_;
+            sinC[j] = std::sin(c);
+            cosC[j] = std::cos(c);
+        }
+        for (size_t k = 0; k < rays; k++) {
+            // 方位角（自正北顺时针）θ：sinθ = cos(az)，cosθ = sin(az)
+            double sinT = std::cos(azimuths[k]), cosT = std::sin(azimuths[k]);
+            double* outLat = lat + k * samples;
+            double* outLon = lon + k * samples;
+            for (size_t j = 0; j < samples; j++) {
+                double phi = std::asin(std::min(1.0, std::max(-1.0,
+                    cosC[j] * sinLat0_ + cosT * sinC[j] * cosLat0_)));
+                double deg = (lon0_ + std::atan2(sinT * sinC[j],
+                    cosLat0_ * cosC[j] - sinLat0_ * cosT * sinC[j])) * wgs84::kRadToDeg;
+                outLat[j] = phi * wgs84::kRadToDeg;
+                outLon[j] = deg > 180.0 ? deg - 360.0 : (deg < -180.0 ? deg + 360.0 : deg);
+            }
+        }
+    }
+
+    Point2D forward(const GeoPoint& p) const {
+        Point2D out;
+        forward(&p.lat, &p.lon, &out.x, &out.y, 1);
+        return out;
+    }
+
+    GeoPoint inverse(const Point2D& p) const {
+        GeoPoint out;
+        inverse(&p.x, &p.y, &out.lat, &out.lon, 1);
+        return out;
+    }
+
+private:
+    GeoPoint origin_;
+    double lat0_, lon0_;
+    double sinLat0_, cosLat0_;
+    double radius_;
+};
+
+// ============================================================================
+// 批量重投影
+// ============================================================================
+
+/**
+ * 批量高程查询：lat / lon (度) -> h (米)
+ */
+using GeoElevationBatch = std::function<void(const double* lat, const double* lon, double* h, size_t n)>;
+
+/**
+ * 经纬度栅格 DEM（x = 经度，y = 纬度，cellSize 单位为度）的批量采样器
+ */
+inline GeoElevationBatch geographicGridSampler(std::shared_ptr<const ElevationGrid> grid) {
+    return [grid](const double* lat, const double* lon, double* h, size_t n) {
+        grid->sample(lon, lat, h, n);
+    };
+}
+
+/**
+ * 把点从 from 的平面坐标批量投影到 to 的平面坐标（经由经纬度）
+ */
+inline void reproject(std::vector<Point2D>& points, const AeqdFrame& from, const AeqdFrame& to) {
+    const size_t n = points.size();
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+    }
+    from.inverse(x.data(), y.data(), y.data(), x.data(), n);     // y <- lat, x <- lon
+    to.forward(y.data(), x.data(), x.data(), y.data(), n);
+    for (size_t i = 0; i < n; i++) points[i] = {x[i], y[i]};
+}
+
+/**
+ * 把 frame 平面坐标中的结果一次批量反投影为 WGS84（x = 经度，y = 纬度，可直接写出 GeoJSON）
+ */
+inline MultiPolygon toWgs84(const MultiPolygon& mp, const AeqdFrame& frame) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("toWgs84", "export", "regions", mp.size());
+    size_t n = 0;
+    for (const auto& pwh : mp) {
+        n += pwh.outer.size();
+        for (const auto& hole : pwh.holes) n += hole.size();
+    }
+
+    std::vector<double> x, y;
+    x.reserve(n);
+    y.reserve(n);
+    auto gather = [&](const Polygon& ring) {
+        for (const auto& p : ring) {
+            x.push_back(p.x);
+            y.push_back(p.y);
+        }
+    };
+    for (const auto& pwh : mp) {
+        gather(pwh.outer);
+        for (const auto& hole : pwh.holes) gather(hole);
+    }
+
+    frame.inverse(x.data(), y.data(), y.data(), x.data(), n);
+
+    MultiPolygon out = mp;
+    size_t i = 0;
+    auto scatter = [&](Polygon& ring) {
+        for (auto& p : ring) {
+            p = {x[i], y[i]};
+            i++;
+        }
+    };
+    for (auto& pwh : out) {
+        scatter(pwh.outer);
+        for (auto& hole : pwh.holes) scatter(hole);
+    }
+    return out;
+}
+
+// ============================================================================
+// 逐雷达射线高程剖面
+// ============================================================================
+
+/**
+ * 雷达局部坐标系（雷达位于原点）中每条射线方向上的等距高程剖面
+ *
+ * 构造时把全部采样点一次批量反投影到经纬度并批量查询高程；之后的视线采样点都落在
+ * 射线方位上，按方位取最近的射线、按距离线性插值。连续的查询通常位于同一条射线上，
+ * 先用叉积检查上一次命中的射线，不必每次求 atan2；因此实例不可跨线程共享。
+ */
+class RadarRayProfile {
+public:
+    RadarRayProfile(const RadarParams& radar, const AeqdFrame& frame, int numRays,
+                    size_t samplesPerRay, const GeoElevationBatch& elevation)
+        : numRays_(std::max(1, numRays)),
+          samples_(std::max<size_t>(2, samplesPerRay)),
+          azimuthStart_(radar.azimuthStart),
+          azimuthStep_((radar.azimuthEnd - radar.azimuthStart) / numRays_),
+          omni_(radar.isOmnidirectional()),
+          step_(radar.range / (samples_ - 1)) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("rayProfile", "terrain", "radar", radar.id);
+        std::vector<double> azimuths(numRays_);
+        directions_.resize(numRays_);
+        for (int k = 0; k < numRays_; k++) {
+            azimuths[k] = azimuthStart_ + k * azimuthStep_;
+            directions_[k] = Point2D(std::cos(azimuths[k]), std::sin(azimuths[k]));
+        }
+
+        const size_t n = static_cast<size_t>(numRays_) * samples_;
+        std::vector<double> lat(n), lon(n), h(n);
+        frame.inverseRays(azimuths.data(), azimuths.size(), step_, samples_, lat.data(), lon.data());
+        elevation(lat.data(), lon.data(), h.data(), n);
+        heights_.assign(h.begin(), h.end());
+    }
+
+    /**
+     * 局部坐标 (x, y) 处的高程
+     */
+    double elevation(double x, double y) const {
+        double r = std::sqrt(x * x + y * y);
+        const Point2D& dir = directions_[lastRay_];
+        long k = lastRay_;
+        if (std::abs(x * dir.y - y * dir.x) > 1e-6 * r || x * dir.x + y * dir.y < 0) {
+            // 方位差归一化到以扇区中线为中心的一整圈内
+            double halfSpan = 0.5 * azimuthStep_ * numRays_;
+            double d = std::remainder(std::atan2(y, x) - azimuthStart_ - halfSpan, 2 * M_PI) + halfSpan;
+            k = std::lround(d / azimuthStep_);
+            k = omni_ ? (k % numRays_ + numRays_) % numRays_
+                      : std::min<long>(std::max<long>(k, 0), numRays_ - 1);
+            lastRay_ = static_cast<int>(k);
+        }
+
+        double s = r / step_;
+        size_t j = std::min(static_cast<size_t>(s), samples_ - 2);
+        double f = std::min(1.0, s - j);
+        const float* ray = heights_.data() + static_cast<size_t>(k) * samples_;
+        return ray[j] + (ray[j + 1] - ray[j]) * f;
+    }
+
+    size_t memoryBytes() const { return heights_.size() * sizeof(float); }
+
+private:
+    int numRays_;
+    size_t samples_;
+    double azimuthStart_, azimuthStep_;
+    bool omni_;
+    double step_;
+    std::vector<Point2D> directions_;   // 各射线单位方向
+    std::vector<float> heights_;        // [ray][sample]
+    mutable int lastRay_ = 0;
+};
+
+// ============================================================================
+// 覆盖生成器
+// ============================================================================
+
+/**
+ * CoverageMergeManager 的大地坐标覆盖生成器
+ *
+ * RadarParams::position 为工作坐标系 work 中的位置（用 work.forward 由经纬度得到）。
+ * 高程取 DEM 与管理器 terrain() 中障碍物的较大值；terrain() 的高程函数不参与，
+ * 采样参数沿用 terrain()。
+ */
+class GeodeticCoverageGenerator {
+public:
+    GeodeticCoverageGenerator(const AeqdFrame& work, GeoElevationBatch elevation,
+                              size_t samplesPerRay = 128)
+        : work_(work), elevation_(std::move(elevation)), samplesPerRay_(samplesPerRay) {}
+
+    Polygon operator()(const RadarParams& radar, const TerrainModel& terrain, int numRays,
+                       std::vector<float>* rayRanges) const {
+        AeqdFrame local(work_.inverse(radar.position));
+        RadarParams localRadar = radar;
+        localRadar.position = Point2D(0, 0);
+
+        GeoElevationBatch elevation = elevation_;
+        if (!terrain.getObstacles().empty()) {
+            // 障碍物定义在工作坐标系中：剖面采样点再批量投影到工作坐标系后叠加
+            elevation = [this, &terrain](const double* lat, const double* lon, double* h, size_t n) {
+                elevation_(lat, lon, h, n);
+                std::vector<double> wx(n), wy(n);
+                work_.forward(lat, lon, wx.data(), wy.data(), n);
+                for (size_t i = 0; i < n; i++) {
+                    for (const auto& obs : terrain.getObstacles()) {
+                        h[i] = std::max(h[i], obs.getElevationAt({wx[i], wy[i]}));
+                    }
+                }
+            };
+        }
+        auto profile = std::make_shared<const RadarRayProfile>(
+            localRadar, local, numRays, samplesPerRay_, elevation);
+
+        TerrainModel localTerrain;
+        localTerrain.setSamplingSettings(terrain.getSamplingSettings());
+        localTerrain.setElevationFunction([profile](double x, double y) {
+            return profile->elevation(x, y);
+        });
+
+        Polygon polygon = generateCoveragePolygon(localRadar, localTerrain, numRays, rayRanges);
+        reproject(polygon, local, work_);
+        return polygon;
+    }
+
+    const AeqdFrame& workFrame() const { return work_; }
+
+private:
+    AeqdFrame work_;
+    GeoElevationBatch elevation_;
+    size_t samplesPerRay_;
+};
+
+} // namespace radar_coverage
@@ -0,0 +1,197 @@
+/**
+ * geojson_writer.hpp
+ *
+ * 流式 GeoJSON 导出 - 逐区域写出 FeatureCollection
+ *
+ * 文档从不整体驻留内存：每个区域格式化后直接进入 BufferedWriter 的缓冲区，
+ * 缓冲满后整块写出。坐标使用 std::to_chars（最短往返或定点精度）。
+ *
+ * 依赖: polygon_boolean.hpp, stream_writer.hpp
+ */
+
+#pragma once
+
+#include "polygon_boolean.hpp"
+#include "stream_writer.hpp"
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace radar_coverage {
+
+using polygon_ops::Point2D;
+using polygon_ops::Polygon;
+using polygon_ops::PolygonWithHoles;
+using polygon_ops::MultiPolygon;
+
+struct GeoJSONOptions {
+    int precision = -1;                        // <0: 最短往返; >=0: 小数位数
+    std::string featureType = "radar_coverage"; // properties.type
+    bool newlinePerFeature = true;             // 每个 Feature 独占一行（便于 diff/grep）
+};
+
+// ============================================================================
+// Feature 属性写入器（供逐区域回调追加自定义属性）
+// ============================================================================
+
+class GeoJSONProperties {
+public:
+    GeoJSONProperties(BufferedWriter& out, int precision)
+        : out_(out), precision_(precision) {}
+
+    void add(const char* key, double value) {
+        writeKey(key);
+        if (std::isfinite(value)) {
+            out_.writeDouble(value, precision_);
+        } else {
+            out_.writeLiteral("null");
+        }
+    }
+
+    void add(const char* key, int64_t value) { writeKey(key); out_.writeInt(value); }
+    void add(const char* key, int value) { add(key, static_cast<int64_t>(value)); }
+    void add(const char* key, size_t value) { writeKey(key); out_.writeUInt(value); }
+    void add(const char* key, bool value) {
+        writeKey(key);
+        if (value) out_.writeLiteral("true"); else out_.writeLiteral("false");
+    }
+    void add(const char* key, const std::string& value) {
+        writeKey(key);
+        writeString(out_, value);
+    }
+    void add(const char* key, const char* value) { add(key, std::string(value)); }
+
+    /**
+     * 写入 JSON 字符串（含引号与转义）
+     */
+    static void writeString(BufferedWriter& out, const std::string& s) {
+        writeJsonString(out, s);
+    }
+
+private:
+    void writeKey(const char* key) {
+        out_.put(',');
+        writeString(out_, key);
+        out_.put(':');
+    }
+
+    BufferedWriter& out_;
+    int precision_;
+};
+
+// ============================================================================
+// GeoJSON 写入器
+// ============================================================================
+
+class GeoJSONWriter {
+public:
+    /**
+     * 逐区域回调：在默认属性 (type, region_id, hole_count) 之后追加自定义属性
+     */
+    using PropertyCallback = std::function<void(size_t regionId,
+                                                const PolygonWithHoles& region,
+                                                GeoJSONProperties& props)>;
+
+    explicit GeoJSONWriter(BufferedWriter& out, GeoJSONOptions options = {})
+        : out_(out), options_(std::move(options)) {}
+
+    void setPropertyCallback(PropertyCallback cb) { propertyCallback_ = std::move(cb); }
+
+    void begin() {
+        out_.writeLiteral("{\"type\":\"FeatureCollection\",\"features\":[");
+        featureCount_ = 0;
+    }
+
+    /**
+     * 写出单个区域为 Polygon Feature（环自动闭合）
+     */
+    void writeFeature(const PolygonWithHoles& pwh, size_t regionId) {
+        if (featureCount_ > 0) out_.put(',');
+        if (options_.newlinePerFeature) out_.put('\n');
+
+        out_.writeLiteral("{\"type\":\"Feature\",\"properties\":{\"type\":");
+        GeoJSONProperties::writeString(out_, options_.featureType);
+        GeoJSONProperties props(out_, options_.precision);
+        props.add("region_id", regionId);
+        props.add("hole_count", pwh.holes.size());
+        if (propertyCallback_) propertyCallback_(regionId, pwh, props);
+
+        out_.writeLiteral("},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+        writeRing(pwh.outer);
+        for (const auto& hole : pwh.holes) {
+            out_.put(',');
+            writeRing(hole);
+        }
+        out_.writeLiteral("]}}");
+
+        featureCount_++;
+    }
+
+    void writeAll(const MultiPolygon& mp) {
+        for (size_t i = 0; i < mp.size(); i++) {
+            writeFeature(mp[i], i);
+        }
+    }
+
+    void end() {
+        if (options_.newlinePerFeature) out_.put('\n');
+        out_.writeLiteral("]}\n");
+    }
+
+    size_t featureCount() const { return featureCount_; }
+
+private:
+    void writeRing(const Polygon& ring) {
+        out_.put('[');
+        for (const auto& p : ring) {
+            writePoint(p);
+            out_.put(',');
+        }
+        if (!ring.empty()) {
+            writePoint(ring[0]);
+        }
+        out_.put(']');
+    }
+
+    void writePoint(const Point2D& p) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) {
+            throw std::runtime_error("GeoJSONWriter: non-finite coordinate");
+        }
+        out_.put('[');
+        out_.writeDouble(p.x, options_.precision);
+        out_.put(',');
+        out_.writeDouble(p.y, options_.precision);
+        out_.put(']');
+    }
+
+    BufferedWriter& out_;
+    GeoJSONOptions options_;
+    PropertyCallback propertyCallback_;
+    size_t featureCount_ = 0;
+};
+
+// ============================================================================
+// 便捷函数
+// ============================================================================
+
+inline void writeGeoJSON(BufferedWriter& out, const MultiPolygon& mp,
+                         const GeoJSONOptions& options = {},
+                         GeoJSONWriter::PropertyCallback cb = nullptr) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("writeGeoJSON", "export", "regions", mp.size());
+    GeoJSONWriter writer(out, options);
+    writer.setPropertyCallback(std::move(cb));
+    writer.begin();
+    writer.writeAll(mp);
+    writer.end();
+}
+
+inline void writeGeoJSON(const std::string& path, const MultiPolygon& mp,
+                         const GeoJSONOptions& options = {},
+                         GeoJSONWriter::PropertyCallback cb = nullptr) {
+    BufferedWriter out(path);
+    writeGeoJSON(out, mp, options, std::move(cb));
+    out.close();
+}
+
+} // namespace radar_coverage
@@ -0,0 +1,433 @@
+/**
+ * horizon_store.hpp
+ *
+ * 地平剖面持久存储 - 按内容寻址的剖面文件，进程重启后直接复用已算出的剖面
+ *
+ * 键为 (站址, 天线高度, 方位范围, 射线数, 采样参数, 地形校验和, DEM 校验和) 的 64 位散列，
+ * 查找时逐字段核对，散列碰撞不会返回错误的剖面。采样间距由 rangeTolerance 导出，
+ * 收紧容差后旧的粗剖面不再命中。地形校验和由
+ * TerrainModel::contentChecksum 给出（障碍、地球半径），DEM 校验和由打开存储的一方给出
+ * （ElevationGrid::checksum、TiledDem::checksum）：换了 DEM 或障碍后键随之改变，
+ * 旧剖面不再命中，无需手动清理。采样间距与剖面长度记录在剖面中，是否够用由
+ * CoverageMergeManager 判断（间距过粗时重建，长度不足时续采并写回）。
+ *
+ * 文件格式 .rchz（小端，只追加）:
+ *   "RCHORZ02"                       8 字节魔数
+ *   记录[]:
+ *     key u64, terrainChecksum u64, demChecksum u64
+ *     siteX f64, siteY f64, antennaHeight f64, azimuthStart f64, azimuthEnd f64, spacing f64,
+ *     rangeTolerance f64
+ *     numRays u32, losSamples u32, samples u64, payloadChecksum u64
+ *     float32[numRays * samples]     按射线连续存放，补齐到 8 字节
+ *
+ * 打开时映射整个文件并只扫描记录头建立索引（同键以最后一条为准），剖面数据直接引用
+ * 映射区，首次取用时校验。写到一半中断留下的残缺尾记录在打开时截掉；文件中间损坏的
+ * 区段跳过，之后的记录照常可用。
+ * 文件只增不减：旧 DEM 的记录和被覆盖的旧记录可用 compact() 清除。
+ *
+ * 用法:
+ *   auto dem = std::make_shared<TiledDem>("country.rctdem", 8ull << 30);
+ *   manager.terrain().setElevationFunction(TiledDem::asFunction(dem));
+ *   HorizonStore store("horizons.rchz", dem->checksum());
+ *   manager.setHorizonCache(true);
+ *   manager.setHorizonStore(store.hooks());      // store 须比 manager 的使用期长
+ *
+ * 依赖: radar_coverage.hpp, mapped_file.hpp, stream_writer.hpp, checksum.hpp
+ */
+
+#pragma once
+
+#include "radar_coverage.hpp"
+#include "checksum.hpp"
+#include "mapped_file.hpp"
+#include "stream_writer.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+namespace radar_coverage {
+
+struct HorizonStoreStats {
+    size_t entries = 0;             // 当前 DEM 下可用的剖面数
+    size_t staleRecords = 0;        // 其他 DEM 或被覆盖的记录（compact 可清除）
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t writes = 0;
+    size_t corrupt = 0;             // 数据校验失败而丢弃的记录与打开时跳过的损坏区段
+    uint64_t fileBytes = 0;
+};
+
+class HorizonStore {
+public:
+    static constexpr size_t kHeaderSize = 8;
+    static constexpr size_t kRecordHeaderSize = 8 * 3 + 8 * 7 + 4 + 4 + 8 + 8;
+
+    /**
+     * 打开（不存在时创建）存储文件
+     *
+     * @param demChecksum 当前 DEM 的校验和；其他 DEM 的记录保留在文件中但不会命中
+     * @throws std::runtime_error 文件无法创建、读取或不是剖面存储
+     */
+    HorizonStore(const std::string& path, uint64_t demChecksum) : path_(path), demChecksum_(demChecksum) {
+        if (!BufferedWriter::isLittleEndian()) {
+            throw std::runtime_error("HorizonStore: big-endian hosts are not supported");
+        }
+        std::error_code ec;
+        if (!std::filesystem::exists(path_, ec) || std::filesystem::file_size(path_, ec) == 0) {
+            BufferedWriter out(path_);
+            out.writeLiteral("RCHORZ02");
+            out.close();
+        }
+        loadIndex();
+        openAppend();
+    }
+
+    HorizonStore(const HorizonStore&) = delete;
+    HorizonStore& operator=(const HorizonStore&) = delete;
+
+    ~HorizonStore() {
+        if (append_) std::fclose(append_);
+    }
+
+    /**
+     * 查找与雷达站址、高度、方位、射线数及采样参数相同的剖面；没有或数据校验失败时返回空
+     */
+    std::shared_ptr<const HorizonProfile> find(const RadarParams& radar, int numRays,
+                                               const SamplingSettings& sampling, uint64_t terrainChecksum) {
+        uint64_t key = recordKey(radar.position.x, radar.position.y, radar.height, radar.azimuthStart,
+                                 radar.azimuthEnd, numRays, sampling, terrainChecksum, demChecksum_);
+        Entry e;
+        std::shared_ptr<MappedFile> mapping;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it == index_.end()) {
+                stats_.misses++;
+                return nullptr;
+            }
+            e = it->second;
+            mapping = mapping_;
+        }
+
+        // 校验与解码在锁外进行，其他线程的查找与追加不必等待
+        if (!e.profile) e.profile = loadRecord(mapping, e.offset);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        // 期间条目未被 put 取代、文件未被 compact 重新映射时才回填
+        const bool current = it != index_.end() && it->second.offset == e.offset && mapping_ == mapping;
+        if (current && !it->second.profile) {
+            if (e.profile) {
+                it->second.profile = e.profile;
+            } else {
+                stats_.corrupt++;
+                index_.erase(it);
+            }
+        }
+        const HorizonProfile* p = e.profile.get();
+        if (p && p->matches(radar, numRays) && e.terrainChecksum == terrainChecksum &&
+            sameSampling(e.sampling, sampling)) {
+            stats_.hits++;
+            return e.profile;
+        }
+        stats_.misses++;
+        return nullptr;
+    }
+
+    /**
+     * 追加剖面（同键的旧记录被取代）；写入立即刷到文件
+     */
+    void put(std::shared_ptr<const HorizonProfile> profile, const SamplingSettings& sampling,
+             uint64_t terrainChecksum) {
+        if (!profile || profile->numRays() <= 0) return;
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("storeHorizon", "io", "samples", profile->samplesPerRay());
+        uint64_t key = profileKey(*profile, sampling, terrainChecksum);
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t offset = fileBytes_;
+        try {
+            BufferedWriter out(
+                [this](const char* data, size_t size) {
+                    if (std::fwrite(data, 1, size, append_) != size) {
+                        throw std::runtime_error("HorizonStore: write failed on " + path_);
+                    }
+                },
+                size_t(64) << 10);
+            size_t bytes = writeRecord(out, *profile, key, sampling, terrainChecksum);
+            out.close();
+            if (std::fflush(append_) != 0) throw std::runtime_error("HorizonStore: write failed on " + path_);
+            fileBytes_ += bytes;
+        } catch (...) {
+            // 截掉写了一半的记录，之后的追加仍然对齐
+            std::fflush(append_);
+            std::error_code ec;
+            std::filesystem::resize_file(path_, offset, ec);
+            throw;
+        }
+
+        auto it = index_.find(key);
+        if (it != index_.end()) stats_.staleRecords++;
+        index_[key] = Entry{offset, terrainChecksum, sampling, std::move(profile)};
+        stats_.writes++;
+    }
+
+    /**
+     * 适配 CoverageMergeManager::setHorizonStore
+     */
+    CoverageMergeManager::HorizonStoreHooks hooks() {
+        CoverageMergeManager::HorizonStoreHooks h;
+        h.find = [this](const RadarParams& radar, int numRays, const SamplingSettings& sampling,
+                        uint64_t terrainChecksum) {
+            return find(radar, numRays, sampling, terrainChecksum);
+        };
+        h.put = [this](std::shared_ptr<const HorizonProfile> profile, const SamplingSettings& sampling,
+                       uint64_t terrainChecksum) {
+            put(std::move(profile), sampling, terrainChecksum);
+        };
+        return h;
+    }
+
+    /**
+     * 重写文件，只保留当前 DEM 下每个键的最新记录
+     *
+     * 先写临时文件再原子替换；任何一步失败都删除临时文件并抛出，存储保持可用
+     * （替换之后的失败会让之后的追加落到被替换的旧文件中，不再持久）。
+     *
+     * @throws std::runtime_error 临时文件写入、替换或重新打开失败
+     */
+    void compact() {
+        RADAR_COVERAGE_TRACE_SCOPE("compactHorizonStore", "io");
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string tmp = path_ + ".tmp";
+        std::error_code ec;
+        try {
+            BufferedWriter out(tmp);
+            out.writeLiteral("RCHORZ02");
+            for (auto& kv : index_) {
+                Entry& e = kv.second;
+                if (!e.profile) e.profile = loadRecord(mapping_, e.offset);
+                if (e.profile) writeRecord(out, *e.profile, kv.first, e.sampling, e.terrainChecksum);
+            }
+            out.close();
+        } catch (...) {
+            std::filesystem::remove(tmp, ec);
+            throw;
+        }
+        // 追加句柄在新文件就绪前保持打开，替换失败时不会留下空句柄
+        std::filesystem::rename(tmp, path_, ec);
+        if (ec) {
+            std::error_code ignored;
+            std::filesystem::remove(tmp, ignored);
+            throw std::runtime_error("HorizonStore: cannot replace " + path_ + ": " + ec.message());
+        }
+        // 已载入的剖面可能引用旧映射，由各自的 shared_ptr 保持有效
+        std::FILE* old = append_;
+        append_ = nullptr;
+        try {
+            openAppend();
+            loadIndex();
+        } catch (...) {
+            if (append_) std::fclose(append_);
+            append_ = old;
+            throw;
+        }
+        std::fclose(old);
+    }
+
+    HorizonStoreStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        HorizonStoreStats s = stats_;
+        s.entries = index_.size();
+        s.fileBytes = fileBytes_;
+        return s;
+    }
+
+    const std::string& path() const { return path_; }
+    uint64_t demChecksum() const { return demChecksum_; }
+
+private:
+    struct Entry {
+        uint64_t offset = 0;
+        uint64_t terrainChecksum = 0;
+        SamplingSettings sampling;
+        std::shared_ptr<const HorizonProfile> profile;  // 已取用或本进程写入的剖面
+    };
+
+    static bool sameSampling(const SamplingSettings& a, const SamplingSettings& b) {
+        return a.rangeTolerance == b.rangeTolerance && a.losSamples == b.losSamples;
+    }
+
+    static uint64_t recordKey(double siteX, double siteY, double height, double azimuthStart,
+                              double azimuthEnd, int numRays, const SamplingSettings& sampling,
+                              uint64_t terrainChecksum, uint64_t demChecksum) {
+        Hasher64 h;
+        h.add(siteX).add(siteY).add(height).add(azimuthStart).add(azimuthEnd);
+        h.add<int64_t>(numRays).add(sampling.rangeTolerance).add<int64_t>(sampling.losSamples);
+        h.add(terrainChecksum).add(demChecksum);
+        return h.digest();
+    }
+
+    uint64_t profileKey(const HorizonProfile& p, const SamplingSettings& sampling,
+                        uint64_t terrainChecksum) const {
+        return recordKey(p.site().x, p.site().y, p.antennaHeight(), p.azimuthStart(), p.azimuthEnd(),
+                         p.numRays(), sampling, terrainChecksum, demChecksum_);
+    }
+
+    static size_t payloadBytes(uint32_t numRays, uint64_t samples) {
+        size_t bytes = static_cast<size_t>(numRays) * samples * sizeof(float);
+        return (bytes + 7) & ~size_t(7);
+    }
+
+    size_t writeRecord(BufferedWriter& out, const HorizonProfile& p, uint64_t key,
+                       const SamplingSettings& sampling, uint64_t terrainChecksum) const {
+        const size_t floats = static_cast<size_t>(p.numRays()) * p.samplesPerRay();
+        out.writeLE<uint64_t>(key);
+        out.writeLE<uint64_t>(terrainChecksum);
+        out.writeLE<uint64_t>(demChecksum_);
+        out.writeLE<double>(p.site().x);
+        out.writeLE<double>(p.site().y);
+        out.writeLE<double>(p.antennaHeight());
+        out.writeLE<double>(p.azimuthStart());
+        out.writeLE<double>(p.azimuthEnd());
+        out.writeLE<double>(p.spacing());
+        out.writeLE<double>(sampling.rangeTolerance);
+        out.writeLE<uint32_t>(static_cast<uint32_t>(p.numRays()));
+        out.writeLE<uint32_t>(static_cast<uint32_t>(sampling.losSamples));
+        out.writeLE<uint64_t>(p.samplesPerRay());
+        out.writeLE<uint64_t>(Hasher64().update(p.data(), floats * sizeof(float)).digest());
+        out.write(reinterpret_cast<const char*>(p.data()), floats * sizeof(float));
+        const size_t padded = payloadBytes(static_cast<uint32_t>(p.numRays()), p.samplesPerRay());
+        const char zeros[8] = {0};
+        out.write(zeros, padded - floats * sizeof(float));
+        return kRecordHeaderSize + padded;
+    }
+
+    struct RecordHeader {
+        uint64_t key, terrainChecksum, demChecksum, samples;
+        double f[7];
+        uint32_t numRays, losSamples;
+
+        SamplingSettings sampling() const {
+            SamplingSettings s;
+            s.rangeTolerance = f[6];
+            s.losSamples = static_cast<int>(losSamples);
+            return s;
+        }
+    };
+
+    /**
+     * 解析 offset 处的记录头；自洽（键由字段重算，数据长度不超出文件）时返回记录字节数，否则返回 0
+     */
+    size_t parseHeader(const uint8_t* base, size_t size, size_t offset, RecordHeader& h) const {
+        const uint8_t* r = base + offset;
+        std::memcpy(&h.key, r, 8);
+        std::memcpy(&h.terrainChecksum, r + 8, 8);
+        std::memcpy(&h.demChecksum, r + 16, 8);
+        std::memcpy(h.f, r + 24, sizeof(h.f));
+        std::memcpy(&h.numRays, r + 80, 4);
+        std::memcpy(&h.losSamples, r + 84, 4);
+        std::memcpy(&h.samples, r + 88, 8);
+        if (h.numRays == 0 || !(h.f[5] > 0) ||
+            h.samples > (size - offset - kRecordHeaderSize) / sizeof(float) / h.numRays ||
+            h.key != recordKey(h.f[0], h.f[1], h.f[2], h.f[3], h.f[4], static_cast<int>(h.numRays),
+                               h.sampling(), h.terrainChecksum, h.demChecksum)) {
+            return 0;
+        }
+        size_t recordBytes = kRecordHeaderSize + payloadBytes(h.numRays, h.samples);
+        return recordBytes <= size - offset ? recordBytes : 0;
+    }
+
+    /**
+     * 映射文件并扫描记录头
+     *
+     * 中间损坏的区段跳到下一条自洽的记录（记录按 8 字节对齐）并计入 corrupt；
+     * 一直坏到文件末尾的残缺尾部截掉，保证之后追加的记录对齐。
+     */
+    void loadIndex() {
+        auto mapping = std::make_shared<MappedFile>(path_);
+        const uint8_t* base = mapping->data();
+        const size_t size = mapping->size();
+        if (size < kHeaderSize || std::memcmp(base, "RCHORZ02", 8) != 0) {
+            throw std::runtime_error("HorizonStore: not a horizon store: " + path_);
+        }
+
+        // 扫描完成后才替换索引与映射，失败时保持原状
+        std::unordered_map<uint64_t, Entry> index;
+        size_t staleRecords = 0;
+        size_t corrupt = 0;
+        size_t offset = kHeaderSize;
+        RecordHeader h;
+        while (size - offset >= kRecordHeaderSize) {
+            size_t recordBytes = parseHeader(base, size, offset, h);
+            if (recordBytes == 0) {
+                size_t next = offset + 8;
+                while (size - next >= kRecordHeaderSize && parseHeader(base, size, next, h) == 0) next += 8;
+                if (size - next < kRecordHeaderSize) break;
+                corrupt++;
+                offset = next;
+                continue;
+            }
+
+            if (h.demChecksum != demChecksum_) {
+                staleRecords++;
+            } else {
+                auto it = index.find(h.key);
+                if (it != index.end()) staleRecords++;
+                index[h.key] = Entry{offset, h.terrainChecksum, h.sampling(), nullptr};
+            }
+            offset += recordBytes;
+        }
+
+        if (offset < size) std::filesystem::resize_file(path_, offset);
+        mapping_ = std::move(mapping);
+        index_ = std::move(index);
+        stats_.staleRecords = staleRecords;
+        stats_.corrupt += corrupt;
+        fileBytes_ = offset;
+    }
+
+    void openAppend() {
+        append_ = std::fopen(path_.c_str(), "ab");
+        if (!append_) throw std::runtime_error("HorizonStore: cannot open " + path_ + " for writing");
+    }
+
+    /**
+     * 由映射区构造剖面（直接引用映射数据）；数据校验失败返回空
+     */
+    static std::shared_ptr<const HorizonProfile> loadRecord(const std::shared_ptr<MappedFile>& mapping,
+                                                            uint64_t offset) {
+        const uint8_t* r = mapping->data() + offset;
+        double f[6];
+        uint32_t numRays;
+        uint64_t samples, payloadChecksum;
+        std::memcpy(f, r + 24, sizeof(f));
+        std::memcpy(&numRays, r + 80, 4);
+        std::memcpy(&samples, r + 88, 8);
+        std::memcpy(&payloadChecksum, r + 96, 8);
+
+        const float* data = reinterpret_cast<const float*>(r + kRecordHeaderSize);
+        const size_t bytes = static_cast<size_t>(numRays) * samples * sizeof(float);
+        if (Hasher64().update(data, bytes).digest() != payloadChecksum) return nullptr;
+        return std::make_shared<const HorizonProfile>(HorizonProfile::fromData(
+            Point2D(f[0], f[1]), f[2], f[3], f[4], static_cast<int>(numRays), f[5],
+            static_cast<size_t>(samples), data, mapping));
+    }
+
+    std::string path_;
+    uint64_t demChecksum_;
+    std::shared_ptr<MappedFile> mapping_;
+    std::FILE* append_ = nullptr;
+    uint64_t fileBytes_ = 0;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Entry> index_;
+    HorizonStoreStats stats_;
+};
+
+} // namespace radar_coverage
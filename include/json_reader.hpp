@@ -0,0 +1,347 @@
+/**
+ * json_reader.hpp
+ *
+ * 最小 JSON 解析器（场景文件、批处理清单等配置输入）
+ *
+ * - 递归下降，构建轻量 DOM；数字使用 std::from_chars，与 locale 无关
+ * - 支持 \uXXXX 转义（含代理对）并输出 UTF-8
+ * - 严格遵循 RFC 8259：拒绝 inf/nan、前导零与字符串内未转义的控制字符
+ * - 语法错误抛出 std::runtime_error，附带字节偏移
+ *
+ * 依赖: 无 (需要支持浮点 std::from_chars 的标准库, 如 GCC 11+)
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace radar_coverage {
+
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isNumber() const { return type_ == Type::Number; }
+    bool isString() const { return type_ == Type::String; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isObject() const { return type_ == Type::Object; }
+
+    double asNumber() const {
+        require(Type::Number, "number");
+        return number_;
+    }
+
+    /**
+     * 转为整数类型 Int（小数部分截断）
+     *
+     * @throws std::runtime_error 不是数字或超出 Int 的范围（越界的浮点转整数是未定义行为）
+     */
+    template <typename Int = int64_t>
+    Int asInt() const {
+        const double v = asNumber();
+        // max + 1 是 2 的幂，可精确表示；NaN 不满足任何比较
+        const double lo = static_cast<double>(std::numeric_limits<Int>::min());
+        const double hi = static_cast<double>(std::numeric_limits<Int>::max()) + 1.0;
+        if (!(v >= lo && v < hi)) {
+            throw std::runtime_error("JSON: integer out of range: " + std::to_string(v));
+        }
+        return static_cast<Int>(v);
+    }
+
+    bool asBool() const {
+        require(Type::Bool, "bool");
+        return boolean_;
+    }
+
+    const std::string& asString() const {
+        require(Type::String, "string");
+        return string_;
+    }
+
+    const std::vector<JsonValue>& items() const {
+        require(Type::Array, "array");
+        return array_;
+    }
+
+    size_t size() const {
+        if (type_ == Type::Array) return array_.size();
+        if (type_ == Type::Object) return object_.size();
+        return 0;
+    }
+
+    const JsonValue& operator[](size_t i) const { return items().at(i); }
+
+    /**
+     * 查找对象成员；不存在时返回 nullptr
+     */
+    const JsonValue* find(const char* key) const {
+        require(Type::Object, "object");
+        for (const auto& kv : object_) {
+            if (kv.first == key) return &kv.second;
+        }
+        return nullptr;
+    }
+
+    const JsonValue& at(const char* key) const {
+        const JsonValue* v = find(key);
+        if (!v) throw std::runtime_error(std::string("JSON: missing key '") + key + "'");
+        return *v;
+    }
+
+    double numberOr(const char* key, double fallback) const {
+        const JsonValue* v = find(key);
+        return v ? v->asNumber() : fallback;
+    }
+
+    template <typename Int>
+    Int intOr(const char* key, Int fallback) const {
+        const JsonValue* v = find(key);
+        return v ? v->asInt<Int>() : fallback;
+    }
+
+    std::string stringOr(const char* key, const std::string& fallback) const {
+        const JsonValue* v = find(key);
+        return v ? v->asString() : fallback;
+    }
+
+    const std::vector<std::pair<std::string, JsonValue>>& members() const {
+        require(Type::Object, "object");
+        return object_;
+    }
+
+private:
+    friend class JsonParser;
+
+    void require(Type t, const char* name) const {
+        if (type_ != t) throw std::runtime_error(std::string("JSON: expected ") + name);
+    }
+
+    Type type_ = Type::Null;
+    bool boolean_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::vector<std::pair<std::string, JsonValue>> object_;
+};
+
+class JsonParser {
+public:
+    static JsonValue parse(const char* data, size_t size) {
+        JsonParser p(data, size);
+        p.skipWhitespace();
+        JsonValue v = p.parseValue(0);
+        p.skipWhitespace();
+        if (p.pos_ != p.size_) p.fail("trailing characters");
+        return v;
+    }
+
+    static JsonValue parse(const std::string& text) { return parse(text.data(), text.size()); }
+
+private:
+    static constexpr int kMaxDepth = 256;
+
+    JsonParser(const char* data, size_t size) : data_(data), size_(size) {}
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string("JSON: ") + what + " at offset " +
+                                 std::to_string(pos_));
+    }
+
+    void skipWhitespace() {
+        while (pos_ < size_) {
+            char c = data_[pos_];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+            pos_++;
+        }
+    }
+
+    char peek() const { return pos_ < size_ ? data_[pos_] : '\0'; }
+
+    void expect(char c) {
+        if (peek() != c) fail("unexpected character");
+        pos_++;
+    }
+
+    void expectWord(const char* word) {
+        size_t n = std::strlen(word);
+        if (size_ - pos_ < n || std::memcmp(data_ + pos_, word, n) != 0) fail("invalid literal");
+        pos_ += n;
+    }
+
+    JsonValue parseValue(int depth) {
+        if (depth > kMaxDepth) fail("nesting too deep");
+        JsonValue v;
+        switch (peek()) {
+            case '{': parseObject(v, depth); break;
+            case '[': parseArray(v, depth); break;
+            case '"':
+                v.type_ = JsonValue::Type::String;
+                v.string_ = parseString();
+                break;
+            case 't': expectWord("true"); v.type_ = JsonValue::Type::Bool; v.boolean_ = true; break;
+            case 'f': expectWord("false"); v.type_ = JsonValue::Type::Bool; break;
+            case 'n': expectWord("null"); break;
+            default: parseNumber(v); break;
+        }
+        return v;
+    }
+
+    void parseObject(JsonValue& v, int depth) {
+        v.type_ = JsonValue::Type::Object;
+        expect('{');
+        skipWhitespace();
+        if (peek() == '}') { pos_++; return; }
+        while (true) {
+            skipWhitespace();
+            std::string key = parseString();
+            skipWhitespace();
+            expect(':');
+            skipWhitespace();
+            v.object_.emplace_back(std::move(key), parseValue(depth + 1));
+            skipWhitespace();
+            if (peek() == ',') { pos_++; continue; }
+            expect('}');
+            return;
+        }
+    }
+
+    void parseArray(JsonValue& v, int depth) {
+        v.type_ = JsonValue::Type::Array;
+        expect('[');
+        skipWhitespace();
+        if (peek() == ']') { pos_++; return; }
+        while (true) {
+            skipWhitespace();
+            v.array_.push_back(parseValue(depth + 1));
+            skipWhitespace();
+            if (peek() == ',') { pos_++; continue; }
+            expect(']');
+            return;
+        }
+    }
+
+    /**
+     * 按 JSON 数字文法扫描后交给 from_chars，拒绝 inf/nan、前导零、"1." 等
+     */
+    void parseNumber(JsonValue& v) {
+        const char* begin = data_ + pos_;
+        const char* end = data_ + size_;
+        const char* p = begin;
+        auto isDigit = [&](const char* q) { return q < end && *q >= '0' && *q <= '9'; };
+
+        if (p < end && *p == '-') p++;
+        if (!isDigit(p)) fail("invalid number");
+        if (*p == '0') {
+            p++;
+            if (isDigit(p)) fail("invalid number");
+        } else {
+            while (isDigit(p)) p++;
+        }
+        if (p < end && *p == '.') {
+            p++;
+            if (!isDigit(p)) fail("invalid number");
+            while (isDigit(p)) p++;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            if (p < end && (*p == '+' || *p == '-')) p++;
+            if (!isDigit(p)) fail("invalid number");
+            while (isDigit(p)) p++;
+        }
+
+        auto result = std::from_chars(begin, p, v.number_);
+        if (result.ec != std::errc() || result.ptr != p) fail("invalid number");
+        pos_ += p - begin;
+        v.type_ = JsonValue::Type::Number;
+    }
+
+    unsigned parseHex4() {
+        if (size_ - pos_ < 4) fail("truncated \\u escape");
+        unsigned cp = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = data_[pos_++];
+            cp <<= 4;
+            if (c >= '0' && c <= '9') cp |= c - '0';
+            else if (c >= 'a' && c <= 'f') cp |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') cp |= c - 'A' + 10;
+            else fail("invalid \\u escape");
+        }
+        return cp;
+    }
+
+    static void appendUtf8(std::string& out, unsigned cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (true) {
+            size_t start = pos_;
+            while (pos_ < size_ && data_[pos_] != '"' && data_[pos_] != '\\' &&
+                   static_cast<unsigned char>(data_[pos_]) >= 0x20) {
+                pos_++;
+            }
+            out.append(data_ + start, pos_ - start);
+            if (pos_ >= size_) fail("unterminated string");
+            if (static_cast<unsigned char>(data_[pos_]) < 0x20) fail("control character in string");
+            if (data_[pos_] == '"') { pos_++; return out; }
+
+            pos_++;  // '\\'
+            if (pos_ >= size_) fail("unterminated escape");
+            char c = data_[pos_++];
+            switch (c) {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    unsigned cp = parseHex4();
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        expect('\\');
+                        expect('u');
+                        unsigned low = parseHex4();
+                        if (low < 0xDC00 || low > 0xDFFF) fail("invalid surrogate pair");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default: fail("invalid escape");
+            }
+        }
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+} // namespace radar_coverage
@@ -0,0 +1,102 @@
+/**
+ * mapped_file.hpp
+ *
+ * 只读内存映射文件 (POSIX mmap)，非 POSIX 平台退化为整体读入
+ *
+ * 依赖: 无
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RADAR_COVERAGE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace radar_coverage {
+
+class MappedFile {
+public:
+    /**
+     * @throws std::runtime_error 文件无法打开或映射
+     */
+    explicit MappedFile(const std::string& path) : path_(path) {
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("MappedFile: cannot open " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("MappedFile: mmap failed for " + path);
+            }
+            data_ = static_cast<const uint8_t*>(p);
+        }
+        ::close(fd);
+#else
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) throw std::runtime_error("MappedFile: cannot open " + path);
+        char buf[1 << 16];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+            fallback_.insert(fallback_.end(), buf, buf + n);
+        }
+        std::fclose(f);
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+        if (data_ && size_ > 0) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+#endif
+    }
+
+    /**
+     * 提示内核顺序预读（仅 POSIX 有效）
+     */
+    void adviseSequential() const {
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+        if (data_ && size_ > 0) {
+            ::madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#if !defined(RADAR_COVERAGE_HAS_MMAP)
+    std::vector<uint8_t> fallback_;
+#endif
+};
+
+} // namespace radar_coverage
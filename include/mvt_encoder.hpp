@@ -0,0 +1,586 @@
+/**
+ * mvt_encoder.hpp
+ *
+ * Mapbox Vector Tile (MVT 2.1) 编码与瓦片金字塔生成
+ *
+ * - 手写 protobuf 编码，无额外依赖
+ * - 每个瓦片用 Clipper2 RectClip 裁剪（含缓冲边），量化到瓦片网格，
+ *   丢弃退化环（少于 3 个不同顶点或面积为 0）
+ * - 金字塔中各瓦片并行编码，输出到目录 (z/x/y.mvt) 或单文件瓦片包
+ *
+ * 坐标约定: 世界坐标 y 轴向上；瓦片行号 y 从世界范围顶部 (maxY) 开始计数，
+ * 与 XYZ 瓦片方案一致。
+ *
+ * 依赖: polygon_boolean.hpp, parallel_for.hpp
+ */
+
+#pragma once
+
+#include "polygon_boolean.hpp"
+#include "parallel_for.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace radar_coverage {
+
+using polygon_ops::Point2D;
+using polygon_ops::Polygon;
+using polygon_ops::PolygonWithHoles;
+using polygon_ops::MultiPolygon;
+using polygon_ops::PolygonUtils;
+
+namespace mvt {
+
+// ============================================================================
+// Protobuf 编码
+// ============================================================================
+
+class ProtoWriter {
+public:
+    enum WireType : uint32_t { Varint = 0, LengthDelimited = 2 };
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            buf_.push_back(static_cast<char>((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        buf_.push_back(static_cast<char>(v));
+    }
+
+    void key(uint32_t field, WireType type) { varint((field << 3) | type); }
+
+    void uintField(uint32_t field, uint64_t v) {
+        key(field, Varint);
+        varint(v);
+    }
+
+    void bytesField(uint32_t field, const std::string& bytes) {
+        key(field, LengthDelimited);
+        varint(bytes.size());
+        buf_.append(bytes);
+    }
+
+    void packedField(uint32_t field, const std::vector<uint32_t>& values) {
+        if (values.empty()) return;
+        ProtoWriter packed;
+        for (uint32_t v : values) packed.varint(v);
+        bytesField(field, packed.data());
+    }
+
+    static uint32_t zigzag(int32_t v) {
+        return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+    }
+
+    const std::string& data() const { return buf_; }
+    std::string& data() { return buf_; }
+
+private:
+    std::string buf_;
+};
+
+// 几何命令
+constexpr uint32_t kMoveTo = 1;
+constexpr uint32_t kLineTo = 2;
+constexpr uint32_t kClosePath = 7;
+constexpr uint32_t kPolygonType = 3;
+
+inline uint32_t command(uint32_t id, uint32_t count) { return (id & 0x7) | (count << 3); }
+
+struct TilePoint {
+    int32_t x, y;
+};
+using TileRing = std::vector<TilePoint>;
+
+inline int64_t ringArea2(const TileRing& ring) {
+    int64_t a = 0;
+    for (size_t i = 0, n = ring.size(); i < n; i++) {
+        const TilePoint& p = ring[i];
+        const TilePoint& q = ring[(i + 1) % n];
+        a += static_cast<int64_t>(p.x) * q.y - static_cast<int64_t>(q.x) * p.y;
+    }
+    return a;
+}
+
+inline bool pointInRing(const TilePoint& pt, const TileRing& ring) {
+    Polygon poly;
+    poly.reserve(ring.size());
+    for (const auto& p : ring) poly.emplace_back(p.x, p.y);
+    return PolygonUtils::pointInPolygon({static_cast<double>(pt.x), static_cast<double>(pt.y)}, poly);
+}
+
+} // namespace mvt
+
+// ============================================================================
+// 瓦片网格
+// ============================================================================
+
+struct TileId {
+    uint32_t z, x, y;
+};
+
+/**
+ * 将世界坐标范围划分为 2^z × 2^z 的瓦片
+ */
+struct TileGrid {
+    double minX = 0, minY = 0;
+    double size = 1;   // 正方形世界范围边长
+
+    /**
+     * 以数据边界框构造（取较长边，使瓦片为正方形）
+     */
+    static TileGrid fromBounds(const PolygonUtils::BoundingBox& b) {
+        TileGrid g;
+        g.minX = b.minX;
+        g.minY = b.minY;
+        g.size = std::max(b.width(), b.height());
+        if (!(g.size > 0)) g.size = 1;
+        return g;
+    }
+
+    double tileSize(uint32_t z) const { return size / static_cast<double>(1u << z); }
+
+    PolygonUtils::BoundingBox tileBounds(const TileId& t) const {
+        double ts = tileSize(t.z);
+        double left = minX + t.x * ts;
+        double top = minY + size - t.y * ts;
+        return {left, top - ts, left + ts, top};
+    }
+};
+
+struct MVTOptions {
+    uint32_t extent = 4096;            // 瓦片网格分辨率
+    uint32_t buffer = 64;              // 裁剪缓冲（瓦片单位）
+    std::string layerName = "coverage";
+    uint32_t minZoom = 0;
+    uint32_t maxZoom = 6;
+    size_t numThreads = 0;             // 0 = 硬件线程数
+};
+
+// ============================================================================
+// 单瓦片编码
+// ============================================================================
+
+class MVTEncoder {
+public:
+    explicit MVTEncoder(MVTOptions options = {}) : options_(std::move(options)) {}
+
+    /**
+     * 编码单个瓦片；无有效要素时返回空字符串
+     *
+     * @param regionIds 若非空，只处理这些区域索引（由金字塔按包围盒预筛选）
+     */
+    std::string encodeTile(const MultiPolygon& mp, const TileGrid& grid, const TileId& tile,
+                           const std::vector<size_t>* regionIds = nullptr) const {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("encodeTile", "export", "z", tile.z);
+        PolygonUtils::BoundingBox tb = grid.tileBounds(tile);
+        double scale = options_.extent / grid.tileSize(tile.z);
+        double margin = options_.buffer / scale;
+        Clipper2Lib::RectD rect(tb.minX - margin, tb.minY - margin,
+                                tb.maxX + margin, tb.maxY + margin);
+
+        mvt::ProtoWriter layer;
+        layer.uintField(15, 2);                     // version
+        layer.bytesField(1, options_.layerName);    // name
+
+        std::map<uint64_t, uint32_t> valueIndex;
+        std::vector<uint64_t> values;
+        auto valueId = [&](uint64_t v) {
+            auto it = valueIndex.find(v);
+            if (it != valueIndex.end()) return it->second;
+            uint32_t id = static_cast<uint32_t>(values.size());
+            valueIndex.emplace(v, id);
+            values.push_back(v);
+            return id;
+        };
+
+        size_t features = 0;
+        size_t count = regionIds ? regionIds->size() : mp.size();
+        for (size_t k = 0; k < count; k++) {
+            size_t i = regionIds ? (*regionIds)[k] : k;
+            std::vector<uint32_t> geometry = encodeRegion(mp[i], rect, tb, scale);
+            if (geometry.empty()) continue;
+
+            mvt::ProtoWriter feature;
+            feature.uintField(1, i + 1);   // id
+            feature.packedField(2, {0, valueId(i), 1, valueId(mp[i].holes.size())});
+            feature.uintField(3, mvt::kPolygonType);
+            feature.packedField(4, geometry);
+            layer.bytesField(2, feature.data());
+            features++;
+        }
+
+        if (features == 0) return {};
+
+        layer.bytesField(3, "region_id");
+        layer.bytesField(3, "hole_count");
+        for (uint64_t v : values) {
+            mvt::ProtoWriter value;
+            value.uintField(5, v);   // uint_value
+            layer.bytesField(4, value.data());
+        }
+        layer.uintField(5, options_.extent);
+
+        mvt::ProtoWriter tileMsg;
+        tileMsg.bytesField(3, layer.data());
+        return std::move(tileMsg.data());
+    }
+
+    const MVTOptions& options() const { return options_; }
+
+private:
+    std::vector<uint32_t> encodeRegion(const PolygonWithHoles& pwh,
+                                       const Clipper2Lib::RectD& rect,
+                                       const PolygonUtils::BoundingBox& tb,
+                                       double scale) const {
+        // 外边界逆时针、孔洞顺时针，裁剪后可按面积符号区分
+        using polygon_ops::CoordinateConverter;
+        polygon_ops::ClipperPaths paths;
+        paths.reserve(1 + pwh.holes.size());
+        paths.push_back(CoordinateConverter::toClipperPath(
+            PolygonUtils::ensureOrientation(pwh.outer, true)));
+        for (const auto& hole : pwh.holes) {
+            paths.push_back(CoordinateConverter::toClipperPath(
+                PolygonUtils::ensureOrientation(hole, false)));
+        }
+        polygon_ops::ClipperPaths clipped = Clipper2Lib::RectClip(rect, paths);
+
+        std::vector<mvt::TileRing> exteriors, holes;
+        for (const auto& path : clipped) {
+            mvt::TileRing ring = quantize(path, tb, scale);
+            int64_t a = mvt::ringArea2(ring);
+            if (ring.size() < 3 || a == 0) continue;
+            // y 轴翻转：世界坐标逆时针 -> 瓦片坐标面积为负
+            if (a < 0) {
+                exteriors.push_back(std::move(ring));
+            } else {
+                holes.push_back(std::move(ring));
+            }
+        }
+
+        if (exteriors.empty()) return {};
+
+        // 先为每个孔洞确定所属外环，避免未命中的孔洞被丢弃
+        std::vector<std::vector<size_t>> owned(exteriors.size());
+        for (size_t h = 0; h < holes.size(); h++) {
+            owned[ownerOf(holes[h], exteriors)].push_back(h);
+        }
+
+        std::vector<uint32_t> geometry;
+        int32_t cx = 0, cy = 0;
+        for (size_t e = 0; e < exteriors.size(); e++) {
+            std::reverse(exteriors[e].begin(), exteriors[e].end());   // MVT 外环面积为正
+            appendRing(geometry, exteriors[e], cx, cy);
+            for (size_t h : owned[e]) {
+                std::reverse(holes[h].begin(), holes[h].end());
+                appendRing(geometry, holes[h], cx, cy);
+            }
+        }
+        return geometry;
+    }
+
+    /**
+     * 孔洞所属外环的下标
+     *
+     * 依次尝试各非裁剪边顶点的包含测试（孔洞顶点可能落在外环边界上）；
+     * 都不命中时（量化后顶点全部贴边）退回到包围盒重叠面积最大的外环。
+     */
+    size_t ownerOf(const mvt::TileRing& hole, const std::vector<mvt::TileRing>& exteriors) const {
+        // 单个外环时无需判断包含关系
+        if (exteriors.size() == 1) return 0;
+
+        int32_t lo = -static_cast<int32_t>(options_.buffer);
+        int32_t hi = static_cast<int32_t>(options_.extent + options_.buffer);
+        for (const auto& p : hole) {
+            if (p.x == lo || p.x == hi || p.y == lo || p.y == hi) continue;
+            for (size_t e = 0; e < exteriors.size(); e++) {
+                if (mvt::pointInRing(p, exteriors[e])) return e;
+            }
+        }
+
+        auto bounds = [](const mvt::TileRing& ring) {
+            PolygonUtils::BoundingBox b{double(ring[0].x), double(ring[0].y),
+                                        double(ring[0].x), double(ring[0].y)};
+            for (const auto& p : ring) {
+                b.minX = std::min(b.minX, double(p.x));
+                b.minY = std::min(b.minY, double(p.y));
+                b.maxX = std::max(b.maxX, double(p.x));
+                b.maxY = std::max(b.maxY, double(p.y));
+            }
+            return b;
+        };
+        PolygonUtils::BoundingBox hb = bounds(hole);
+        size_t best = 0;
+        double bestOverlap = -1;
+        for (size_t e = 0; e < exteriors.size(); e++) {
+            PolygonUtils::BoundingBox eb = bounds(exteriors[e]);
+            double w = std::min(hb.maxX, eb.maxX) - std::max(hb.minX, eb.minX);
+            double h = std::min(hb.maxY, eb.maxY) - std::max(hb.minY, eb.minY);
+            double overlap = (w < 0 || h < 0) ? 0 : w * h;
+            if (overlap > bestOverlap) {
+                bestOverlap = overlap;
+                best = e;
+            }
+        }
+        return best;
+    }
+
+    mvt::TileRing quantize(const polygon_ops::ClipperPath& path,
+                           const PolygonUtils::BoundingBox& tb, double scale) const {
+        mvt::TileRing ring;
+        ring.reserve(path.size());
+        for (const auto& p : path) {
+            mvt::TilePoint tp{
+                static_cast<int32_t>(std::lround((p.x - tb.minX) * scale)),
+                static_cast<int32_t>(std::lround((tb.maxY - p.y) * scale))
+            };
+            if (!ring.empty() && ring.back().x == tp.x && ring.back().y == tp.y) continue;
+            ring.push_back(tp);
+        }
+        while (ring.size() > 1 && ring.front().x == ring.back().x &&
+               ring.front().y == ring.back().y) {
+            ring.pop_back();
+        }
+        return ring;
+    }
+
+    static void appendRing(std::vector<uint32_t>& geometry, const mvt::TileRing& ring,
+                           int32_t& cx, int32_t& cy) {
+        geometry.push_back(mvt::command(mvt::kMoveTo, 1));
+        geometry.push_back(mvt::ProtoWriter::zigzag(ring[0].x - cx));
+        geometry.push_back(mvt::ProtoWriter::zigzag(ring[0].y - cy));
+        cx = ring[0].x;
+        cy = ring[0].y;
+
+        geometry.push_back(mvt::command(mvt::kLineTo, static_cast<uint32_t>(ring.size() - 1)));
+        for (size_t i = 1; i < ring.size(); i++) {
+            geometry.push_back(mvt::ProtoWriter::zigzag(ring[i].x - cx));
+            geometry.push_back(mvt::ProtoWriter::zigzag(ring[i].y - cy));
+            cx = ring[i].x;
+            cy = ring[i].y;
+        }
+        geometry.push_back(mvt::command(mvt::kClosePath, 1));
+    }
+
+    MVTOptions options_;
+};
+
+// ============================================================================
+// 瓦片输出
+// ============================================================================
+
+/**
+ * 瓦片输出回调：由工作线程并发调用，实现需自行保证线程安全
+ */
+using TileSink = std::function<void(const TileId& tile, const std::string& data)>;
+
+/**
+ * 写入目录 <root>/<z>/<x>/<y>.mvt
+ */
+class DirectoryTileWriter {
+public:
+    explicit DirectoryTileWriter(std::string root) : root_(std::move(root)) {}
+
+    void operator()(const TileId& t, const std::string& data) const {
+        namespace fs = std::filesystem;
+        fs::path dir = fs::path(root_) / std::to_string(t.z) / std::to_string(t.x);
+        fs::create_directories(dir);
+        fs::path file = dir / (std::to_string(t.y) + ".mvt");
+
+        std::FILE* f = std::fopen(file.string().c_str(), "wb");
+        if (!f) throw std::runtime_error("DirectoryTileWriter: cannot open " + file.string());
+        bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+        ok = (std::fclose(f) == 0) && ok;
+        if (!ok) throw std::runtime_error("DirectoryTileWriter: write failed " + file.string());
+    }
+
+private:
+    std::string root_;
+};
+
+/**
+ * 单文件瓦片包（MBTiles 风格的单文件分发，但无 SQLite 依赖）
+ *
+ * 布局（小端）:
+ *   "RCTILES1"                           8 字节魔数
+ *   tile data ...                        各瓦片数据顺序排列
+ *   index[count]: z u8, x u32, y u32, offset u64, length u32
+ *   footer: indexOffset u64, count u32, "RCTILEND"
+ */
+class TileArchiveWriter {
+public:
+    explicit TileArchiveWriter(const std::string& path)
+        : file_(std::fopen(path.c_str(), "wb")) {
+        if (!file_) throw std::runtime_error("TileArchiveWriter: cannot open " + path);
+        writeRaw("RCTILES1", 8);
+    }
+
+    TileArchiveWriter(const TileArchiveWriter&) = delete;
+    TileArchiveWriter& operator=(const TileArchiveWriter&) = delete;
+
+    ~TileArchiveWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void operator()(const TileId& t, const std::string& data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) throw std::runtime_error("TileArchiveWriter: already closed");
+        index_.push_back({t, offset_, static_cast<uint32_t>(data.size())});
+        writeRaw(data.data(), data.size());
+    }
+
+    TileSink sink() {
+        return [this](const TileId& t, const std::string& data) { (*this)(t, data); };
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) return;
+
+        uint64_t indexOffset = offset_;
+        for (const auto& e : index_) {
+            writeLE<uint8_t>(static_cast<uint8_t>(e.tile.z));
+            writeLE<uint32_t>(e.tile.x);
+            writeLE<uint32_t>(e.tile.y);
+            writeLE<uint64_t>(e.offset);
+            writeLE<uint32_t>(e.length);
+        }
+        writeLE<uint64_t>(indexOffset);
+        writeLE<uint32_t>(static_cast<uint32_t>(index_.size()));
+        writeRaw("RCTILEND", 8);
+
+        bool ok = std::fclose(file_) == 0;
+        file_ = nullptr;
+        if (!ok) throw std::runtime_error("TileArchiveWriter: close failed");
+    }
+
+    size_t tileCount() const { return index_.size(); }
+
+private:
+    struct Entry {
+        TileId tile;
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    template <typename T>
+    void writeLE(T v) {
+        unsigned char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = static_cast<unsigned char>(static_cast<uint64_t>(v) >> (8 * i));
+        }
+        writeRaw(bytes, sizeof(T));
+    }
+
+    void writeRaw(const void* data, size_t size) {
+        if (std::fwrite(data, 1, size, file_) != size) {
+            throw std::runtime_error("TileArchiveWriter: write failed");
+        }
+        offset_ += size;
+    }
+
+    std::FILE* file_;
+    std::mutex mutex_;
+    std::vector<Entry> index_;
+    uint64_t offset_ = 0;
+};
+
+// ============================================================================
+// 金字塔生成
+// ============================================================================
+
+struct TilePyramidStats {
+    size_t tilesVisited = 0;    // 与数据包围盒相交的瓦片数
+    size_t tilesWritten = 0;    // 含要素的瓦片数
+    uint64_t bytesWritten = 0;
+};
+
+/**
+ * 为 [minZoom, maxZoom] 生成瓦片金字塔
+ *
+ * 仅遍历与数据包围盒相交的瓦片；每个瓦片仅处理包围盒与之相交的区域。
+ * 各瓦片在线程池中并行编码，非空瓦片交给 sink。
+ */
+inline TilePyramidStats generateTilePyramid(const MultiPolygon& mp, const TileGrid& grid,
+                                            const MVTOptions& options, const TileSink& sink) {
+    RADAR_COVERAGE_TRACE_SCOPE("generateTilePyramid", "export");
+    TilePyramidStats stats;
+    if (mp.empty()) return stats;
+
+    std::vector<PolygonUtils::BoundingBox> boxes;
+    boxes.reserve(mp.size());
+    PolygonUtils::BoundingBox all = PolygonUtils::boundingBox(mp[0].outer);
+    for (const auto& pwh : mp) {
+        boxes.push_back(PolygonUtils::boundingBox(pwh.outer));
+        all.minX = std::min(all.minX, boxes.back().minX);
+        all.minY = std::min(all.minY, boxes.back().minY);
+        all.maxX = std::max(all.maxX, boxes.back().maxX);
+        all.maxY = std::max(all.maxY, boxes.back().maxY);
+    }
+
+    std::vector<TileId> tiles;
+    for (uint32_t z = options.minZoom; z <= options.maxZoom; z++) {
+        double ts = grid.tileSize(z);
+        double margin = ts * options.buffer / options.extent;
+        int64_t last = (int64_t(1) << z) - 1;
+        auto clampIdx = [last](double v) {
+            return std::max<int64_t>(0, std::min<int64_t>(last, static_cast<int64_t>(std::floor(v))));
+        };
+        int64_t x0 = clampIdx((all.minX - margin - grid.minX) / ts);
+        int64_t x1 = clampIdx((all.maxX + margin - grid.minX) / ts);
+        int64_t y0 = clampIdx((grid.minY + grid.size - all.maxY - margin) / ts);
+        int64_t y1 = clampIdx((grid.minY + grid.size - all.minY + margin) / ts);
+        for (int64_t x = x0; x <= x1; x++) {
+            for (int64_t y = y0; y <= y1; y++) {
+                tiles.push_back({z, static_cast<uint32_t>(x), static_cast<uint32_t>(y)});
+            }
+        }
+    }
+    stats.tilesVisited = tiles.size();
+
+    MVTEncoder encoder(options);
+    std::atomic<size_t> written{0};
+    std::atomic<uint64_t> bytes{0};
+
+    polygon_ops::parallelFor(tiles.size(), options.numThreads, [&](size_t i, size_t) {
+        const TileId& t = tiles[i];
+        PolygonUtils::BoundingBox tb = grid.tileBounds(t);
+        double margin = grid.tileSize(t.z) * options.buffer / options.extent;
+
+        std::vector<size_t> candidates;
+        for (size_t r = 0; r < boxes.size(); r++) {
+            const auto& b = boxes[r];
+            if (b.maxX >= tb.minX - margin && b.minX <= tb.maxX + margin &&
+                b.maxY >= tb.minY - margin && b.minY <= tb.maxY + margin) {
+                candidates.push_back(r);
+            }
+        }
+        if (candidates.empty()) return;
+
+        std::string data = encoder.encodeTile(mp, grid, t, &candidates);
+        if (data.empty()) return;
+
+        sink(t, data);
+        written.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(data.size(), std::memory_order_relaxed);
+    });
+
+    stats.tilesWritten = written.load();
+    stats.bytesWritten = bytes.load();
+    return stats;
+}
+
+} // namespace radar_coverage
@@ -0,0 +1,113 @@
+/**
+ * parallel_for.hpp
+ *
+ * 轻量级并行循环工具 - 基于 std::thread 的动态任务分发
+ *
+ * 依赖: 无 (仅标准库, 需链接 pthread)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace polygon_ops {
+
+/**
+ * 可用硬件线程数（至少为 1）
+ */
+inline size_t hardwareThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? static_cast<size_t>(n) : 1;
+}
+
+/**
+ * 并行执行 fn(index, worker)，index ∈ [0, count)
+ *
+ * 任务按 grain 大小分块，由各工作线程通过原子计数器动态领取，
+ * 因此各任务耗时不均时也能保持负载均衡。
+ * worker ∈ [0, 实际线程数)，可用于索引每线程的累加器。
+ *
+ * @param count      任务数量
+ * @param numThreads 线程数（0 = 硬件线程数）
+ * @param fn         任务函数 void(size_t index, size_t worker)
+ * @param grain      每次领取的任务数
+ * @return 实际使用的线程数
+ *
+ * 任一任务抛出异常时，其余线程尽快停止领取，异常在调用线程重新抛出。
+ * 无法再创建线程时不报错，由已启动的线程与调用线程分完全部任务。
+ */
+template <typename Fn>
+size_t parallelFor(size_t count, size_t numThreads, Fn&& fn, size_t grain = 1) {
+    if (count == 0) return 0;
+    if (numThreads == 0) numThreads = hardwareThreads();
+    if (grain == 0) grain = 1;
+
+    size_t chunks = (count + grain - 1) / grain;
+    size_t workers = std::min(numThreads, chunks);
+
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            fn(i, size_t(0));
+        }
+        return 1;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto body = [&](size_t worker) {
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+            if (begin >= count) break;
+            size_t end = std::min(count, begin + grain);
+            try {
+                for (size_t i = begin; i < end; i++) {
+                    fn(i, worker);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // 任何路径离开本函数前都汇合已启动的线程（未汇合的 std::thread 析构会 terminate）
+    struct JoinGuard {
+        std::vector<std::thread>& threads;
+        ~JoinGuard() {
+            for (auto& t : threads) {
+                if (t.joinable()) t.join();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    JoinGuard guard{threads};
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; w++) {
+        try {
+            threads.emplace_back(body, w);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    body(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (error) std::rethrow_exception(error);
+    return threads.size() + 1;
+}
+
+} // namespace polygon_ops
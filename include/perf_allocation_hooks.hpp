@@ -0,0 +1,44 @@
+/**
+ * perf_allocation_hooks.hpp
+ *
+ * 替换全局 operator new/delete，把堆分配次数与字节数计入当前 PerfStats 接收者
+ *
+ * 只能在程序的一个翻译单元中包含（通常是 main 所在文件）；
+ * RADAR_COVERAGE_PERF_STATS=0 时不做任何替换。
+ *
+ * 依赖: perf_stats.hpp
+ */
+
+#pragma once
+
+#include "perf_stats.hpp"
+
+#if RADAR_COVERAGE_PERF_STATS
+#include <cstdlib>
+#include <new>
+
+// operator delete 用 free 释放本文件 operator new 中 malloc 的内存，并非不匹配
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    if (polygon_ops::PerfStats* sink = polygon_ops::perfSink()) {
+        sink->allocations++;
+        sink->allocatedBytes += size;
+    }
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#endif
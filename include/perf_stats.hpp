@@ -0,0 +1,148 @@
+/**
+ * perf_stats.hpp
+ *
+ * 热点操作计数器与阶段计时器（可在编译期整体移除）
+ *
+ * 计数写入当前线程的"接收者"（PerfSinkScope 安装）；未安装时每次计数只是一次
+ * thread_local 指针判空。定义 RADAR_COVERAGE_PERF_STATS=0 后所有宏展开为空，
+ * PerfStats 字段保持为 0。
+ *
+ * 堆分配计数需要替换全局 operator new/delete，见 perf_allocation_hooks.hpp。
+ *
+ * 依赖: 无
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef RADAR_COVERAGE_PERF_STATS
+#define RADAR_COVERAGE_PERF_STATS 1
+#endif
+
+namespace polygon_ops {
+
+// ============================================================================
+// 统计数据
+// ============================================================================
+
+struct PerfStats {
+    static constexpr bool enabled = RADAR_COVERAGE_PERF_STATS != 0;
+
+    // 地形采样
+    uint64_t elevationEvaluations = 0;   // getElevation 调用次数
+    uint64_t losChecks = 0;              // isLineOfSightBlocked 调用次数
+    uint64_t raysCast = 0;               // computeMaxVisibleRange 调用次数
+    uint64_t bisectionIterations = 0;    // 二分搜索迭代次数
+    uint64_t warmStartHits = 0;          // 热启动区间验证命中
+    uint64_t warmStartMisses = 0;        // 热启动未命中（回退到单侧搜索）
+
+    // 布尔运算
+    uint64_t clipperInputVertices = 0;
+    uint64_t clipperOutputVertices = 0;
+
+    // 堆分配（需包含 perf_allocation_hooks.hpp）
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+
+    // updateIfDirty 各阶段耗时 (毫秒，累计)
+    uint64_t updates = 0;
+    double generateMs = 0.0;
+    double unionMs = 0.0;
+    double simplifyMs = 0.0;
+    double smoothMs = 0.0;
+    double updateMs = 0.0;
+
+    void merge(const PerfStats& o) {
+        elevationEvaluations += o.elevationEvaluations;
+        losChecks += o.losChecks;
+        raysCast += o.raysCast;
+        bisectionIterations += o.bisectionIterations;
+        warmStartHits += o.warmStartHits;
+        warmStartMisses += o.warmStartMisses;
+        clipperInputVertices += o.clipperInputVertices;
+        clipperOutputVertices += o.clipperOutputVertices;
+        allocations += o.allocations;
+        allocatedBytes += o.allocatedBytes;
+        updates += o.updates;
+        generateMs += o.generateMs;
+        unionMs += o.unionMs;
+        simplifyMs += o.simplifyMs;
+        smoothMs += o.smoothMs;
+        updateMs += o.updateMs;
+    }
+};
+
+// ============================================================================
+// 线程局部接收者
+// ============================================================================
+
+inline PerfStats*& perfSink() {
+    static thread_local PerfStats* sink = nullptr;
+    return sink;
+}
+
+/**
+ * 在作用域内把当前线程的计数重定向到 stats（可嵌套，析构时恢复）
+ *
+ * 并行任务中每个工作线程需安装自己的 PerfStats，结束后再 merge，避免共享写。
+ */
+class PerfSinkScope {
+public:
+    explicit PerfSinkScope(PerfStats* stats) : previous_(perfSink()) { perfSink() = stats; }
+    ~PerfSinkScope() { perfSink() = previous_; }
+
+    PerfSinkScope(const PerfSinkScope&) = delete;
+    PerfSinkScope& operator=(const PerfSinkScope&) = delete;
+
+private:
+    PerfStats* previous_;
+};
+
+/**
+ * 作用域计时器：析构时把耗时累加到当前接收者的指定字段
+ */
+class PerfTimer {
+public:
+    explicit PerfTimer(double PerfStats::* field)
+        : field_(field), start_(std::chrono::steady_clock::now()) {}
+
+    ~PerfTimer() {
+        if (PerfStats* sink = perfSink()) {
+            sink->*field_ += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start_).count();
+        }
+    }
+
+    PerfTimer(const PerfTimer&) = delete;
+    PerfTimer& operator=(const PerfTimer&) = delete;
+
+private:
+    double PerfStats::* field_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace polygon_ops
+
+// ============================================================================
+// 埋点宏
+// ============================================================================
+
+#define RADAR_COVERAGE_PERF_CONCAT_(a, b) a##b
+#define RADAR_COVERAGE_PERF_CONCAT(a, b) RADAR_COVERAGE_PERF_CONCAT_(a, b)
+
+#if RADAR_COVERAGE_PERF_STATS
+#define RADAR_COVERAGE_PERF_COUNT(field, n)                                 \
+    do {                                                                    \
+        if (::polygon_ops::PerfStats* perfSink_ = ::polygon_ops::perfSink()) \
+            perfSink_->field += (n);                                        \
+    } while (0)
+#define RADAR_COVERAGE_PERF_SCOPE(field)                                    \
+    ::polygon_ops::PerfTimer RADAR_COVERAGE_PERF_CONCAT(perfTimer_, __LINE__)( \
+        &::polygon_ops::PerfStats::field)
+#else
+#define RADAR_COVERAGE_PERF_COUNT(field, n) do {} while (0)
+#define RADAR_COVERAGE_PERF_SCOPE(field) do {} while (0)
+#endif
@@ -23,10 +23,20 @@
 #include <cmath>
 #include <algorithm>
 #include <stdexcept>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 // Clipper2 头文件
 #include "clipper2/clipper.h"
 
+#include "parallel_for.hpp"
+#include "perf_stats.hpp"
+#include "trace_events.hpp"
+
 namespace polygon_ops {
 
 // ============================================================================
@@ -113,6 +123,143 @@ public:
     }
 };
 
+// ============================================================================
+// 几何计算内核 (SIMD)
+// ============================================================================
+
+static_assert(sizeof(Point2D) == 2 * sizeof(double) &&
+              std::is_standard_layout<Point2D>::value,
+              "Point2D must be laid out as interleaved x,y doubles");
+
+/**
+ * 面向连续坐标数组的几何内核
+ *
+ * 输入为交错排列的坐标 [x0, y0, x1, y1, ...]，n 为顶点数，环隐式闭合。
+ * 定义 __AVX2__ 时（如 -mavx2 或 CMake 选项 RADAR_COVERAGE_ENABLE_AVX2）
+ * 每次处理 2~4 个顶点，否则使用无取模的标量循环。
+ * 浮点累加顺序与标量版本不同，结果可能存在末位差异。
+ */
+class GeometryKernels {
+public:
+    struct Bounds {
+        double minX, minY, maxX, maxY;
+    };
+
+    static const double* coords(const Polygon& poly) {
+        return reinterpret_cast<const double*>(poly.data());
+    }
+
+    /**
+     * 带符号面积（鞋带公式）
+     */
+    static double signedArea(const double* xy, size_t n) {
+        if (n < 3) return 0.0;
+
+        double sum = 0.0;
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        // a = [x_i, y_i, x_i+1, y_i+1], b = [x_i+1, y_i+1, x_i+2, y_i+2]
+        // a * swap(b) = [x_i*y_i+1, y_i*x_i+1, x_i+1*y_i+2, y_i+1*x_i+2]
+        __m256d acc = _mm256_setzero_pd();
+        for (; i + 2 < n; i += 2) {
+            __m256d a = _mm256_loadu_pd(xy + 2 * i);
+            __m256d b = _mm256_loadu_pd(xy + 2 * i + 2);
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(a, _mm256_permute_pd(b, 0x5)));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, acc);
+        sum = (lanes[0] - lanes[1]) + (lanes[2] - lanes[3]);
+#endif
+
+        for (; i + 1 < n; i++) {
+            sum += xy[2 * i] * xy[2 * i + 3] - xy[2 * i + 2] * xy[2 * i + 1];
+        }
+        // 闭合边 (n-1 -> 0)
+        sum += xy[2 * (n - 1)] * xy[1] - xy[0] * xy[2 * (n - 1) + 1];
+
+        return sum / 2.0;
+    }
+
+    /**
+     * 闭合环周长
+     */
+    static double perimeter(const double* xy, size_t n) {
+        if (n < 2) return 0.0;
+
+        double perim = 0.0;
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        // 每次处理 4 条边: d1 = 边 i, i+1; d2 = 边 i+2, i+3
+        __m256d acc = _mm256_setzero_pd();
+        for (; i + 4 < n; i += 4) {
+            __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(xy + 2 * i + 2),
+                                       _mm256_loadu_pd(xy + 2 * i));
+            __m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(xy + 2 * i + 6),
+                                       _mm256_loadu_pd(xy + 2 * i + 4));
+            __m256d sq = _mm256_hadd_pd(_mm256_mul_pd(d1, d1),
+                                        _mm256_mul_pd(d2, d2));
+            acc = _mm256_add_pd(acc, _mm256_sqrt_pd(sq));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, acc);
+        perim = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+        for (; i + 1 < n; i++) {
+            double dx = xy[2 * i + 2] - xy[2 * i];
+            double dy = xy[2 * i + 3] - xy[2 * i + 1];
+            perim += std::sqrt(dx * dx + dy * dy);
+        }
+        double dx = xy[0] - xy[2 * (n - 1)];
+        double dy = xy[1] - xy[2 * (n - 1) + 1];
+        perim += std::sqrt(dx * dx + dy * dy);
+
+        return perim;
+    }
+
+    /**
+     * 边界框（空输入返回 max/lowest 哨兵值）
+     */
+    static Bounds boundingBox(const double* xy, size_t n) {
+        Bounds b = {
+            std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::lowest(),
+            std::numeric_limits<double>::lowest()
+        };
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        if (n >= 2) {
+            __m256d vmin = _mm256_set1_pd(std::numeric_limits<double>::max());
+            __m256d vmax = _mm256_set1_pd(std::numeric_limits<double>::lowest());
+            for (; i + 1 < n; i += 2) {
+                __m256d v = _mm256_loadu_pd(xy + 2 * i);
+                vmin = _mm256_min_pd(vmin, v);
+                vmax = _mm256_max_pd(vmax, v);
+            }
+            alignas(32) double lo[4], hi[4];
+            _mm256_store_pd(lo, vmin);
+            _mm256_store_pd(hi, vmax);
+            b.minX = std::min(lo[0], lo[2]);
+            b.minY = std::min(lo[1], lo[3]);
+            b.maxX = std::max(hi[0], hi[2]);
+            b.maxY = std::max(hi[1], hi[3]);
+        }
+#endif
+
+        for (; i < n; i++) {
+            b.minX = std::min(b.minX, xy[2 * i]);
+            b.minY = std::min(b.minY, xy[2 * i + 1]);
+            b.maxX = std::max(b.maxX, xy[2 * i]);
+            b.maxY = std::max(b.maxY, xy[2 * i + 1]);
+        }
+        return b;
+    }
+};
+
 // ============================================================================
 // 多边形工具函数
 // ============================================================================
@@ -125,16 +272,7 @@ public:
      * 负值 = 顺时针（孔洞）
      */
     static double signedArea(const Polygon& poly) {
-        if (poly.size() < 3) return 0.0;
-        
-        double area = 0.0;
-        size_t n = poly.size();
-        for (size_t i = 0; i < n; i++) {
-            size_t j = (i + 1) % n;
-            area += poly[i].x * poly[j].y;
-            area -= poly[j].x * poly[i].y;
-        }
-        return area / 2.0;
+        return GeometryKernels::signedArea(GeometryKernels::coords(poly), poly.size());
     }
     
     static double area(const Polygon& poly) {
@@ -145,15 +283,7 @@ public:
      * 计算多边形周长
      */
     static double perimeter(const Polygon& poly) {
-        if (poly.size() < 2) return 0.0;
-        
-        double perim = 0.0;
-        size_t n = poly.size();
-        for (size_t i = 0; i < n; i++) {
-            size_t j = (i + 1) % n;
-            perim += (poly[j] - poly[i]).length();
-        }
-        return perim;
+        return GeometryKernels::perimeter(GeometryKernels::coords(poly), poly.size());
     }
     
     /**
@@ -206,21 +336,9 @@ public:
     };
     
     static BoundingBox boundingBox(const Polygon& poly) {
-        BoundingBox bbox = {
-            std::numeric_limits<double>::max(),
-            std::numeric_limits<double>::max(),
-            std::numeric_limits<double>::lowest(),
-            std::numeric_limits<double>::lowest()
-        };
-        
-        for (const auto& p : poly) {
-            bbox.minX = std::min(bbox.minX, p.x);
-            bbox.minY = std::min(bbox.minY, p.y);
-            bbox.maxX = std::max(bbox.maxX, p.x);
-            bbox.maxY = std::max(bbox.maxY, p.y);
-        }
-        
-        return bbox;
+        GeometryKernels::Bounds b =
+            GeometryKernels::boundingBox(GeometryKernels::coords(poly), poly.size());
+        return {b.minX, b.minY, b.maxX, b.maxY};
     }
 };
 
@@ -237,6 +355,7 @@ public:
      * @return 合并后的多区域结果（可能包含多个分离区域和孔洞）
      */
     static MultiPolygon unionAll(const std::vector<Polygon>& polygons) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("unionAll", "boolean", "polygons", polygons.size());
         if (polygons.empty()) return {};
         if (polygons.size() == 1) {
             PolygonWithHoles pwh;
@@ -246,6 +365,7 @@ public:
         
         // 转换为 Clipper2 格式
         ClipperPaths subjects = CoordinateConverter::toClipperPaths(polygons);
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, countVertices(subjects));
         
         // 执行并集运算
         ClipperPaths solution;
@@ -259,6 +379,92 @@ public:
         return classifyResult(solution);
     }
     
+    /**
+     * 计算并集，返回未分类的 Clipper2 路径
+     *
+     * 用于缓存一组很少变化的多边形（如静止雷达）的并集，之后用 unionWith 并入其余部分。
+     */
+    static ClipperPaths unionPaths(const std::vector<Polygon>& polygons) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("unionPaths", "boolean", "polygons", polygons.size());
+        if (polygons.empty()) return {};
+
+        ClipperPaths subjects = CoordinateConverter::toClipperPaths(polygons);
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, countVertices(subjects));
+
+        ClipperPaths solution;
+        Clipper2Lib::ClipperD clipper;
+        clipper.AddSubject(subjects);
+        clipper.Execute(Clipper2Lib::ClipType::Union,
+                       Clipper2Lib::FillRule::NonZero,
+                       solution);
+        return solution;
+    }
+
+    /**
+     * 在已合并的路径 base（unionPaths 的结果）上并入 polygons
+     */
+    static MultiPolygon unionWith(const ClipperPaths& base, const std::vector<Polygon>& polygons) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("unionWith", "boolean", "polygons", polygons.size());
+        if (base.empty()) return unionAll(polygons);
+
+        ClipperPaths subjects = CoordinateConverter::toClipperPaths(polygons);
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, countVertices(subjects) + countVertices(base));
+
+        ClipperPaths solution;
+        Clipper2Lib::ClipperD clipper;
+        clipper.AddSubject(base);
+        clipper.AddSubject(subjects);
+        clipper.Execute(Clipper2Lib::ClipType::Union,
+                       Clipper2Lib::FillRule::NonZero,
+                       solution);
+
+        return classifyResult(solution);
+    }
+
+    /**
+     * MultiPolygon 转为 Clipper2 路径：外边界逆时针、孔洞顺时针，NonZero 下孔洞正确镂空
+     */
+    static ClipperPaths toPaths(const MultiPolygon& mp) {
+        ClipperPaths paths;
+        for (const auto& pwh : mp) appendPaths(pwh, paths);
+        return paths;
+    }
+
+    /**
+     * 用轴对齐矩形裁剪 MultiPolygon（RectClip，与顶点数成线性）
+     *
+     * 外边界包围盒与矩形不相交的区域直接跳过，不参与转换。
+     */
+    static ClipperPaths clipToRect(const MultiPolygon& mp, const PolygonUtils::BoundingBox& box) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("clipToRect", "boolean", "regions", mp.size());
+        ClipperPaths paths;
+        for (const auto& pwh : mp) {
+            PolygonUtils::BoundingBox b = PolygonUtils::boundingBox(pwh.outer);
+            if (b.maxX < box.minX || b.minX > box.maxX || b.maxY < box.minY || b.minY > box.maxY) {
+                continue;
+            }
+            appendPaths(pwh, paths);
+        }
+        if (paths.empty()) return paths;
+        Clipper2Lib::RectD rect(box.minX, box.minY, box.maxX, box.maxY);
+        return Clipper2Lib::RectClip(rect, paths);
+    }
+
+    /**
+     * 两组已定向路径的布尔运算，返回未分类的路径
+     */
+    static ClipperPaths combine(Clipper2Lib::ClipType op,
+                                const ClipperPaths& subjects, const ClipperPaths& clips) {
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, countVertices(subjects) + countVertices(clips));
+
+        ClipperPaths solution;
+        Clipper2Lib::ClipperD clipper;
+        clipper.AddSubject(subjects);
+        if (!clips.empty()) clipper.AddClip(clips);
+        clipper.Execute(op, Clipper2Lib::FillRule::NonZero, solution);
+        return solution;
+    }
+
     /**
      * 计算两个多边形的并集
      */
@@ -273,6 +479,7 @@ public:
         ClipperPaths subjects, clips;
         subjects.push_back(CoordinateConverter::toClipperPath(a));
         clips.push_back(CoordinateConverter::toClipperPath(b));
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, a.size() + b.size());
         
         ClipperPaths solution;
         Clipper2Lib::ClipperD clipper;
@@ -292,6 +499,7 @@ public:
         ClipperPaths subjects, clips;
         subjects.push_back(CoordinateConverter::toClipperPath(a));
         clips.push_back(CoordinateConverter::toClipperPath(b));
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, a.size() + b.size());
         
         ClipperPaths solution;
         Clipper2Lib::ClipperD clipper;
@@ -311,6 +519,7 @@ public:
         ClipperPaths subjects, clips;
         subjects.push_back(CoordinateConverter::toClipperPath(a));
         clips.push_back(CoordinateConverter::toClipperPath(b));
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, a.size() + b.size());
         
         ClipperPaths solution;
         Clipper2Lib::ClipperD clipper;
@@ -334,6 +543,7 @@ public:
                                Clipper2Lib::JoinType joinType = Clipper2Lib::JoinType::Round) {
         ClipperPaths input;
         input.push_back(CoordinateConverter::toClipperPath(poly));
+        RADAR_COVERAGE_PERF_COUNT(clipperInputVertices, poly.size());
         
         ClipperPaths solution;
         solution = Clipper2Lib::InflatePaths(input, delta, joinType, 
@@ -342,12 +552,20 @@ public:
         return classifyResult(solution);
     }
 
-private:
+    static size_t countVertices(const ClipperPaths& paths) {
+        size_t n = 0;
+        for (const auto& path : paths) n += path.size();
+        return n;
+    }
+    
     /**
      * 将 Clipper2 结果分类为外边界和孔洞
+     * （公开以便直接处理外部 Clipper2 结果，及单独做基准测试）
      */
     static MultiPolygon classifyResult(const ClipperPaths& paths) {
         if (paths.empty()) return {};
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("classifyResult", "boolean", "paths", paths.size());
+        RADAR_COVERAGE_PERF_COUNT(clipperOutputVertices, countVertices(paths));
         
         // 转换所有路径
         std::vector<Polygon> allPolygons;
@@ -396,6 +614,17 @@ private:
         
         return result;
     }
+
+private:
+    static void appendPaths(const PolygonWithHoles& pwh, ClipperPaths& paths) {
+        if (pwh.outer.size() < 3) return;
+        paths.push_back(CoordinateConverter::toClipperPath(
+            PolygonUtils::ensureOrientation(pwh.outer, true)));
+        for (const auto& hole : pwh.holes) {
+            paths.push_back(CoordinateConverter::toClipperPath(
+                PolygonUtils::ensureOrientation(hole, false)));
+        }
+    }
 };
 
 // ============================================================================
@@ -452,6 +681,7 @@ public:
      * 处理整个 MultiPolygon
      */
     static MultiPolygon simplifyAll(const MultiPolygon& mp, double epsilon) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("simplifyAll", "postprocess", "regions", mp.size());
         MultiPolygon result;
         for (const auto& pwh : mp) {
             PolygonWithHoles simplified;
@@ -465,6 +695,7 @@ public:
     }
     
     static MultiPolygon smoothAll(const MultiPolygon& mp, int iterations) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("smoothAll", "postprocess", "regions", mp.size());
         MultiPolygon result;
         for (const auto& pwh : mp) {
             PolygonWithHoles smoothed;
@@ -509,6 +740,64 @@ struct PolygonStats {
         
         return stats;
     }
+    
+    /**
+     * 并行统计（适用于百万顶点级的大型 MultiPolygon）
+     * 
+     * 以环为任务单元分发到各线程，每线程独立累加后归约，
+     * 因此单个巨大区域内的孔洞也能并行处理。
+     * 顶点总数低于 minParallelVertices 时退化为串行 compute()。
+     * 
+     * @param numThreads 线程数（0 = 硬件线程数）
+     */
+    static PolygonStats computeParallel(const MultiPolygon& mp,
+                                        size_t numThreads = 0,
+                                        size_t minParallelVertices = 65536) {
+        struct Ring {
+            const Polygon* poly;
+            bool hole;
+        };
+        
+        std::vector<Ring> rings;
+        size_t totalVertices = 0;
+        size_t totalHoles = 0;
+        for (const auto& pwh : mp) {
+            rings.push_back({&pwh.outer, false});
+            totalVertices += pwh.outer.size();
+            for (const auto& hole : pwh.holes) {
+                rings.push_back({&hole, true});
+                totalVertices += hole.size();
+            }
+            totalHoles += pwh.holes.size();
+        }
+        
+        if (totalVertices < minParallelVertices) {
+            return compute(mp);
+        }
+        
+        if (numThreads == 0) numThreads = hardwareThreads();
+        
+        struct Partial {
+            double area = 0.0;
+            double perimeter = 0.0;
+            char pad[48];  // 避免伪共享
+        };
+        std::vector<Partial> partials(numThreads);
+        
+        parallelFor(rings.size(), numThreads, [&](size_t i, size_t worker) {
+            const Polygon& ring = *rings[i].poly;
+            double a = PolygonUtils::area(ring);
+            partials[worker].area += rings[i].hole ? -a : a;
+            partials[worker].perimeter += PolygonUtils::perimeter(ring);
+        });
+        
+        PolygonStats stats = {mp.size(), totalHoles, 0.0, 0.0};
+        for (const auto& p : partials) {
+            stats.totalArea += p.area;
+            stats.totalPerimeter += p.perimeter;
+        }
+        return stats;
+    }
 };
 
 } // namespace polygon_ops
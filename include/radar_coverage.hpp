@@ -4,17 +4,28 @@
  * 雷达覆盖区域计算模块
  * 包含地形模型、视线遮挡计算、覆盖多边形生成
  * 
- * 依赖: polygon_boolean.hpp
+ * 依赖: polygon_boolean.hpp, spatial_order.hpp, checksum.hpp
  */
 
 #pragma once
 
 #include "polygon_boolean.hpp"
+#include "stream_writer.hpp"
+#include "spatial_order.hpp"
+#include "checksum.hpp"
 #include <vector>
 #include <cmath>
 #include <string>
 #include <sstream>
 #include <functional>
+#include <cstring>
+#include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <unordered_map>
 
 namespace radar_coverage {
 
@@ -27,6 +38,8 @@ using polygon_ops::PolygonBoolean;
 using polygon_ops::PolygonUtils;
 using polygon_ops::PolygonProcessor;
 using polygon_ops::PolygonStats;
+using polygon_ops::PerfStats;
+using polygon_ops::PerfSinkScope;
 
 // ============================================================================
 // 地形障碍物
@@ -58,33 +71,154 @@ struct TerrainObstacle {
     }
 };
 
+// ============================================================================
+// 射线采样参数（精度 / 速度权衡）
+// ============================================================================
+
+struct SamplingSettings {
+    int losSamples = 40;            // 视线检查沿线采样数
+    double rangeTolerance = 0.01;   // 二分搜索终止容差（占最大距离的比例）
+};
+
 // ============================================================================
 // 地形模型
 // ============================================================================
 
+/**
+ * 自某一版本以来的地形变化：global 为 true 时视为处处变化
+ */
+struct TerrainChangeSet {
+    bool global = false;
+    std::vector<PolygonUtils::BoundingBox> regions;
+    
+    bool empty() const { return !global && regions.empty(); }
+};
+
 class TerrainModel {
 public:
     using ElevationFunction = std::function<double(double, double)>;
+    using BoundingBox = PolygonUtils::BoundingBox;
+    
+    static constexpr size_t kMaxChangeLog = 256;
     
     TerrainModel() : earth_radius_(6371000.0) {}
     
+    void setSamplingSettings(const SamplingSettings& settings) {
+        if (settings.losSamples < 2 || !(settings.rangeTolerance > 0)) {
+            throw std::invalid_argument("SamplingSettings: need losSamples >= 2 and rangeTolerance > 0");
+        }
+        sampling_ = settings;
+        recordChange(true, {0, 0, 0, 0});
+    }
+    
+    const SamplingSettings& getSamplingSettings() const { return sampling_; }
+    
     void addObstacle(const TerrainObstacle& obs) {
         obstacles_.push_back(obs);
+        recordChange(false, footprint(obs));
     }
     
     void addObstacle(Point2D center, double rx, double ry, double height) {
-        obstacles_.push_back({center, rx, ry, height});
+        addObstacle(TerrainObstacle(center, rx, ry, height));
+    }
+    
+    /**
+     * 替换第 index 个障碍（变化区域为新旧两者的范围）
+     */
+    void setObstacle(size_t index, const TerrainObstacle& obs) {
+        recordChange(false, footprint(obstacles_.at(index)));
+        obstacles_[index] = obs;
+        recordChange(false, footprint(obs));
+    }
+    
+    void removeObstacle(size_t index) {
+        recordChange(false, footprint(obstacles_.at(index)));
+        obstacles_.erase(obstacles_.begin() + static_cast<std::ptrdiff_t>(index));
     }
     
     void clearObstacles() {
+        for (const auto& obs : obstacles_) recordChange(false, footprint(obs));
         obstacles_.clear();
     }
     
+    /**
+     * 替换高程函数；未给出变化区域时视为处处变化
+     */
     void setElevationFunction(ElevationFunction func) {
         custom_elevation_ = func;
+        markChangedEverywhere();
+    }
+    
+    void setElevationFunction(ElevationFunction func, const BoundingBox& changedRegion) {
+        custom_elevation_ = func;
+        markChanged(changedRegion);
+    }
+    
+    // ------------------------------------------------------------------------
+    // 版本与变化区域
+    // ------------------------------------------------------------------------
+    
+    /**
+     * 每次修改加一；外部修改了高程函数所引用的数据（如原地编辑 DEM）时调用 markChanged
+     */
+    uint64_t version() const { return version_; }
+    
+    /**
+     * 实例标识（进程内唯一）：构造、拷贝与拷贝赋值时取新值，移动时随内容转移
+     *
+     * 版本号只在同一标识下可比；标识变化（如 manager.terrain() = other）应视为处处变化。
+     */
+    uint64_t epoch() const { return epoch_.id; }
+    
+    /**
+     * 高程来源的版本：替换高程函数或 markChanged 报告外部数据修改时加一
+     *
+     * 障碍与采样参数的变化不计入（它们由 contentChecksum 与采样参数反映）。
+     */
+    uint64_t elevationVersion() const { return elevationVersion_; }
+    
+    void markChanged(const BoundingBox& region) {
+        elevationVersion_++;
+        recordChange(false, region);
+    }
+    
+    void markChangedEverywhere() {
+        elevationVersion_++;
+        recordChange(true, {0, 0, 0, 0});
+    }
+    
+    /**
+     * 版本 sinceVersion 之后的所有变化；早于日志保留范围时返回 global
+     */
+    TerrainChangeSet changesSince(uint64_t sinceVersion) const {
+        TerrainChangeSet set;
+        if (sinceVersion >= version_) return set;
+        if (changeLog_.empty() || changeLog_.front().version > sinceVersion + 1) {
+            set.global = true;
+            return set;
+        }
+        for (const auto& c : changeLog_) {
+            if (c.version <= sinceVersion) continue;
+            if (c.global) {
+                set.global = true;
+                set.regions.clear();
+                return set;
+            }
+            set.regions.push_back(c.region);
+        }
+        return set;
+    }
+    
+    /**
+     * 障碍的影响范围（高斯山峰在椭圆外为 0）
+     */
+    static BoundingBox footprint(const TerrainObstacle& obs) {
+        return {obs.center.x - obs.rx, obs.center.y - obs.ry,
+                obs.center.x + obs.rx, obs.center.y + obs.ry};
     }
     
     double getElevation(double x, double y) const {
+        RADAR_COVERAGE_PERF_COUNT(elevationEvaluations, 1);
         double h = 0.0;
         
         if (custom_elevation_) {
@@ -105,6 +239,7 @@ public:
         double targetHeight = 0.0,
         int numSamples = 40
     ) const {
+        RADAR_COVERAGE_PERF_COUNT(losChecks, 1);
         Point2D delta = targetPos - radarPos;
         double totalDist = delta.length();
         
@@ -140,32 +275,147 @@ public:
         double maxRange,
         double targetHeight = 0.0
     ) const {
+        return computeMaxVisibleRange(radarPos, radarHeight, azimuth, maxRange, sampling_,
+                                      targetHeight);
+    }
+    
+    /**
+     * 使用指定采样参数（如渐进式细化中的粗略首遍），不改变模型自身的设置
+     */
+    double computeMaxVisibleRange(
+        const Point2D& radarPos,
+        double radarHeight,
+        double azimuth,
+        double maxRange,
+        const SamplingSettings& sampling,
+        double targetHeight = 0.0
+    ) const {
+        RADAR_COVERAGE_PERF_COUNT(raysCast, 1);
         Point2D dir(std::cos(azimuth), std::sin(azimuth));
+        return bisectRange(radarPos, radarHeight, dir, 0.0, maxRange, maxRange, targetHeight,
+                           sampling);
+    }
+    
+    /**
+     * 以上一帧的可视距离 hint 为中心热启动
+     *
+     * 先验证区间 [hint - d, hint + d]（d = rangeTolerance * maxRange）：下端可视、
+     * 上端被遮挡（或已到 maxRange）即命中，只需在窄区间内二分；未命中时从已验证的
+     * 一侧继续搜索 [0, hint - d] 或 [hint + d, maxRange]。结果精度与冷启动相同。
+     */
+    double computeMaxVisibleRangeNear(
+        const Point2D& radarPos,
+        double radarHeight,
+        double azimuth,
+        double maxRange,
+        double hint,
+        double targetHeight = 0.0
+    ) const {
+        RADAR_COVERAGE_PERF_COUNT(raysCast, 1);
+        Point2D dir(std::cos(azimuth), std::sin(azimuth));
+        double d = maxRange * sampling_.rangeTolerance;
+        double lo = std::max(0.0, std::min(hint, maxRange) - d);
+        double hi = std::min(maxRange, lo + 2 * d);
         
-        double lo = 0.0, hi = maxRange;
-        
-        while (hi - lo > maxRange * 0.01) {
+        if (lo > 0.0 && isBlockedAt(radarPos, radarHeight, dir, lo, targetHeight, sampling_)) {
+            RADAR_COVERAGE_PERF_COUNT(warmStartMisses, 1);
+            return bisectRange(radarPos, radarHeight, dir, 0.0, lo, maxRange, targetHeight, sampling_);
+        }
+        if (hi < maxRange && !isBlockedAt(radarPos, radarHeight, dir, hi, targetHeight, sampling_)) {
+            RADAR_COVERAGE_PERF_COUNT(warmStartMisses, 1);
+            return bisectRange(radarPos, radarHeight, dir, hi, maxRange, maxRange, targetHeight,
+                               sampling_);
+        }
+        RADAR_COVERAGE_PERF_COUNT(warmStartHits, 1);
+        return bisectRange(radarPos, radarHeight, dir, lo, hi, maxRange, targetHeight, sampling_);
+    }
+    
+    const std::vector<TerrainObstacle>& getObstacles() const {
+        return obstacles_;
+    }
+    
+    double getEarthRadius() const { return earth_radius_; }
+    
+    /**
+     * 障碍与地球半径的内容校验和
+     *
+     * 高程函数无法比较内容，不参与计算；持久缓存需另行加入 DEM 的校验和
+     * （ElevationGrid::checksum、TiledDem::checksum）。
+     */
+    uint64_t contentChecksum() const {
+        Hasher64 h;
+        h.add(earth_radius_);
+        h.add<uint8_t>(custom_elevation_ ? 1 : 0);
+        h.add<uint64_t>(obstacles_.size());
+        for (const auto& obs : obstacles_) {
+            h.add(obs.center.x).add(obs.center.y).add(obs.rx).add(obs.ry).add(obs.height);
+        }
+        return h.digest();
+    }
+
+private:
+    bool isBlockedAt(const Point2D& radarPos, double radarHeight, const Point2D& dir,
+                     double range, double targetHeight, const SamplingSettings& sampling) const {
+        return isLineOfSightBlocked(radarPos, radarHeight, radarPos + dir * range, targetHeight,
+                                    sampling.losSamples);
+    }
+    
+    /**
+     * 在 [lo, hi] 内二分可视边界（lo 可视、hi 被遮挡或为 maxRange），区间 ≤ 容差时返回 lo
+     */
+    double bisectRange(const Point2D& radarPos, double radarHeight, const Point2D& dir,
+                       double lo, double hi, double maxRange, double targetHeight,
+                       const SamplingSettings& sampling) const {
+        while (hi - lo > maxRange * sampling.rangeTolerance) {
+            RADAR_COVERAGE_PERF_COUNT(bisectionIterations, 1);
             double mid = (lo + hi) / 2.0;
-            Point2D target = radarPos + dir * mid;
-            
-            if (isLineOfSightBlocked(radarPos, radarHeight, target, targetHeight)) {
+            if (isBlockedAt(radarPos, radarHeight, dir, mid, targetHeight, sampling)) {
                 hi = mid;
             } else {
                 lo = mid;
             }
         }
-        
         return lo;
     }
     
-    const std::vector<TerrainObstacle>& getObstacles() const {
-        return obstacles_;
+    struct Change {
+        uint64_t version;
+        bool global;
+        BoundingBox region;
+    };
+    
+    struct Epoch {
+        uint64_t id = next();
+        
+        Epoch() = default;
+        Epoch(const Epoch&) : id(next()) {}
+        Epoch(Epoch&& o) noexcept : id(o.id) { o.id = next(); }
+        Epoch& operator=(const Epoch&) { id = next(); return *this; }
+        Epoch& operator=(Epoch&& o) noexcept {
+            id = o.id;
+            o.id = next();
+            return *this;
+        }
+        
+        static uint64_t next() {
+            static std::atomic<uint64_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+    };
+    
+    void recordChange(bool global, const BoundingBox& region) {
+        if (changeLog_.size() == kMaxChangeLog) changeLog_.pop_front();
+        changeLog_.push_back({++version_, global, region});
     }
-
-private:
+    
     std::vector<TerrainObstacle> obstacles_;
     ElevationFunction custom_elevation_;
     double earth_radius_;
+    SamplingSettings sampling_;
+    uint64_t version_ = 0;
+    uint64_t elevationVersion_ = 0;
+    std::deque<Change> changeLog_;
+    Epoch epoch_;
 };
 
 // ============================================================================
@@ -203,26 +453,34 @@ struct RadarParams {
 // 覆盖多边形生成
 // ============================================================================
 
+/**
+ * @param rayRanges 可选的逐射线距离缓存：长度等于 numRays 时作为热启动 hint
+ *                  （computeMaxVisibleRangeNear），结束后写回本次结果；否则冷启动并填充
+ */
 inline Polygon generateCoveragePolygon(
     const RadarParams& radar, 
     const TerrainModel& terrain,
-    int numRays = 72
+    int numRays = 72,
+    std::vector<float>* rayRanges = nullptr
 ) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("generateCoverage", "terrain", "radar", radar.id);
     Polygon polygon;
     polygon.reserve(numRays);
     
+    const bool warm = rayRanges && rayRanges->size() == static_cast<size_t>(numRays);
+    if (rayRanges && !warm) rayRanges->assign(numRays, 0.0f);
+    
     double azimuthSpan = radar.azimuthEnd - radar.azimuthStart;
     double azimuthStep = azimuthSpan / numRays;
     
     for (int i = 0; i < numRays; i++) {
         double azimuth = radar.azimuthStart + i * azimuthStep;
         
-        double range = terrain.computeMaxVisibleRange(
-            radar.position,
-            radar.height,
-            azimuth,
-            radar.range
-        );
+        double range = warm
+            ? terrain.computeMaxVisibleRangeNear(radar.position, radar.height, azimuth,
+                                                 radar.range, (*rayRanges)[i])
+            : terrain.computeMaxVisibleRange(radar.position, radar.height, azimuth, radar.range);
+        if (rayRanges) (*rayRanges)[i] = static_cast<float>(range);
         
         Point2D vertex(
             radar.position.x + range * std::cos(azimuth),
@@ -239,12 +497,353 @@ inline Polygon generateCoveragePolygon(
     return polygon;
 }
 
+// ============================================================================
+// 地平线剖面
+// ============================================================================
+
+/**
+ * 固定站址与天线高度的逐射线地平剖面
+ *
+ * 沿每条射线以固定间距采样 g(s) = (terrain(s) + s²/(4R) - h_r) / s，保存前缀最大值
+ * G(s_k) = max_{j≤k} g(s_j)。距离 D 处高度 h_t 的目标可视当且仅当 D 之前的
+ * G ≤ (h_t - h_r) / D，与 isLineOfSightBlocked 的判据相同（地形高于视线减去曲率修正即遮挡）。
+ * 剖面与量程、目标高度无关：改变这两者只需扫描剖面，不再采样地形。
+ *
+ * 采样间距即可视距离的分辨率，一般取 rangeTolerance * 量程；量程增大时 extend() 续采。
+ * 剖面数据可以直接引用外部内存（如 HorizonStore 的映射文件），extend() 时才复制。
+ */
+class HorizonProfile {
+public:
+    HorizonProfile() = default;
+    
+    HorizonProfile(const HorizonProfile& o) { *this = o; }
+    HorizonProfile(HorizonProfile&&) noexcept = default;
+    HorizonProfile& operator=(HorizonProfile&&) noexcept = default;
+    
+    HorizonProfile& operator=(const HorizonProfile& o) {
+        if (this == &o) return *this;
+        site_ = o.site_;
+        antennaHeight_ = o.antennaHeight_;
+        azimuthStart_ = o.azimuthStart_;
+        azimuthEnd_ = o.azimuthEnd_;
+        numRays_ = o.numRays_;
+        spacing_ = o.spacing_;
+        samples_ = o.samples_;
+        external_ = o.external_;
+        owned_ = o.owned_;
+        maxSlope_ = external_ ? o.maxSlope_ : owned_.data();
+        return *this;
+    }
+    
+    /**
+     * @param reach   剖面长度 (米)
+     * @param spacing 采样间距 (米)
+     */
+    static HorizonProfile compute(const TerrainModel& terrain, const RadarParams& radar, int numRays,
+                                  double reach, double spacing) {
+        if (numRays <= 0 || !(spacing > 0) || !(reach >= 0)) {
+            throw std::invalid_argument("HorizonProfile: need numRays > 0, spacing > 0 and reach >= 0");
+        }
+        HorizonProfile p;
+        p.site_ = radar.position;
+        p.antennaHeight_ = radar.height;
+        p.azimuthStart_ = radar.azimuthStart;
+        p.azimuthEnd_ = radar.azimuthEnd;
+        p.numRays_ = numRays;
+        p.spacing_ = spacing;
+        p.extend(terrain, reach);
+        return p;
+    }
+    
+    /**
+     * 由已有剖面数据构造（numRays * samples 个 float，按射线连续存放）
+     *
+     * @param owner 非空时直接引用 data 并持有 owner 保证其有效；为空时复制 data
+     */
+    static HorizonProfile fromData(Point2D site, double antennaHeight, double azimuthStart,
+                                   double azimuthEnd, int numRays, double spacing, size_t samples,
+                                   const float* data, std::shared_ptr<const void> owner = nullptr) {
+        if (numRays <= 0 || !(spacing > 0)) {
+            throw std::invalid_argument("HorizonProfile: need numRays > 0 and spacing > 0");
+        }
+        HorizonProfile p;
+        p.site_ = site;
+        p.antennaHeight_ = antennaHeight;
+        p.azimuthStart_ = azimuthStart;
+        p.azimuthEnd_ = azimuthEnd;
+        p.numRays_ = numRays;
+        p.spacing_ = spacing;
+        p.samples_ = samples;
+        if (owner) {
+            p.external_ = std::move(owner);
+            p.maxSlope_ = data;
+        } else {
+            p.owned_.assign(data, data + static_cast<size_t>(numRays) * samples);
+            p.maxSlope_ = p.owned_.data();
+        }
+        return p;
+    }
+    
+    /**
+     * 把剖面延长到 reach（已有采样保留）
+     */
+    void extend(const TerrainModel& terrain, double reach) {
+        size_t samples = static_cast<size_t>(std::ceil(reach / spacing_));
+        if (samples <= samples_) return;
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("computeHorizon", "terrain", "samples", samples - samples_);
+        
+        std::vector<float> slopes(static_cast<size_t>(numRays_) * samples);
+        const double curvature = 1.0 / (4.0 * terrain.getEarthRadius());
+        const double azimuthStep = (azimuthEnd_ - azimuthStart_) / numRays_;
+        for (int i = 0; i < numRays_; i++) {
+            double azimuth = azimuthStart_ + i * azimuthStep;
+            Point2D dir(std::cos(azimuth), std::sin(azimuth));
+            float* out = slopes.data() + static_cast<size_t>(i) * samples;
+            const float* old = maxSlope_ + static_cast<size_t>(i) * samples_;
+            std::copy(old, old + samples_, out);
+            
+            double running = samples_ ? old[samples_ - 1] : -std::numeric_limits<double>::infinity();
+            for (size_t k = samples_; k < samples; k++) {
+                double d = (k + 1) * spacing_;
+                Point2D p = site_ + dir * d;
+                double g = (terrain.getElevation(p.x, p.y) + d * d * curvature - antennaHeight_) / d;
+                running = std::max(running, g);
+                // 向上取整：剖面只会高估遮挡，不会把被遮挡处判为可视
+                out[k] = std::nextafter(static_cast<float>(running), std::numeric_limits<float>::max());
+            }
+        }
+        owned_.swap(slopes);
+        external_.reset();
+        maxSlope_ = owned_.data();
+        samples_ = samples;
+    }
+    
+    /**
+     * 第 ray 条射线上 maxRange 以内、高度 targetHeight 的目标连续可视的最远距离
+     */
+    double visibleRange(int ray, double maxRange, double targetHeight = 0.0) const {
+        const float* g = maxSlope_ + static_cast<size_t>(ray) * samples_;
+        const double rise = targetHeight - antennaHeight_;
+        
+        // 目标位于 n * spacing 时，视线经过其前的 n - 1 个采样
+        double last = 0.0;
+        for (size_t n = 1; n * spacing_ <= maxRange; n++) {
+            size_t before = std::min(n - 1, samples_);
+            if (before > 0 && g[before - 1] * (n * spacing_) > rise) return last;
+            last = n * spacing_;
+        }
+        // maxRange 落在两个采样之间
+        if (last < maxRange) {
+            size_t before = std::min(samples_, static_cast<size_t>(std::ceil(maxRange / spacing_)) - 1);
+            if (before > 0 && g[before - 1] * maxRange > rise) return last;
+        }
+        return maxRange;
+    }
+    
+    /**
+     * 与 generateCoveragePolygon 相同形状的覆盖多边形（radar 的站址、高度、方位须与剖面一致）
+     */
+    Polygon coveragePolygon(const RadarParams& radar, double targetHeight = 0.0) const {
+        Polygon polygon;
+        polygon.reserve(numRays_ + 1);
+        const double azimuthStep = (azimuthEnd_ - azimuthStart_) / numRays_;
+        for (int i = 0; i < numRays_; i++) {
+            double azimuth = azimuthStart_ + i * azimuthStep;
+            double range = visibleRange(i, radar.range, targetHeight);
+            polygon.emplace_back(site_.x + range * std::cos(azimuth), site_.y + range * std::sin(azimuth));
+        }
+        if (!radar.isOmnidirectional()) polygon.push_back(site_);
+        return polygon;
+    }
+    
+    /**
+     * 剖面是否对应该雷达的站址、天线高度与射线划分（量程不参与比较）
+     */
+    bool matches(const RadarParams& radar, int numRays) const {
+        return numRays == numRays_ && radar.position.x == site_.x && radar.position.y == site_.y &&
+               radar.height == antennaHeight_ && radar.azimuthStart == azimuthStart_ &&
+               radar.azimuthEnd == azimuthEnd_;
+    }
+    
+    double reach() const { return samples_ * spacing_; }
+    double spacing() const { return spacing_; }
+    int numRays() const { return numRays_; }
+    size_t samplesPerRay() const { return samples_; }
+    Point2D site() const { return site_; }
+    double antennaHeight() const { return antennaHeight_; }
+    double azimuthStart() const { return azimuthStart_; }
+    double azimuthEnd() const { return azimuthEnd_; }
+    const float* data() const { return maxSlope_; }
+    /** 自有内存（引用外部数据时为 0） */
+    size_t memoryBytes() const { return owned_.size() * sizeof(float); }
+    
+private:
+    Point2D site_;
+    double antennaHeight_ = 0.0;
+    double azimuthStart_ = 0.0, azimuthEnd_ = 0.0;
+    int numRays_ = 0;
+    double spacing_ = 1.0;
+    size_t samples_ = 0;
+    std::shared_ptr<const void> external_;   // 引用外部数据时持有其所有者
+    std::vector<float> owned_;
+    const float* maxSlope_ = nullptr;        // numRays * samples_，按射线连续存放
+};
+
+// ============================================================================
+// 覆盖增量
+// ============================================================================
+
+/**
+ * 相邻两次合并结果之间的差异，只在 region 内计算
+ *
+ * region 内 after = (before - lost) ∪ gained；region 外两次结果相同（开启简化时，
+ * 跨越 region 边界的环在区域外可能有不超过简化容差的后处理差异）。
+ */
+struct CoverageDelta {
+    uint64_t fromVersion = 0;       // 基准结果的版本
+    uint64_t toVersion = 0;
+    PolygonUtils::BoundingBox region{0, 0, 0, 0};
+    MultiPolygon gained;            // 新增覆盖
+    MultiPolygon lost;              // 失去的覆盖
+
+    bool empty() const { return gained.empty() && lost.empty(); }
+};
+
+/**
+ * 空包围盒（min > max），可用 expandBox 逐步扩展
+ */
+inline PolygonUtils::BoundingBox emptyBox() {
+    return {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+}
+
+inline bool isEmptyBox(const PolygonUtils::BoundingBox& b) { return b.minX > b.maxX || b.minY > b.maxY; }
+
+inline void expandBox(PolygonUtils::BoundingBox& box, const PolygonUtils::BoundingBox& b) {
+    box.minX = std::min(box.minX, b.minX);
+    box.minY = std::min(box.minY, b.minY);
+    box.maxX = std::max(box.maxX, b.maxX);
+    box.maxY = std::max(box.maxY, b.maxY);
+}
+
+inline PolygonUtils::BoundingBox multiPolygonBounds(const MultiPolygon& mp) {
+    PolygonUtils::BoundingBox box = emptyBox();
+    for (const auto& pwh : mp) expandBox(box, PolygonUtils::boundingBox(pwh.outer));
+    return box;
+}
+
+/**
+ * 在 region 内计算 before -> after 的新增与失去部分
+ *
+ * 两个结果先用 RectClip 裁剪到 region（外包围盒不相交的区域直接跳过），
+ * 再做两次差集，代价与 region 内的顶点数相关而非整个结果。
+ */
+inline CoverageDelta computeCoverageDelta(const MultiPolygon& before, const MultiPolygon& after,
+                                          const PolygonUtils::BoundingBox& region) {
+    RADAR_COVERAGE_TRACE_SCOPE("coverageDelta", "manager");
+    CoverageDelta delta;
+    if (isEmptyBox(region)) return delta;
+    delta.region = region;
+
+    polygon_ops::ClipperPaths a = PolygonBoolean::clipToRect(before, region);
+    polygon_ops::ClipperPaths b = PolygonBoolean::clipToRect(after, region);
+    if (!b.empty()) {
+        delta.gained = PolygonBoolean::classifyResult(
+            PolygonBoolean::combine(Clipper2Lib::ClipType::Difference, b, a));
+    }
+    if (!a.empty()) {
+        delta.lost = PolygonBoolean::classifyResult(
+            PolygonBoolean::combine(Clipper2Lib::ClipType::Difference, a, b));
+    }
+    return delta;
+}
+
 // ============================================================================
 // 覆盖合并管理器
 // ============================================================================
 
+/**
+ * 移动雷达的一次位姿更新（step 的输入）
+ */
+struct RadarPose {
+    int id = 0;
+    Point2D position;
+    double height = 0.0;
+    double azimuthStart = std::numeric_limits<double>::quiet_NaN();  // NaN: 扇区朝向不变
+};
+
+/**
+ * 一次重算的各阶段耗时 (毫秒)
+ */
+struct UpdateTimings {
+    size_t radarsRecomputed = 0;
+    double generateMs = 0.0;
+    double unionMs = 0.0;
+    double simplifyMs = 0.0;
+    double smoothMs = 0.0;
+    double totalMs = 0.0;
+};
+
+/**
+ * step 的返回值；coverage 引用管理器内部结果，下一次修改管理器前有效
+ */
+struct StepResult {
+    const MultiPolygon& coverage;
+    UpdateTimings timings;
+    uint64_t step;
+    double time;                    // 累计仿真时间 (秒)
+};
+
+/**
+ * 渐进式细化参数
+ */
+struct ProgressiveOptions {
+    int initialRays = 12;                               // 首遍每部雷达的射线数
+    SamplingSettings coarseSampling{10, 0.05};          // 首遍使用的粗略视线采样
+    double disagreement = 0.02;                         // 相邻射线距离差超过 该比例 × 量程 时在其间补射
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool>* cancel = nullptr;          // 置为 true 时在下一部雷达前停止
+};
+
+/**
+ * 每一遍细化后发布的结果；coverage 仅在回调期间有效
+ */
+struct ProgressivePass {
+    int pass;                       // 0 为粗略首遍
+    size_t raysCast;                // 本遍实际投射的射线数
+    size_t raysInterpolated;        // 本遍由相邻射线插值得到的射线数
+    bool complete;                  // 所有雷达均已细化到 numRays
+    const MultiPolygon& coverage;
+    UpdateTimings timings;
+};
+
+enum class ProgressiveStatus { Complete, DeadlineReached, Cancelled };
+
 class CoverageMergeManager {
 public:
+    /**
+     * 单雷达覆盖生成器，签名与 generateCoveragePolygon 相同；会被多个线程并发调用
+     */
+    using CoverageGenerator = std::function<Polygon(const RadarParams&, const TerrainModel&, int,
+                                                    std::vector<float>*)>;
+    
+    /**
+     * 重算调度回调：(全部雷达, 本次重算的下标按处理顺序, 射线数)
+     */
+    using ScheduleHook = std::function<void(const std::vector<RadarParams>&, const std::vector<size_t>&, int)>;
+    
+    /**
+     * 地平剖面持久存储（如 horizon_store.hpp）；会被多个线程并发调用
+     *
+     * find(雷达, 射线数, 采样参数, 地形校验和) 返回站址、高度、方位、射线数与采样参数相同的剖面，
+     * 没有时返回空；put(剖面, 采样参数, 地形校验和) 保存新算出或续采后的剖面。
+     */
+    struct HorizonStoreHooks {
+        std::function<std::shared_ptr<const HorizonProfile>(const RadarParams&, int, const SamplingSettings&,
+                                                            uint64_t)> find;
+        std::function<void(std::shared_ptr<const HorizonProfile>, const SamplingSettings&, uint64_t)> put;
+    };
+    
     CoverageMergeManager() 
         : numRays_(72), simplifyEpsilon_(5.0), smoothIterations_(1) {}
     
@@ -253,36 +852,183 @@ public:
     
     void addRadar(const RadarParams& radar) {
         radars_.push_back(radar);
+        radarState_.emplace_back();
+        indexDirty_ = true;
+        staticDirty_ = true;
+        dirty_ = true;
+    }
+    
+    void addRadars(const std::vector<RadarParams>& radars) {
+        radars_.insert(radars_.end(), radars.begin(), radars.end());
+        radarState_.resize(radars_.size());
+        indexDirty_ = true;
+        staticDirty_ = true;
         dirty_ = true;
     }
     
     void updateRadar(int id, const RadarParams& params) {
-        for (auto& r : radars_) {
-            if (r.id == id) {
-                r = params;
-                dirty_ = true;
-                break;
-            }
-        }
+        size_t i = radarIndex(id);
+        if (i == kNoRadar) return;
+        radars_[i] = params;
+        std::vector<float>().swap(radarState_[i].rayRanges);   // 热启动只用于 step 的连续运动
+        markRadarDirty(i);
+        indexDirty_ = true;
     }
     
     void removeRadar(int id) {
-        radars_.erase(
-            std::remove_if(radars_.begin(), radars_.end(),
-                [id](const RadarParams& r) { return r.id == id; }),
-            radars_.end()
-        );
+        size_t out = 0;
+        for (size_t i = 0; i < radars_.size(); i++) {
+            if (radars_[i].id == id) {
+                if (i < individualCoverages_.size()) noteChanged(individualCoverages_[i]);
+                continue;
+            }
+            if (out != i) {
+                radars_[out] = std::move(radars_[i]);
+                radarState_[out] = std::move(radarState_[i]);
+                if (i < individualCoverages_.size()) {
+                    individualCoverages_[out] = std::move(individualCoverages_[i]);
+                }
+            }
+            out++;
+        }
+        radars_.resize(out);
+        radarState_.resize(out);
+        if (individualCoverages_.size() > out) individualCoverages_.resize(out);
+        indexDirty_ = true;
+        staticDirty_ = true;
         dirty_ = true;
     }
     
     void clearRadars() {
+        changedEverywhere_ = true;
         radars_.clear();
+        radarState_.clear();
+        individualCoverages_.clear();
+        indexDirty_ = true;
+        staticDirty_ = true;
         dirty_ = true;
     }
     
-    void setNumRays(int n) { numRays_ = n; dirty_ = true; }
-    void setSimplifyEpsilon(double eps) { simplifyEpsilon_ = eps; dirty_ = true; }
-    void setSmoothIterations(int n) { smoothIterations_ = n; dirty_ = true; }
+    void setNumRays(int n) { numRays_ = n; invalidate(); }
+    // 只影响后处理，已生成的单雷达覆盖保留
+    void setSimplifyEpsilon(double eps) { simplifyEpsilon_ = eps; changedEverywhere_ = true; dirty_ = true; }
+    void setSmoothIterations(int n) { smoothIterations_ = n; changedEverywhere_ = true; dirty_ = true; }
+    
+    void setSamplingSettings(const SamplingSettings& settings) {
+        terrain_.setSamplingSettings(settings);
+        invalidate();
+    }
+    
+    /**
+     * 替换单雷达覆盖生成器（如 geodetic.hpp 的逐雷达局部坐标系生成器）；空函数恢复默认
+     *
+     * refineProgressive 不经过生成器，始终在 terrain() 的平面坐标系中投射射线。
+     */
+    void setCoverageGenerator(CoverageGenerator generator) {
+        generator_ = std::move(generator);
+        invalidate();
+    }
+    
+    /**
+     * 重算调度回调：每次重新生成单雷达覆盖前，以即将处理的雷达下标（调度顺序）调用一次，
+     * 供地形预取等提前准备数据（如 dem_prefetch.hpp）；回调应尽快返回
+     */
+    void setScheduleHook(ScheduleHook hook) { scheduleHook_ = std::move(hook); }
+    
+    /**
+     * 覆盖生成的并行线程数（0 = 硬件线程数，1 = 串行）
+     */
+    void setNumThreads(size_t n) { numThreads_ = n; }
+    
+    /**
+     * 移动雷达连续静止多久（仿真秒）后并回静态集合
+     */
+    void setMovingSettleTime(double seconds) { settleTime_ = seconds; }
+    
+    /**
+     * 用上一帧的逐射线距离热启动可视距离搜索（默认开启）
+     *
+     * 每部雷达保留 numRays 个 float；关闭时释放缓存，结果与逐帧冷启动逐位一致。
+     * 视线沿射线不单调，hint 只在 step() 的连续运动之间沿用：invalidate、地形变化与
+     * updateRadar 会丢弃受影响雷达的 hint，使结果不依赖调用历史。
+     */
+    void setWarmStartRays(bool enabled) {
+        warmStart_ = enabled;
+        if (!enabled) {
+            for (auto& s : radarState_) std::vector<float>().swap(s.rayRanges);
+        }
+    }
+    
+    /**
+     * 静止雷达按 (站址, 天线高度) 缓存地平剖面（默认关闭）
+     *
+     * 只改变量程时由剖面直接得出各射线可视距离，不再采样地形；站址、高度、方位、射线数
+     * 或采样参数变化，以及剖面范围内的地形变化时重新计算。剖面采样间距为
+     * rangeTolerance * 量程，结果与二分搜索相差不超过一个间距。量程缩小到建立剖面时的
+     * 1/4 以下时按新量程重建，保持分辨率；量程增大时续采超出部分。
+     */
+    void setHorizonCache(bool enabled) {
+        horizonCache_ = enabled;
+        if (!enabled) {
+            for (auto& s : radarState_) s.horizon.reset();
+        }
+        invalidate();
+    }
+    
+    /**
+     * 地平剖面的持久存储（需同时开启 setHorizonCache）
+     *
+     * 剖面先在存储中按 (站址, 高度, 方位, 射线数, 采样参数, 地形校验和) 查找，找不到才采样地形，
+     * 新算出的剖面写回存储。障碍与采样参数的修改改变键，存储照常使用；存储的 DEM 校验和
+     * 无法反映高程来源的变化，因此挂接后替换高程函数、markChanged 或整体替换地形都使之后的
+     * 剖面绕过存储，应在高程数据设置完成后挂接。
+     * 传入空的 hooks 取消挂接。
+     */
+    void setHorizonStore(HorizonStoreHooks hooks) {
+        horizonStore_ = std::move(hooks);
+        storeElevationVersion_ = terrain_.elevationVersion();
+        storeTerrainEpoch_ = terrain_.epoch();
+        storeChecksum_ = terrain_.contentChecksum();
+    }
+    
+    /**
+     * 记录相邻两次合并结果之间的增量（默认关闭）
+     *
+     * 开启后每次重算前保留上一次的合并结果，并累计本次变化的包围盒：重算雷达的
+     * 新旧覆盖、被删除雷达的覆盖；后处理参数变化或清空雷达时为整个结果范围。
+     * 开启时已有未重算的修改（其范围未被记录）则下一次增量取整个结果范围。
+     */
+    void setDeltaTracking(bool enabled) {
+        deltaTracking_ = enabled;
+        if (!enabled) {
+            MultiPolygon().swap(previousCoverage_);
+            lastDelta_ = CoverageDelta();
+        }
+        previousVersion_ = coverageVersion_;
+        changedRegion_ = emptyBox();
+        changedEverywhere_ = enabled && dirty_;
+        deltaReady_ = false;
+    }
+    
+    int getNumRays() const { return numRays_; }
+    double getSimplifyEpsilon() const { return simplifyEpsilon_; }
+    int getSmoothIterations() const { return smoothIterations_; }
+    const SamplingSettings& getSamplingSettings() const { return terrain_.getSamplingSettings(); }
+    size_t getNumThreads() const { return numThreads_; }
+    double getMovingSettleTime() const { return settleTime_; }
+    bool getWarmStartRays() const { return warmStart_; }
+    bool getHorizonCache() const { return horizonCache_; }
+    
+    /**
+     * 雷达当前的地平剖面；未开启缓存、尚未计算或雷达不存在时为空
+     */
+    std::shared_ptr<const HorizonProfile> getHorizonProfile(int id) {
+        size_t i = radarIndex(id);
+        return i == kNoRadar ? nullptr : radarState_[i].horizon;
+    }
+    bool getDeltaTracking() const { return deltaTracking_; }
+    
+    const std::vector<RadarParams>& getRadars() const { return radars_; }
     
     const std::vector<Polygon>& getIndividualCoverages() {
         updateIfDirty();
@@ -299,42 +1045,610 @@ public:
         return PolygonStats::compute(mergedCoverage_);
     }
     
-    void invalidate() { dirty_ = true; }
+    /**
+     * 合并结果的版本：每次重算加 1（0 = 尚未计算）
+     */
+    uint64_t getCoverageVersion() {
+        updateIfDirty();
+        return coverageVersion_;
+    }
+    
+    /**
+     * 上一次重算相对其前一个结果的增量（需先 setDeltaTracking(true)）
+     *
+     * 首次调用时按变化区域计算并缓存。fromVersion 与客户端持有的版本不一致时
+     * （漏掉了中间的重算）应改为拉取完整结果。未开启跟踪或尚无前一个结果时
+     * fromVersion == toVersion 且增量为空。
+     */
+    const CoverageDelta& getCoverageDelta() {
+        updateIfDirty();
+        if (!deltaReady_) {
+            if (deltaTracking_ && previousVersion_ != coverageVersion_) {
+                lastDelta_ = computeCoverageDelta(previousCoverage_, mergedCoverage_, lastChangedRegion_);
+            } else {
+                lastDelta_ = CoverageDelta();
+            }
+            lastDelta_.fromVersion = deltaTracking_ ? previousVersion_ : coverageVersion_;
+            lastDelta_.toVersion = coverageVersion_;
+            deltaReady_ = true;
+        }
+        return lastDelta_;
+    }
+    
+    /**
+     * 全部重算
+     *
+     * 经 terrain() 的修改会自动按变化区域只重算受影响的雷达；仅当高程函数引用的外部
+     * 数据变化且未调用 TerrainModel::markChanged 时才需要手动调用。缓存的地平剖面与
+     * 热启动 hint 一并丢弃。
+     */
+    void invalidate() {
+        for (auto& s : radarState_) {
+            s.coverageDirty = true;
+            s.horizon.reset();
+            std::vector<float>().swap(s.rayRanges);
+        }
+        staticDirty_ = true;
+        dirty_ = true;
+    }
+    
+    // ------------------------------------------------------------------------
+    // 时间步进（移动雷达）
+    // ------------------------------------------------------------------------
+    
+    /**
+     * 推进一个仿真步：批量应用位姿更新，只重算位姿变化的雷达
+     *
+     * 收到过位姿更新的雷达归入"移动集合"；其余雷达的覆盖并集缓存为 Clipper2 路径，
+     * 每步只把移动雷达的覆盖并入该缓存。移动雷达静止超过 settleTime 后并回静态集合
+     * （触发一次静态并集重建）。位姿与当前值相同的更新不触发重算；未知 id 忽略。
+     */
+    StepResult step(double dt, const std::vector<RadarPose>& poses) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("step", "manager", "poses", poses.size());
+        applyPoses(dt, poses);
+        lastTimings_ = UpdateTimings();
+        updateIfDirty();
+        return {mergedCoverage_, lastTimings_, stepCount_, simTime_};
+    }
+    
+    /**
+     * step 的前半部分：只记录位姿与仿真时间，不重算（供批量合并多个步进后再统一更新）
+     */
+    void applyPoses(double dt, const std::vector<RadarPose>& poses) {
+        stepCount_++;
+        simTime_ += dt;
+        
+        for (const auto& pose : poses) {
+            size_t i = radarIndex(pose.id);
+            if (i == kNoRadar) continue;
+            
+            RadarParams& r = radars_[i];
+            RadarState& s = radarState_[i];
+            double azimuthStart = std::isnan(pose.azimuthStart) ? r.azimuthStart : pose.azimuthStart;
+            if (r.position.x == pose.position.x && r.position.y == pose.position.y &&
+                r.height == pose.height && r.azimuthStart == azimuthStart) {
+                continue;
+            }
+            
+            if (!s.moving) {
+                s.moving = true;
+                staticDirty_ = true;
+            }
+            s.lastMovedStep = stepCount_;
+            s.idleTime = 0.0;
+            r.azimuthEnd += azimuthStart - r.azimuthStart;
+            r.azimuthStart = azimuthStart;
+            r.position = pose.position;
+            r.height = pose.height;
+            s.coverageDirty = true;
+            dirty_ = true;
+        }
+        
+        // 静止足够久的移动雷达并回静态集合
+        for (auto& s : radarState_) {
+            if (!s.moving || s.lastMovedStep == stepCount_) continue;
+            s.idleTime += dt;
+            if (s.idleTime >= settleTime_) {
+                s.moving = false;
+                staticDirty_ = true;
+                dirty_ = true;
+            }
+        }
+    }
+    
+    uint64_t getStepCount() const { return stepCount_; }
+    double getSimTime() const { return simTime_; }
+    
+    // ------------------------------------------------------------------------
+    // 渐进式细化
+    // ------------------------------------------------------------------------
+    
+    /**
+     * 由粗到细计算合并覆盖，每一遍结束后通过 publish 发布
+     *
+     * 第 0 遍每部雷达只投射约 initialRays 条射线，并使用 coarseSampling；之后每遍先用
+     * 正式采样参数重投粗略射线（以粗略结果热启动），再把相邻已知射线之间的间隔减半：
+     * 两侧距离相差超过 disagreement × 量程 的中点重新投射，其余取两侧均值。
+     * 所有间隔为 1 时完成（射线方位与 numRays 的常规结果一致）。
+     *
+     * 截止时间或取消标志在每部雷达开始前检查；中断的一遍仍发布已完成的部分后返回。
+     * 不修改管理器的覆盖缓存，之后调用 getMergedCoverage() 仍得到完整精度结果。
+     */
+    ProgressiveStatus refineProgressive(const ProgressiveOptions& options,
+                                        const std::function<void(const ProgressivePass&)>& publish) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("refineProgressive", "manager", "radars", radars_.size());
+        PerfSinkScope perfScope(&perfStats_);
+        
+        using Clock = std::chrono::steady_clock;
+        const int n = numRays_;
+        const size_t count = radars_.size();
+        const size_t stride = static_cast<size_t>(std::max(1, n / std::max(1, options.initialRays)));
+        
+        enum : uint8_t { kUnknown, kCoarse, kInterpolated, kExact };
+        struct Rays {
+            std::vector<float> range;
+            std::vector<uint8_t> state;
+        };
+        std::vector<Rays> rays(count);
+        
+        auto stopReason = [&options]() -> int {
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return 2;
+            if (Clock::now() >= options.deadline) return 1;
+            return 0;
+        };
+        auto azimuthOf = [n](const RadarParams& r, size_t i) {
+            return r.azimuthStart + static_cast<double>(i) * (r.azimuthEnd - r.azimuthStart) / n;
+        };
+        
+        for (int pass = 0;; pass++) {
+            Clock::time_point start = Clock::now();
+            std::atomic<int> stop{0};
+            std::atomic<size_t> cast{0}, interpolated{0}, touched{0};
+            bool complete = true;
+            std::vector<uint8_t> radarComplete(count, 1);
+            
+            parallelOverRadars(count, [&](size_t k) {
+                if (stop.load(std::memory_order_relaxed)) return;
+                if (int reason = stopReason()) {
+                    stop.store(reason, std::memory_order_relaxed);
+                    return;
+                }
+                const RadarParams& radar = radars_[k];
+                Rays& r = rays[k];
+                size_t castHere = 0, interpHere = 0;
+                
+                if (pass == 0) {
+                    r.range.assign(n, 0.0f);
+                    r.state.assign(n, kUnknown);
+                    for (size_t i = 0; i < static_cast<size_t>(n); i += stride) r.state[i] = kCoarse;
+                    if (!radar.isOmnidirectional()) r.state[n - 1] = kCoarse;
+                    for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                        if (r.state[i] != kCoarse) continue;
+                        r.range[i] = static_cast<float>(terrain_.computeMaxVisibleRange(
+                            radar.position, radar.height, azimuthOf(radar, i), radar.range,
+                            options.coarseSampling));
+                        castHere++;
+                    }
+                } else {
+                    // 粗略射线用正式采样重投
+                    for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                        if (r.state[i] != kCoarse) continue;
+                        r.range[i] = static_cast<float>(terrain_.computeMaxVisibleRangeNear(
+                            radar.position, radar.height, azimuthOf(radar, i), radar.range,
+                            r.range[i]));
+                        r.state[i] = kExact;
+                        castHere++;
+                    }
+                    
+                    // 相邻已知射线之间取中点（全向雷达首尾相接）
+                    std::vector<size_t> known;
+                    for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                        if (r.state[i] != kUnknown) known.push_back(i);
+                    }
+                    size_t pairs = radar.isOmnidirectional() ? known.size() : known.size() - 1;
+                    for (size_t j = 0; j < pairs; j++) {
+                        size_t a = known[j];
+                        size_t b = (j + 1 < known.size()) ? known[j + 1] : known[0] + n;
+                        if (b - a < 2) continue;
+                        size_t mid = ((a + b) / 2) % n;
+                        double ra = r.range[a];
+                        double rb = r.range[b % n];
+                        if (std::abs(ra - rb) > options.disagreement * radar.range) {
+                            r.range[mid] = static_cast<float>(terrain_.computeMaxVisibleRange(
+                                radar.position, radar.height, azimuthOf(radar, mid), radar.range));
+                            r.state[mid] = kExact;
+                            castHere++;
+                        } else {
+                            r.range[mid] = static_cast<float>(0.5 * (ra + rb));
+                            r.state[mid] = kInterpolated;
+                            interpHere++;
+                        }
+                        if (b - a > 2) radarComplete[k] = 0;      // 减半后仍有间隔 > 1
+                    }
+                }
+                if (pass == 0) radarComplete[k] = 0;        // 粗略射线待重投
+                
+                cast.fetch_add(castHere, std::memory_order_relaxed);
+                interpolated.fetch_add(interpHere, std::memory_order_relaxed);
+                touched.fetch_add(1, std::memory_order_relaxed);
+            });
+            
+            UpdateTimings t;
+            t.radarsRecomputed = touched.load();
+            Clock::time_point lapStart = Clock::now();
+            t.generateMs = std::chrono::duration<double, std::milli>(lapStart - start).count();
+            
+            // 组装多边形并合并
+            std::vector<Polygon> polygons;
+            polygons.reserve(count);
+            for (size_t k = 0; k < count; k++) {
+                if (rays[k].state.empty()) continue;
+                const RadarParams& radar = radars_[k];
+                Polygon poly;
+                for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                    if (rays[k].state[i] == kUnknown) continue;
+                    double az = azimuthOf(radar, i);
+                    poly.emplace_back(radar.position.x + rays[k].range[i] * std::cos(az),
+                                      radar.position.y + rays[k].range[i] * std::sin(az));
+                }
+                if (!radar.isOmnidirectional()) poly.push_back(radar.position);
+                if (poly.size() >= 3) polygons.push_back(std::move(poly));
+            }
+            MultiPolygon merged = PolygonBoolean::unionAll(polygons);
+            t.unionMs = std::chrono::duration<double, std::milli>(Clock::now() - lapStart).count();
+            
+            if (simplifyEpsilon_ > 0) {
+                lapStart = Clock::now();
+                merged = PolygonProcessor::simplifyAll(merged, simplifyEpsilon_);
+                t.simplifyMs = std::chrono::duration<double, std::milli>(Clock::now() - lapStart).count();
+            }
+            if (smoothIterations_ > 0) {
+                lapStart = Clock::now();
+                merged = PolygonProcessor::smoothAll(merged, smoothIterations_);
+                t.smoothMs = std::chrono::duration<double, std::milli>(Clock::now() - lapStart).count();
+            }
+            t.totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            
+            int reason = stop.load();
+            for (size_t k = 0; k < count && complete; k++) {
+                complete = radarComplete[k] && !rays[k].state.empty();
+            }
+            complete = complete && reason == 0;
+            
+            if (publish) {
+                publish({pass, cast.load(), interpolated.load(), complete, merged, t});
+            }
+            if (complete) return ProgressiveStatus::Complete;
+            if (reason == 2) return ProgressiveStatus::Cancelled;
+            if (reason == 1) return ProgressiveStatus::DeadlineReached;
+        }
+    }
+    
+    /**
+     * 最近一次重算的各阶段耗时（未重算时全为 0）
+     */
+    const UpdateTimings& getLastUpdateTimings() const { return lastTimings_; }
+    
+    size_t getMovingRadarCount() const {
+        size_t n = 0;
+        for (const auto& s : radarState_) n += s.moving ? 1 : 0;
+        return n;
+    }
+    
+    /**
+     * 累计的热点计数与阶段耗时（RADAR_COVERAGE_PERF_STATS=0 时恒为 0）
+     */
+    const PerfStats& getPerfStats() const { return perfStats_; }
+    
+    void resetPerfStats() { perfStats_ = PerfStats(); }
 
 private:
+    static constexpr size_t kNoRadar = static_cast<size_t>(-1);
+    
+    struct RadarState {
+        bool coverageDirty = true;
+        bool moving = false;
+        uint64_t lastMovedStep = 0;
+        double idleTime = 0.0;
+        std::vector<float> rayRanges;       // 上一次生成的逐射线距离（热启动 hint）
+        std::shared_ptr<const HorizonProfile> horizon;
+    };
+    
+    size_t radarIndex(int id) {
+        if (indexDirty_) {
+            indexById_.clear();
+            for (size_t i = 0; i < radars_.size(); i++) indexById_.emplace(radars_[i].id, i);
+            indexDirty_ = false;
+        }
+        auto it = indexById_.find(id);
+        return it == indexById_.end() ? kNoRadar : it->second;
+    }
+    
+    void noteChanged(const Polygon& coverage) {
+        if (deltaTracking_ && !coverage.empty()) {
+            expandBox(changedRegion_, PolygonUtils::boundingBox(coverage));
+        }
+    }
+    
+    void markRadarDirty(size_t i) {
+        radarState_[i].coverageDirty = true;
+        if (!radarState_[i].moving) staticDirty_ = true;
+        dirty_ = true;
+    }
+    
+    /**
+     * 并行重新生成 coverageDirty 的雷达覆盖
+     */
+    size_t regenerateDirtyCoverages() {
+        individualCoverages_.resize(radars_.size());
+        
+        std::vector<size_t> dirty;
+        for (size_t i = 0; i < radars_.size(); i++) {
+            if (radarState_[i].coverageDirty) dirty.push_back(i);
+        }
+        if (dirty.empty()) return 0;
+        
+        // 按站址的 Hilbert 序分派：相邻任务读取相邻地形，分块 DEM 的瓦片在淘汰前被复用
+        if (dirty.size() > 2) {
+            std::vector<Point2D> sites;
+            sites.reserve(dirty.size());
+            for (size_t i : dirty) sites.push_back(radars_[i].position);
+            std::vector<size_t> order = hilbertOrder(sites);
+            std::vector<size_t> sorted;
+            sorted.reserve(dirty.size());
+            for (size_t k : order) sorted.push_back(dirty[k]);
+            dirty.swap(sorted);
+        }
+        
+        if (deltaTracking_) {
+            for (size_t i : dirty) noteChanged(individualCoverages_[i]);
+        }
+        if (scheduleHook_) scheduleHook_(radars_, dirty, numRays_);
+        parallelOverRadars(dirty.size(), [&](size_t k) {
+            size_t i = dirty[k];
+            std::vector<float>* rayRanges = warmStart_ ? &radarState_[i].rayRanges : nullptr;
+            if (generator_) {
+                individualCoverages_[i] = generator_(radars_[i], terrain_, numRays_, rayRanges);
+            } else if (horizonCache_ && !radarState_[i].moving) {
+                individualCoverages_[i] = horizonCoverage(i);
+            } else {
+                individualCoverages_[i] = generateCoveragePolygon(radars_[i], terrain_, numRays_, rayRanges);
+            }
+        });
+        for (size_t i : dirty) {
+            radarState_[i].coverageDirty = false;
+            if (deltaTracking_) noteChanged(individualCoverages_[i]);
+        }
+        return dirty.size();
+    }
+    
+    /**
+     * 由缓存的地平剖面生成覆盖；剖面不匹配时重建，量程超出时续采
+     */
+    Polygon horizonCoverage(size_t i) {
+        const RadarParams& r = radars_[i];
+        std::shared_ptr<const HorizonProfile>& h = radarState_[i].horizon;
+        const SamplingSettings& sampling = terrain_.getSamplingSettings();
+        double spacing = r.range * sampling.rangeTolerance;
+        auto usable = [&](const std::shared_ptr<const HorizonProfile>& p) {
+            return p && p->matches(r, numRays_) && p->spacing() <= 4 * spacing;
+        };
+        const bool useStore = horizonStore_.find && terrain_.epoch() == storeTerrainEpoch_ &&
+                              terrain_.elevationVersion() == storeElevationVersion_;
+        if (!usable(h)) {
+            h = useStore ? horizonStore_.find(r, numRays_, sampling, storeChecksum_) : nullptr;
+            if (!usable(h)) {
+                h = std::make_shared<const HorizonProfile>(
+                    HorizonProfile::compute(terrain_, r, numRays_, r.range, spacing));
+                if (useStore && horizonStore_.put) horizonStore_.put(h, sampling, storeChecksum_);
+            }
+        }
+        if (h->reach() < r.range) {
+            auto extended = std::make_shared<HorizonProfile>(*h);
+            extended->extend(terrain_, r.range);
+            h = extended;
+            if (useStore && horizonStore_.put) horizonStore_.put(h, sampling, storeChecksum_);
+        }
+        return h->coveragePolygon(r);
+    }
+    
+    /**
+     * 按 numThreads_ 并行执行 fn(k)；每个工作线程写自己的 PerfStats，结束后并入当前接收者
+     */
+    template <typename Fn>
+    void parallelOverRadars(size_t count, Fn&& fn) {
+        std::vector<PerfStats> workerStats(
+            std::max<size_t>(1, numThreads_ ? numThreads_ : polygon_ops::hardwareThreads()));
+        polygon_ops::parallelFor(count, workerStats.size(), [&](size_t k, size_t worker) {
+            PerfSinkScope sink(PerfStats::enabled ? &workerStats[worker] : nullptr);
+            fn(k);
+        });
+        if (PerfStats* sink = polygon_ops::perfSink()) {
+            for (const auto& ws : workerStats) sink->merge(ws);
+        }
+    }
+    
+    /**
+     * 合并：无移动雷达时一次性全部求并；否则复用静态雷达的并集缓存
+     */
+    void mergeCoverages() {
+        std::vector<Polygon> moving;
+        for (size_t i = 0; i < radars_.size(); i++) {
+            if (radarState_[i].moving) moving.push_back(individualCoverages_[i]);
+        }
+        
+        if (moving.empty()) {
+            staticUnion_.clear();
+            staticDirty_ = true;
+            mergedCoverage_ = PolygonBoolean::unionAll(individualCoverages_);
+            return;
+        }
+        
+        if (staticDirty_) {
+            std::vector<Polygon> fixed;
+            fixed.reserve(radars_.size() - moving.size());
+            for (size_t i = 0; i < radars_.size(); i++) {
+                if (!radarState_[i].moving) fixed.push_back(individualCoverages_[i]);
+            }
+            staticUnion_ = PolygonBoolean::unionPaths(fixed);
+            staticDirty_ = false;
+        }
+        mergedCoverage_ = PolygonBoolean::unionWith(staticUnion_, moving);
+    }
+    
+    /**
+     * 地形版本变化时只标记量程圆与变化区域相交的雷达；整个地形被替换（实例标识变化）时全部重算
+     */
+    void syncTerrain() {
+        uint64_t version = terrain_.version();
+        uint64_t epoch = terrain_.epoch();
+        if (version == terrainVersion_ && epoch == terrainEpoch_) return;
+        TerrainChangeSet changes;
+        if (epoch == terrainEpoch_) {
+            changes = terrain_.changesSince(terrainVersion_);
+        } else {
+            changes.global = true;
+        }
+        terrainVersion_ = version;
+        terrainEpoch_ = epoch;
+        if (horizonStore_.find) storeChecksum_ = terrain_.contentChecksum();
+        
+        if (changes.global) {
+            invalidate();
+            return;
+        }
+        for (size_t i = 0; i < radars_.size(); i++) {
+            const RadarParams& r = radars_[i];
+            // 地平剖面可能比当前量程长，按两者中较大者判断
+            std::shared_ptr<const HorizonProfile>& horizon = radarState_[i].horizon;
+            double reach = std::max(r.range, horizon ? horizon->reach() : 0.0);
+            for (const auto& box : changes.regions) {
+                double dx = r.position.x - std::max(box.minX, std::min(r.position.x, box.maxX));
+                double dy = r.position.y - std::max(box.minY, std::min(r.position.y, box.maxY));
+                if (dx * dx + dy * dy <= reach * reach) {
+                    horizon.reset();
+                    std::vector<float>().swap(radarState_[i].rayRanges);
+                    markRadarDirty(i);
+                    break;
+                }
+            }
+        }
+    }
+    
     void updateIfDirty() {
+        syncTerrain();
         if (!dirty_) return;
         
-        individualCoverages_.clear();
-        individualCoverages_.reserve(radars_.size());
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("updateIfDirty", "manager", "radars", radars_.size());
+        PerfSinkScope perfScope(&perfStats_);
+        RADAR_COVERAGE_PERF_COUNT(updates, 1);
         
-        for (const auto& radar : radars_) {
-            Polygon coverage = generateCoveragePolygon(radar, terrain_, numRays_);
-            individualCoverages_.push_back(coverage);
-        }
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        Clock::time_point last = start;
+        auto lap = [&last]() {
+            Clock::time_point now = Clock::now();
+            double ms = std::chrono::duration<double, std::milli>(now - last).count();
+            last = now;
+            return ms;
+        };
         
-        mergedCoverage_ = PolygonBoolean::unionAll(individualCoverages_);
+        // 重算失败时恢复原结果，下次重算的增量仍以它为基准
+        MultiPolygon previous = std::move(mergedCoverage_);
         
-        if (simplifyEpsilon_ > 0) {
-            mergedCoverage_ = PolygonProcessor::simplifyAll(mergedCoverage_, simplifyEpsilon_);
+        UpdateTimings t;
+        try {
+            t.radarsRecomputed = regenerateDirtyCoverages();
+            t.generateMs = lap();
+            
+            mergeCoverages();
+            t.unionMs = lap();
+            
+            if (simplifyEpsilon_ > 0) {
+                mergedCoverage_ = PolygonProcessor::simplifyAll(mergedCoverage_, simplifyEpsilon_);
+                t.simplifyMs = lap();
+            }
+            if (smoothIterations_ > 0) {
+                mergedCoverage_ = PolygonProcessor::smoothAll(mergedCoverage_, smoothIterations_);
+                t.smoothMs = lap();
+            }
+        } catch (...) {
+            mergedCoverage_ = std::move(previous);
+            throw;
         }
-        if (smoothIterations_ > 0) {
-            mergedCoverage_ = PolygonProcessor::smoothAll(mergedCoverage_, smoothIterations_);
+        t.totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        lastTimings_ = t;
+        
+        if (deltaTracking_) {
+            previousCoverage_ = std::move(previous);
+            previousVersion_ = coverageVersion_;
+        }
+        coverageVersion_++;
+        if (deltaTracking_) {
+            if (changedEverywhere_) {
+                changedRegion_ = multiPolygonBounds(previousCoverage_);
+                expandBox(changedRegion_, multiPolygonBounds(mergedCoverage_));
+            }
+            lastChangedRegion_ = changedRegion_;
+            changedRegion_ = emptyBox();
+            changedEverywhere_ = false;
+        }
+        deltaReady_ = false;
+        
+        if (PerfStats::enabled) {
+            perfStats_.generateMs += t.generateMs;
+            perfStats_.unionMs += t.unionMs;
+            perfStats_.simplifyMs += t.simplifyMs;
+            perfStats_.smoothMs += t.smoothMs;
+            perfStats_.updateMs += t.totalMs;
         }
         
         dirty_ = false;
     }
     
     TerrainModel terrain_;
+    uint64_t terrainVersion_ = 0;                       // 已同步的地形版本
+    uint64_t terrainEpoch_ = terrain_.epoch();          // 已同步的地形实例标识
     std::vector<RadarParams> radars_;
+    std::vector<RadarState> radarState_;                // 与 radars_ 一一对应
+    std::unordered_map<int, size_t> indexById_;
+    bool indexDirty_ = true;
     
     std::vector<Polygon> individualCoverages_;
+    polygon_ops::ClipperPaths staticUnion_;             // 非移动雷达覆盖的并集
+    bool staticDirty_ = true;
     MultiPolygon mergedCoverage_;
     
+    CoverageGenerator generator_;
+    ScheduleHook scheduleHook_;
     int numRays_;
     double simplifyEpsilon_;
     int smoothIterations_;
+    size_t numThreads_ = 0;
+    double settleTime_ = 2.0;
+    bool warmStart_ = true;
+    bool horizonCache_ = false;
+    HorizonStoreHooks horizonStore_;
+    uint64_t storeElevationVersion_ = 0;                // 挂接存储时的高程来源版本
+    uint64_t storeTerrainEpoch_ = 0;                    // 挂接存储时的地形实例标识
+    uint64_t storeChecksum_ = 0;
     bool dirty_ = true;
+    
+    uint64_t stepCount_ = 0;
+    double simTime_ = 0.0;
+    UpdateTimings lastTimings_;
+    PerfStats perfStats_;
+    
+    // 增量跟踪
+    bool deltaTracking_ = false;
+    uint64_t coverageVersion_ = 0;
+    uint64_t previousVersion_ = 0;                      // previousCoverage_ 的版本
+    MultiPolygon previousCoverage_;
+    PolygonUtils::BoundingBox changedRegion_ = emptyBox();      // 自上次重算以来累计
+    PolygonUtils::BoundingBox lastChangedRegion_ = emptyBox();  // 上一次重算的变化区域
+    bool changedEverywhere_ = false;
+    CoverageDelta lastDelta_;
+    bool deltaReady_ = false;
 };
 
 // ============================================================================
@@ -391,4 +1705,260 @@ inline std::string exportToSVG(
     return svg.str();
 }
 
+// ============================================================================
+// 视口感知的流式 SVG 导出
+// ============================================================================
+
+/**
+ * 世界坐标窗口到像素画布的映射
+ * 
+ * 窗口外的区域/障碍/雷达被剔除；部分可见的环先裁剪到窗口（含描边余量），
+ * 再丢弃与上一个输出点距离小于 minPixelDistance 的顶点，
+ * 因此导出开销与可见内容成正比，而非与场景规模成正比。
+ */
+struct SvgViewport {
+    double minX = 0, minY = 0, maxX = 800, maxY = 600;   // 世界坐标窗口
+    int width = 800, height = 600;                        // 像素尺寸
+    bool flipY = false;          // true: 世界 y 轴向上（地图约定）
+    double minPixelDistance = 0.75;
+    int precision = 1;           // 像素坐标小数位
+    double marginPixels = 4;     // 裁剪余量（覆盖描边宽度）
+    
+    /**
+     * 像素坐标与世界坐标一一对应（与 exportToSVG 字符串版本一致）
+     */
+    static SvgViewport identity(int w, int h) {
+        SvgViewport vp;
+        vp.maxX = w;
+        vp.maxY = h;
+        vp.width = w;
+        vp.height = h;
+        return vp;
+    }
+    
+    /**
+     * 使窗口包含 bounds 并保持纵横比
+     */
+    static SvgViewport fitTo(const PolygonUtils::BoundingBox& bounds, int w, int h,
+                             double marginRatio = 0.05) {
+        SvgViewport vp;
+        vp.width = w;
+        vp.height = h;
+        vp.flipY = true;
+        
+        double bw = std::max(bounds.width(), 1e-9) * (1 + 2 * marginRatio);
+        double bh = std::max(bounds.height(), 1e-9) * (1 + 2 * marginRatio);
+        double scale = std::min(w / bw, h / bh);
+        double halfW = w / scale / 2, halfH = h / scale / 2;
+        Point2D c = bounds.center();
+        vp.minX = c.x - halfW;
+        vp.maxX = c.x + halfW;
+        vp.minY = c.y - halfH;
+        vp.maxY = c.y + halfH;
+        return vp;
+    }
+    
+    double scaleX() const { return width / (maxX - minX); }
+    double scaleY() const { return height / (maxY - minY); }
+    
+    Point2D toPixel(const Point2D& p) const {
+        double px = (p.x - minX) * scaleX();
+        double py = flipY ? (maxY - p.y) * scaleY() : (p.y - minY) * scaleY();
+        return {px, py};
+    }
+    
+    bool intersects(double x0, double y0, double x1, double y1, double marginWorld) const {
+        return x1 >= minX - marginWorld && x0 <= maxX + marginWorld &&
+               y1 >= minY - marginWorld && y0 <= maxY + marginWorld;
+    }
+    
+    bool contains(const PolygonUtils::BoundingBox& b) const {
+        return b.minX >= minX && b.maxX <= maxX && b.minY >= minY && b.maxY <= maxY;
+    }
+};
+
+struct SvgExportStats {
+    size_t ringsWritten = 0;
+    size_t ringsCulled = 0;
+    size_t verticesIn = 0;
+    size_t verticesWritten = 0;
+};
+
+namespace detail {
+
+class SvgRingWriter {
+public:
+    SvgRingWriter(BufferedWriter& out, const SvgViewport& vp, SvgExportStats& stats)
+        : out_(out), vp_(vp), stats_(stats) {
+        double marginWorld = vp.marginPixels / std::min(vp.scaleX(), vp.scaleY());
+        clipRect_ = Clipper2Lib::RectD(vp.minX - marginWorld, vp.minY - marginWorld,
+                                       vp.maxX + marginWorld, vp.maxY + marginWorld);
+        marginWorld_ = marginWorld;
+    }
+    
+    /**
+     * 写出一个环为 <polygon>；完全不可见或退化时不输出
+     */
+    void write(const Polygon& ring, const char* attrs) {
+        stats_.verticesIn += ring.size();
+        if (ring.size() < 3) { stats_.ringsCulled++; return; }
+        
+        PolygonUtils::BoundingBox b = PolygonUtils::boundingBox(ring);
+        if (!vp_.intersects(b.minX, b.minY, b.maxX, b.maxY, marginWorld_)) {
+            stats_.ringsCulled++;
+            return;
+        }
+        
+        if (vp_.contains(b)) {
+            emit(ring, attrs);
+            return;
+        }
+        
+        polygon_ops::ClipperPaths clipped = Clipper2Lib::RectClip(
+            clipRect_, polygon_ops::ClipperPaths{
+                polygon_ops::CoordinateConverter::toClipperPath(ring)});
+        if (clipped.empty()) { stats_.ringsCulled++; return; }
+        for (const auto& path : clipped) {
+            emit(polygon_ops::CoordinateConverter::fromClipperPath(path), attrs);
+        }
+    }
+    
+private:
+    void emit(const Polygon& ring, const char* attrs) {
+        // 像素级抽稀
+        pixels_.clear();
+        double minDistSq = vp_.minPixelDistance * vp_.minPixelDistance;
+        for (const auto& p : ring) {
+            Point2D px = vp_.toPixel(p);
+            if (!pixels_.empty()) {
+                Point2D d = px - pixels_.back();
+                if (d.dot(d) < minDistSq) continue;
+            }
+            pixels_.push_back(px);
+        }
+        if (pixels_.size() > 1) {
+            Point2D d = pixels_.back() - pixels_.front();
+            if (d.dot(d) < minDistSq) pixels_.pop_back();
+        }
+        if (pixels_.size() < 3) { stats_.ringsCulled++; return; }
+        
+        out_.writeLiteral("  <polygon points=\"");
+        for (size_t i = 0; i < pixels_.size(); i++) {
+            if (i > 0) out_.put(' ');
+            out_.writeDouble(pixels_[i].x, vp_.precision);
+            out_.put(',');
+            out_.writeDouble(pixels_[i].y, vp_.precision);
+        }
+        out_.writeLiteral("\" ");
+        out_.write(attrs, std::strlen(attrs));
+        out_.writeLiteral("/>\n");
+        
+        stats_.ringsWritten++;
+        stats_.verticesWritten += pixels_.size();
+    }
+    
+    BufferedWriter& out_;
+    const SvgViewport& vp_;
+    SvgExportStats& stats_;
+    Clipper2Lib::RectD clipRect_;
+    double marginWorld_ = 0;
+    Polygon pixels_;
+};
+
+} // namespace detail
+
+/**
+ * 按视口流式导出 SVG 到 BufferedWriter（文件或任意 sink）
+ */
+inline SvgExportStats exportToSVG(
+    BufferedWriter& out,
+    const std::vector<RadarParams>& radars,
+    const std::vector<Polygon>& coverages,
+    const MultiPolygon& merged,
+    const TerrainModel& terrain,
+    const SvgViewport& vp
+) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("exportSVG", "export", "regions", merged.size());
+    SvgExportStats stats;
+    detail::SvgRingWriter rings(out, vp, stats);
+    double sx = vp.scaleX(), sy = vp.scaleY();
+    
+    out.writeLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+    out.writeInt(vp.width);
+    out.writeLiteral("\" height=\"");
+    out.writeInt(vp.height);
+    out.writeLiteral("\">\n  <rect width=\"100%\" height=\"100%\" fill=\"#0a0f1a\"/>\n");
+    
+    for (const auto& obs : terrain.getObstacles()) {
+        if (!vp.intersects(obs.center.x - obs.rx, obs.center.y - obs.ry,
+                           obs.center.x + obs.rx, obs.center.y + obs.ry, 0)) {
+            continue;
+        }
+        Point2D c = vp.toPixel(obs.center);
+        out.writeLiteral("  <ellipse cx=\"");
+        out.writeDouble(c.x, vp.precision);
+        out.writeLiteral("\" cy=\"");
+        out.writeDouble(c.y, vp.precision);
+        out.writeLiteral("\" rx=\"");
+        out.writeDouble(obs.rx * sx, vp.precision);
+        out.writeLiteral("\" ry=\"");
+        out.writeDouble(obs.ry * sy, vp.precision);
+        out.writeLiteral("\" fill=\"#92400e\" fill-opacity=\"0.5\"/>\n");
+    }
+    
+    for (const auto& pwh : merged) {
+        rings.write(pwh.outer,
+                    "fill=\"#06b6d4\" fill-opacity=\"0.3\" stroke=\"#06b6d4\" stroke-width=\"2\"");
+        for (const auto& hole : pwh.holes) {
+            rings.write(hole, "fill=\"#0a0f1a\" stroke=\"#ef4444\" stroke-width=\"1\"");
+        }
+    }
+    
+    const char* colors[] = {"#3b82f6", "#10b981", "#f59e0b", "#ef4444", "#8b5cf6"};
+    const char* coverageAttrs[] = {
+        "fill=\"none\" stroke=\"#3b82f6\" stroke-opacity=\"0.5\" stroke-dasharray=\"4,2\"",
+        "fill=\"none\" stroke=\"#10b981\" stroke-opacity=\"0.5\" stroke-dasharray=\"4,2\"",
+        "fill=\"none\" stroke=\"#f59e0b\" stroke-opacity=\"0.5\" stroke-dasharray=\"4,2\"",
+        "fill=\"none\" stroke=\"#ef4444\" stroke-opacity=\"0.5\" stroke-dasharray=\"4,2\"",
+        "fill=\"none\" stroke=\"#8b5cf6\" stroke-opacity=\"0.5\" stroke-dasharray=\"4,2\""
+    };
+    for (size_t i = 0; i < coverages.size(); i++) {
+        rings.write(coverages[i], coverageAttrs[i % 5]);
+    }
+    
+    double markerWorld = 10 / std::min(sx, sy);
+    for (size_t i = 0; i < radars.size(); i++) {
+        const auto& r = radars[i];
+        if (!vp.intersects(r.position.x, r.position.y, r.position.x, r.position.y, markerWorld)) {
+            continue;
+        }
+        Point2D c = vp.toPixel(r.position);
+        out.writeLiteral("  <circle cx=\"");
+        out.writeDouble(c.x, vp.precision);
+        out.writeLiteral("\" cy=\"");
+        out.writeDouble(c.y, vp.precision);
+        out.writeLiteral("\" r=\"10\" fill=\"");
+        out.write(colors[i % 5], 7);
+        out.writeLiteral("\"/>\n");
+    }
+    
+    out.writeLiteral("</svg>\n");
+    return stats;
+}
+
+inline SvgExportStats exportToSVGFile(
+    const std::string& path,
+    const std::vector<RadarParams>& radars,
+    const std::vector<Polygon>& coverages,
+    const MultiPolygon& merged,
+    const TerrainModel& terrain,
+    const SvgViewport& vp
+) {
+    BufferedWriter out(path);
+    SvgExportStats stats = exportToSVG(out, radars, coverages, merged, terrain, vp);
+    out.close();
+    return stats;
+}
+
 } // namespace radar_coverage
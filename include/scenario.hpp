@@ -0,0 +1,451 @@
+/**
+ * scenario.hpp
+ *
+ * 场景文件：雷达、地形障碍、DEM 引用与管理器参数
+ *
+ * 两种等价形式:
+ *   - JSON（便于手工编辑）
+ *   - 紧凑二进制 .rcscn（大规模场景，内存映射后顺序解析）
+ * loadScenario() 根据魔数自动识别。
+ *
+ * JSON 示例:
+ *   {
+ *     "name": "demo",
+ *     "settings": {"numRays": 72, "simplifyEpsilon": 2.0, "smoothIterations": 1,
+ *                  "losSamples": 40, "rangeTolerance": 0.01},
+ *     "dems": [{"path": "terrain.rcdem"}],
+ *     "obstacles": [{"name": "中央大山", "center": [400, 280], "rx": 100, "ry": 80, "height": 800}],
+ *     "radars": [{"id": 1, "name": "雷达 A", "position": [200, 200], "range": 180, "height": 80}]
+ *   }
+ * 雷达的 minElevation / maxElevation / azimuthStart / azimuthEnd 可省略（取 RadarParams 默认值）。
+ * DEM 相对路径相对于场景文件所在目录解析。
+ *
+ * 二进制格式（小端，字符串 = u32 长度 + 字节）:
+ *   "RCSCN002"
+ *   numRays i32, simplifyEpsilon f64, smoothIterations i32,
+ *   losSamples i32, rangeTolerance f64, name str
+ *   （旧版 "RCSCN001" 无 losSamples / rangeTolerance，读取时取默认值）
+ *   demCount u32,      { path str }
+ *   obstacleCount u32, { cx cy rx ry height f64, name str }
+ *   radarCount u32,    { id i32, x y range height minEl maxEl azStart azEnd f64, name str }
+ *
+ * 依赖: radar_coverage.hpp, terrain_raster.hpp, json_reader.hpp, mapped_file.hpp
+ */
+
+#pragma once
+
+#include "radar_coverage.hpp"
+#include "terrain_raster.hpp"
+#include "json_reader.hpp"
+#include "mapped_file.hpp"
+#include "stream_writer.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 场景数据
+// ============================================================================
+
+struct DemReference {
+    std::string path;
+};
+
+struct ManagerSettings {
+    int numRays = 72;
+    double simplifyEpsilon = 5.0;
+    int smoothIterations = 1;
+    SamplingSettings sampling;
+};
+
+struct Scenario {
+    std::string name;
+    ManagerSettings settings;
+    std::vector<DemReference> dems;
+    std::vector<TerrainObstacle> obstacles;
+    std::vector<RadarParams> radars;
+    std::string baseDir;    // 加载时记录，用于解析 DEM 相对路径
+
+    std::string resolvePath(const std::string& path) const {
+        std::filesystem::path p(path);
+        if (p.is_absolute() || baseDir.empty()) return path;
+        return (std::filesystem::path(baseDir) / p).string();
+    }
+};
+
+namespace scenario_detail {
+
+// ============================================================================
+// 二进制读取
+// ============================================================================
+
+class BinaryCursor {
+public:
+    BinaryCursor(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    T read() {
+        need(sizeof(T));
+        T v;
+        std::memcpy(&v, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+
+    std::string readString() {
+        uint32_t n = read<uint32_t>();
+        need(n);
+        std::string s(reinterpret_cast<const char*>(data_ + pos_), n);
+        pos_ += n;
+        return s;
+    }
+
+    /**
+     * 校验剩余字节数至少可容纳 count 条最小记录（防止恶意计数导致超大分配）
+     */
+    void needRecords(uint32_t count, size_t minRecordSize) const {
+        need(static_cast<size_t>(count) * minRecordSize);
+    }
+
+    void need(size_t n) const {
+        if (n > size_ - pos_) throw std::runtime_error("Scenario: truncated binary file");
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+inline Point2D readPoint(const JsonValue& v) {
+    if (!v.isArray() || v.size() != 2) {
+        throw std::runtime_error("Scenario: point must be [x, y]");
+    }
+    return {v[0].asNumber(), v[1].asNumber()};
+}
+
+} // namespace scenario_detail
+
+// ============================================================================
+// 解析
+// ============================================================================
+
+/**
+ * 识别二进制场景魔数（"RCSCN001" / "RCSCN002"）
+ */
+inline bool isBinaryScenario(const uint8_t* data, size_t size) {
+    return size >= 8 && std::memcmp(data, "RCSCN00", 7) == 0 &&
+           (data[7] == '1' || data[7] == '2');
+}
+
+inline Scenario parseScenarioBinary(const uint8_t* data, size_t size) {
+    if (!BufferedWriter::isLittleEndian()) {
+        throw std::runtime_error("Scenario: big-endian hosts are not supported");
+    }
+    if (!isBinaryScenario(data, size)) {
+        throw std::runtime_error("Scenario: not a binary scenario file");
+    }
+    bool hasSampling = data[7] >= '2';
+
+    scenario_detail::BinaryCursor in(data + 8, size - 8);
+    Scenario sc;
+    sc.settings.numRays = in.read<int32_t>();
+    sc.settings.simplifyEpsilon = in.read<double>();
+    sc.settings.smoothIterations = in.read<int32_t>();
+    if (hasSampling) {
+        sc.settings.sampling.losSamples = in.read<int32_t>();
+        sc.settings.sampling.rangeTolerance = in.read<double>();
+    }
+    sc.name = in.readString();
+
+    uint32_t demCount = in.read<uint32_t>();
+    in.needRecords(demCount, 4);
+    sc.dems.resize(demCount);
+    for (auto& dem : sc.dems) {
+        dem.path = in.readString();
+    }
+
+    uint32_t obstacleCount = in.read<uint32_t>();
+    in.needRecords(obstacleCount, 5 * 8 + 4);
+    sc.obstacles.resize(obstacleCount);
+    for (auto& obs : sc.obstacles) {
+        obs.center.x = in.read<double>();
+        obs.center.y = in.read<double>();
+        obs.rx = in.read<double>();
+        obs.ry = in.read<double>();
+        obs.height = in.read<double>();
+        obs.name = in.readString();
+    }
+
+    uint32_t radarCount = in.read<uint32_t>();
+    in.needRecords(radarCount, 4 + 8 * 8 + 4);
+    sc.radars.resize(radarCount);
+    for (auto& r : sc.radars) {
+        r.id = in.read<int32_t>();
+        r.position.x = in.read<double>();
+        r.position.y = in.read<double>();
+        r.range = in.read<double>();
+        r.height = in.read<double>();
+        r.minElevation = in.read<double>();
+        r.maxElevation = in.read<double>();
+        r.azimuthStart = in.read<double>();
+        r.azimuthEnd = in.read<double>();
+        r.name = in.readString();
+    }
+    return sc;
+}
+
+inline Scenario parseScenarioJSON(const char* data, size_t size) {
+    using scenario_detail::readPoint;
+
+    JsonValue root = JsonParser::parse(data, size);
+    Scenario sc;
+    sc.name = root.stringOr("name", "");
+
+    if (const JsonValue* s = root.find("settings")) {
+        sc.settings.numRays = s->intOr("numRays", sc.settings.numRays);
+        sc.settings.simplifyEpsilon = s->numberOr("simplifyEpsilon", sc.settings.simplifyEpsilon);
+        sc.settings.smoothIterations = s->intOr("smoothIterations", sc.settings.smoothIterations);
+        SamplingSettings& sampling = sc.settings.sampling;
+        sampling.losSamples = s->intOr("losSamples", sampling.losSamples);
+        sampling.rangeTolerance = s->numberOr("rangeTolerance", sampling.rangeTolerance);
+    }
+
+    if (const JsonValue* dems = root.find("dems")) {
+        for (const auto& d : dems->items()) {
+            sc.dems.push_back({d.at("path").asString()});
+        }
+    }
+
+    if (const JsonValue* obstacles = root.find("obstacles")) {
+        sc.obstacles.reserve(obstacles->size());
+        for (const auto& o : obstacles->items()) {
+            sc.obstacles.emplace_back(readPoint(o.at("center")),
+                                      o.at("rx").asNumber(), o.at("ry").asNumber(),
+                                      o.at("height").asNumber(), o.stringOr("name", ""));
+        }
+    }
+
+    if (const JsonValue* radars = root.find("radars")) {
+        sc.radars.reserve(radars->size());
+        for (const auto& j : radars->items()) {
+            RadarParams r(j.at("id").asInt<int>(), j.stringOr("name", "Radar"),
+                          readPoint(j.at("position")),
+                          j.at("range").asNumber(), j.at("height").asNumber());
+            r.minElevation = j.numberOr("minElevation", r.minElevation);
+            r.maxElevation = j.numberOr("maxElevation", r.maxElevation);
+            r.azimuthStart = j.numberOr("azimuthStart", r.azimuthStart);
+            r.azimuthEnd = j.numberOr("azimuthEnd", r.azimuthEnd);
+            sc.radars.push_back(std::move(r));
+        }
+    }
+    return sc;
+}
+
+/**
+ * 加载场景文件（按魔数识别二进制 / JSON）
+ *
+ * @throws std::runtime_error 文件不存在、格式错误或数据截断
+ */
+inline Scenario loadScenario(const std::string& path) {
+    MappedFile file(path);
+    file.adviseSequential();
+
+    Scenario sc;
+    if (isBinaryScenario(file.data(), file.size())) {
+        sc = parseScenarioBinary(file.data(), file.size());
+    } else {
+        sc = parseScenarioJSON(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+    sc.baseDir = std::filesystem::path(path).parent_path().string();
+    return sc;
+}
+
+// ============================================================================
+// 写出
+// ============================================================================
+
+inline void writeScenarioBinary(BufferedWriter& out, const Scenario& sc) {
+    auto writeString = [&out](const std::string& s) {
+        out.writeLE<uint32_t>(static_cast<uint32_t>(s.size()));
+        out.write(s);
+    };
+
+    out.writeLiteral("RCSCN002");
+    out.writeLE<int32_t>(sc.settings.numRays);
+    out.writeLE<double>(sc.settings.simplifyEpsilon);
+    out.writeLE<int32_t>(sc.settings.smoothIterations);
+    out.writeLE<int32_t>(sc.settings.sampling.losSamples);
+    out.writeLE<double>(sc.settings.sampling.rangeTolerance);
+    writeString(sc.name);
+
+    out.writeLE<uint32_t>(static_cast<uint32_t>(sc.dems.size()));
+    for (const auto& dem : sc.dems) {
+        writeString(dem.path);
+    }
+
+    out.writeLE<uint32_t>(static_cast<uint32_t>(sc.obstacles.size()));
+    for (const auto& obs : sc.obstacles) {
+        out.writeLE<double>(obs.center.x);
+        out.writeLE<double>(obs.center.y);
+        out.writeLE<double>(obs.rx);
+        out.writeLE<double>(obs.ry);
+        out.writeLE<double>(obs.height);
+        writeString(obs.name);
+    }
+
+    out.writeLE<uint32_t>(static_cast<uint32_t>(sc.radars.size()));
+    for (const auto& r : sc.radars) {
+        out.writeLE<int32_t>(r.id);
+        out.writeLE<double>(r.position.x);
+        out.writeLE<double>(r.position.y);
+        out.writeLE<double>(r.range);
+        out.writeLE<double>(r.height);
+        out.writeLE<double>(r.minElevation);
+        out.writeLE<double>(r.maxElevation);
+        out.writeLE<double>(r.azimuthStart);
+        out.writeLE<double>(r.azimuthEnd);
+        writeString(r.name);
+    }
+}
+
+inline void writeScenarioJSON(BufferedWriter& out, const Scenario& sc) {
+    auto num = [&out](double v) { out.writeDouble(v); };
+    auto point = [&](const Point2D& p) {
+        out.put('[');
+        num(p.x);
+        out.writeLiteral(", ");
+        num(p.y);
+        out.put(']');
+    };
+
+    out.writeLiteral("{\n  \"name\": ");
+    writeJsonString(out, sc.name);
+    out.writeLiteral(",\n  \"settings\": {\"numRays\": ");
+    out.writeInt(sc.settings.numRays);
+    out.writeLiteral(", \"simplifyEpsilon\": ");
+    num(sc.settings.simplifyEpsilon);
+    out.writeLiteral(", \"smoothIterations\": ");
+    out.writeInt(sc.settings.smoothIterations);
+    out.writeLiteral(", \"losSamples\": ");
+    out.writeInt(sc.settings.sampling.losSamples);
+    out.writeLiteral(", \"rangeTolerance\": ");
+    num(sc.settings.sampling.rangeTolerance);
+    out.writeLiteral("},\n  \"dems\": [");
+    for (size_t i = 0; i < sc.dems.size(); i++) {
+        if (i > 0) out.put(',');
+        out.writeLiteral("\n    ");
+        out.writeLiteral("{\"path\": ");
+        writeJsonString(out, sc.dems[i].path);
+        out.put('}');
+    }
+    out.writeLiteral("],\n  \"obstacles\": [");
+    for (size_t i = 0; i < sc.obstacles.size(); i++) {
+        const auto& o = sc.obstacles[i];
+        if (i > 0) out.put(',');
+        out.writeLiteral("\n    ");
+        out.writeLiteral("{\"name\": ");
+        writeJsonString(out, o.name);
+        out.writeLiteral(", \"center\": ");
+        point(o.center);
+        out.writeLiteral(", \"rx\": "); num(o.rx);
+        out.writeLiteral(", \"ry\": "); num(o.ry);
+        out.writeLiteral(", \"height\": "); num(o.height);
+        out.put('}');
+    }
+    out.writeLiteral("],\n  \"radars\": [");
+    for (size_t i = 0; i < sc.radars.size(); i++) {
+        const auto& r = sc.radars[i];
+        if (i > 0) out.put(',');
+        out.writeLiteral("\n    ");
+        out.writeLiteral("{\"id\": ");
+        out.writeInt(r.id);
+        out.writeLiteral(", \"name\": ");
+        writeJsonString(out, r.name);
+        out.writeLiteral(", \"position\": ");
+        point(r.position);
+        out.writeLiteral(", \"range\": "); num(r.range);
+        out.writeLiteral(", \"height\": "); num(r.height);
+        out.writeLiteral(", \"minElevation\": "); num(r.minElevation);
+        out.writeLiteral(", \"maxElevation\": "); num(r.maxElevation);
+        out.writeLiteral(", \"azimuthStart\": "); num(r.azimuthStart);
+        out.writeLiteral(", \"azimuthEnd\": "); num(r.azimuthEnd);
+        out.put('}');
+    }
+    out.writeLiteral("]\n}\n");
+}
+
+/**
+ * 保存场景；binary = true 时写出 .rcscn 二进制格式
+ */
+inline void saveScenario(const std::string& path, const Scenario& sc, bool binary) {
+    BufferedWriter out(path);
+    if (binary) {
+        writeScenarioBinary(out, sc);
+    } else {
+        writeScenarioJSON(out, sc);
+    }
+    out.close();
+}
+
+// ============================================================================
+// 应用到管理器
+// ============================================================================
+
+/**
+ * 用场景内容替换管理器的雷达、地形与参数
+ *
+ * @param cache 可选的 DEM 缓存；多个场景共用同一缓存时 DEM 只加载一次
+ */
+inline void applyScenario(const Scenario& sc, CoverageMergeManager& manager,
+                          ElevationGridCache* cache = nullptr) {
+    ElevationGridCache localCache;
+    if (!cache) cache = &localCache;
+
+    std::vector<std::shared_ptr<const ElevationGrid>> grids;
+    grids.reserve(sc.dems.size());
+    for (const auto& dem : sc.dems) {
+        grids.push_back(cache->get(sc.resolvePath(dem.path)));
+    }
+
+    TerrainModel& terrain = manager.terrain();
+    terrain.clearObstacles();
+    for (const auto& obs : sc.obstacles) {
+        terrain.addObstacle(obs);
+    }
+
+    if (grids.empty()) {
+        terrain.setElevationFunction(nullptr);
+    } else if (grids.size() == 1) {
+        terrain.setElevationFunction(ElevationGrid::asFunction(grids[0]));
+    } else {
+        // 只在覆盖该点的栅格间取最大值；低于海平面的高程保持原值
+        terrain.setElevationFunction([grids](double x, double y) {
+            bool covered = false;
+            double h = 0.0;
+            for (const auto& g : grids) {
+                if (!g->contains(x, y)) continue;
+                double v = g->sample(x, y);
+                h = covered ? std::max(h, v) : v;
+                covered = true;
+            }
+            return h;
+        });
+    }
+
+    manager.setNumRays(sc.settings.numRays);
+    manager.setSimplifyEpsilon(sc.settings.simplifyEpsilon);
+    manager.setSmoothIterations(sc.settings.smoothIterations);
+    manager.setSamplingSettings(sc.settings.sampling);
+
+    manager.clearRadars();
+    manager.addRadars(sc.radars);
+}
+
+} // namespace radar_coverage
@@ -0,0 +1,328 @@
+/**
+ * scenario_generator.hpp
+ *
+ * 可复现的合成场景生成器（规模测试 / 回归基准）
+ *
+ * - 地形: 若干条山脉，每条沿随机游走的山脊线排布高斯山峰，峰高向两端递减
+ * - 雷达: 一部分聚集在若干"站点群"周围，其余均匀分布；量程与天线高度取对数正态分布，
+ *         部分为扇区雷达
+ * - 分形 DEM: 菱形-方形 (diamond-square) 算法生成任意尺寸的高程栅格，
+ *         粗糙度、起伏与分辨率可配，经 ElevationGrid::asFunction 接入 TerrainModel
+ * - 随机数使用自带的 SplitMix64 与 Box-Muller，不依赖标准库分布的实现，
+ *   同一种子在任何平台上生成完全相同的场景
+ *
+ * 依赖: scenario.hpp, terrain_raster.hpp, parallel_for.hpp
+ */
+
+#pragma once
+
+#include "scenario.hpp"
+#include "terrain_raster.hpp"
+#include "parallel_for.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 生成参数
+// ============================================================================
+
+struct SyntheticScenarioOptions {
+    uint64_t seed = 1;
+    size_t numRadars = 100;
+    size_t numObstacles = 200;
+    double extentX = 200000.0;           // 场景范围 [0, extentX] x [0, extentY] (米)
+    double extentY = 200000.0;
+
+    // 山脉
+    size_t numRanges = 0;                // 0: 按障碍数自动取 (约 sqrt(M) / 2)
+    double medianPeakHeight = 800.0;
+    double medianPeakRadius = 4000.0;
+
+    // 雷达
+    double medianRadarRange = 25000.0;
+    double minRadarRange = 5000.0;
+    double maxRadarRange = 150000.0;
+    double medianAntennaHeight = 25.0;
+    double clusteredFraction = 0.6;      // 聚集在站点群周围的比例
+    double sectorFraction = 0.2;         // 扇区雷达比例
+
+    ManagerSettings settings;
+};
+
+/**
+ * 分形 DEM 参数
+ *
+ * 内部在边长 2^n + 1 的方形格网上生成，再裁剪为 cols x rows。
+ */
+struct FractalTerrainOptions {
+    uint64_t seed = 1;
+    uint32_t cols = 1025;
+    uint32_t rows = 1025;
+    double cellSize = 100.0;             // 分辨率 (米/像元)
+    double originX = 0.0;
+    double originY = 0.0;
+    double roughness = 0.55;             // (0, 1)：每细分一级随机扰动的衰减系数，越大越崎岖
+    double relief = 1500.0;              // 最高点与最低点的高差 (米)
+    double baseElevation = 0.0;          // 最低点高程
+    size_t threads = 0;                  // 0: 硬件线程数；结果与线程数无关
+};
+
+namespace generator_detail {
+
+/** SplitMix64 的输出混合函数 */
+inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * 与访问顺序无关的格点随机数，[-1, 1)
+ *
+ * 由 (种子, 列, 行) 直接散列得到，因此并行生成的结果与线程数、调度顺序无关。
+ */
+inline double latticeNoise(uint64_t seed, uint32_t x, uint32_t y) {
+    uint64_t h = mix64(seed * 0x9E3779B97F4A7C15ull + ((uint64_t(y) << 32) | x));
+    return (h >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+/**
+ * SplitMix64：状态简单、统计质量足够、跨平台结果一致
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() { return mix64(state_ += 0x9E3779B97F4A7C15ull); }
+
+    /** [0, 1) 均匀分布（53 位精度） */
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+
+    /** 标准正态分布（Box-Muller，不缓存第二个值以保持调用序列简单） */
+    double normal() {
+        double u1 = uniform();
+        double u2 = uniform();
+        return std::sqrt(-2.0 * std::log(1.0 - u1)) * std::cos(2.0 * M_PI * u2);
+    }
+
+    double logNormal(double median, double sigma) { return median * std::exp(sigma * normal()); }
+
+    size_t index(size_t n) { return static_cast<size_t>(uniform() * n); }
+
+private:
+    uint64_t state_;
+};
+
+inline double clamp(double v, double lo, double hi) { return std::max(lo, std::min(hi, v)); }
+
+} // namespace generator_detail
+
+// ============================================================================
+// 生成
+// ============================================================================
+
+inline Scenario generateSyntheticScenario(const SyntheticScenarioOptions& opt) {
+    using generator_detail::clamp;
+
+    if (!(opt.extentX > 0) || !(opt.extentY > 0)) {
+        throw std::invalid_argument("SyntheticScenario: extent must be positive");
+    }
+
+    generator_detail::Random rng(opt.seed);
+    Scenario sc;
+    sc.name = "synthetic-s" + std::to_string(opt.seed) + "-r" + std::to_string(opt.numRadars) +
+              "-o" + std::to_string(opt.numObstacles);
+    sc.settings = opt.settings;
+
+    const double diag = std::hypot(opt.extentX, opt.extentY);
+
+    // ---- 山脉：山脊线随机游走，山峰沿线分布 ----
+    size_t numRanges = opt.numRanges;
+    if (numRanges == 0) {
+        numRanges = std::max<size_t>(1, static_cast<size_t>(std::sqrt(double(opt.numObstacles)) / 2));
+    }
+    numRanges = std::min(numRanges, std::max<size_t>(opt.numObstacles, 1));
+
+    sc.obstacles.reserve(opt.numObstacles);
+    for (size_t r = 0; r < numRanges; r++) {
+        // 均分障碍数，余数给前几条山脉
+        size_t peaks = opt.numObstacles / numRanges + (r < opt.numObstacles % numRanges ? 1 : 0);
+        if (peaks == 0) continue;
+
+        Point2D p(rng.uniform(0, opt.extentX), rng.uniform(0, opt.extentY));
+        double heading = rng.uniform(0, 2 * M_PI);
+        double length = diag * rng.uniform(0.15, 0.45);
+        double step = length / peaks;
+        double rangeHeight = opt.medianPeakHeight * std::exp(0.35 * rng.normal());
+
+        for (size_t k = 0; k < peaks; k++) {
+            heading += 0.25 * rng.normal();
+            p.x = clamp(p.x + step * std::cos(heading), 0, opt.extentX);
+            p.y = clamp(p.y + step * std::sin(heading), 0, opt.extentY);
+
+            // 偏离山脊的横向抖动
+            double off = 0.3 * opt.medianPeakRadius * rng.normal();
+            Point2D c(clamp(p.x - off * std::sin(heading), 0, opt.extentX),
+                      clamp(p.y + off * std::cos(heading), 0, opt.extentY));
+
+            // 中段最高，两端递减
+            double t = (k + 0.5) / peaks;
+            double taper = 0.35 + 0.65 * std::sin(M_PI * t);
+            double h = clamp(rangeHeight * taper * std::exp(0.25 * rng.normal()), 50.0, 8000.0);
+            double rx = clamp(rng.logNormal(opt.medianPeakRadius, 0.35), 200.0, diag);
+            double ry = clamp(rng.logNormal(opt.medianPeakRadius, 0.35), 200.0, diag);
+
+            sc.obstacles.emplace_back(c, rx, ry, h,
+                "range" + std::to_string(r) + "-" + std::to_string(k));
+        }
+    }
+
+    // ---- 雷达：站点群 + 均匀分布 ----
+    size_t numSites = std::max<size_t>(1, static_cast<size_t>(std::sqrt(double(opt.numRadars)) / 3));
+    std::vector<Point2D> sites(numSites);
+    for (auto& s : sites) s = {rng.uniform(0, opt.extentX), rng.uniform(0, opt.extentY)};
+    double siteSpread = 0.04 * diag;
+
+    sc.radars.reserve(opt.numRadars);
+    for (size_t i = 0; i < opt.numRadars; i++) {
+        Point2D pos;
+        if (rng.uniform() < opt.clusteredFraction) {
+            const Point2D& s = sites[rng.index(numSites)];
+            pos = {clamp(s.x + siteSpread * rng.normal(), 0, opt.extentX),
+                   clamp(s.y + siteSpread * rng.normal(), 0, opt.extentY)};
+        } else {
+            pos = {rng.uniform(0, opt.extentX), rng.uniform(0, opt.extentY)};
+        }
+
+        double range = clamp(rng.logNormal(opt.medianRadarRange, 0.45),
+                             opt.minRadarRange, opt.maxRadarRange);
+        double height = clamp(rng.logNormal(opt.medianAntennaHeight, 0.5), 5.0, 300.0);
+
+        RadarParams radar(static_cast<int>(i + 1), "radar" + std::to_string(i + 1),
+                          pos, range, height);
+        if (rng.uniform() < opt.sectorFraction) {
+            double span = rng.uniform(M_PI / 2, 4 * M_PI / 3);
+            radar.azimuthStart = rng.uniform(0, 2 * M_PI);
+            radar.azimuthEnd = radar.azimuthStart + span;
+        }
+        sc.radars.push_back(std::move(radar));
+    }
+
+    return sc;
+}
+
+// ============================================================================
+// 分形 DEM
+// ============================================================================
+
+/**
+ * 菱形-方形算法生成高程栅格
+ *
+ * 每一级细分先做菱形步（方格中心 = 四角均值 + 扰动），再做方形步（边中点 =
+ * 上下左右均值 + 扰动；边界上取三点均值）；扰动幅度每级乘以 roughness。
+ * 同一级内各点只读取上一步的结果，按行并行。最后线性拉伸到
+ * [baseElevation, baseElevation + relief]。
+ *
+ * 用法:
+ *   auto dem = std::make_shared<const ElevationGrid>(generateFractalTerrain(opt));
+ *   terrain.setElevationFunction(ElevationGrid::asFunction(dem));
+ */
+inline ElevationGrid generateFractalTerrain(const FractalTerrainOptions& opt) {
+    using generator_detail::latticeNoise;
+
+    if (opt.cols < 2 || opt.rows < 2 || !(opt.cellSize > 0)) {
+        throw std::invalid_argument("FractalTerrain: need at least 2x2 cells and cellSize > 0");
+    }
+    if (!(opt.roughness > 0 && opt.roughness < 1) || !(opt.relief >= 0)) {
+        throw std::invalid_argument("FractalTerrain: need 0 < roughness < 1 and relief >= 0");
+    }
+
+    uint32_t n = 2;
+    while (n + 1 < std::max(opt.cols, opt.rows)) {
+        if (n > (1u << 30)) throw std::invalid_argument("FractalTerrain: grid too large");
+        n *= 2;
+    }
+    const uint32_t size = n + 1;
+
+    ElevationGrid work(size, size, opt.originX, opt.originY, opt.cellSize);
+    float* h = &work.at(0, 0);
+    auto cell = [h, size](uint32_t x, uint32_t y) -> float& {
+        return h[static_cast<size_t>(y) * size + x];
+    };
+    const uint64_t seed = opt.seed;
+
+    cell(0, 0) = static_cast<float>(latticeNoise(seed, 0, 0));
+    cell(n, 0) = static_cast<float>(latticeNoise(seed, n, 0));
+    cell(0, n) = static_cast<float>(latticeNoise(seed, 0, n));
+    cell(n, n) = static_cast<float>(latticeNoise(seed, n, n));
+
+    double amplitude = 1.0;
+    for (uint32_t step = n; step > 1; step /= 2) {
+        const uint32_t half = step / 2;
+        const size_t grain = std::max<size_t>(1, 4096 / (n / step + 1));
+
+        // 菱形步：每个方格中心
+        polygon_ops::parallelFor(n / step, opt.threads, [&](size_t j, size_t) {
+            uint32_t y = static_cast<uint32_t>(j) * step + half;
+            for (uint32_t x = half; x < n; x += step) {
+                double avg = (cell(x - half, y - half) + cell(x + half, y - half) +
+                              cell(x - half, y + half) + cell(x + half, y + half)) * 0.25;
+                cell(x, y) = static_cast<float>(avg + amplitude * latticeNoise(seed, x, y));
+            }
+        }, grain);
+
+        // 方形步：(x + y) / half 为奇数的格点
+        polygon_ops::parallelFor(n / half + 1, opt.threads, [&](size_t j, size_t) {
+            uint32_t y = static_cast<uint32_t>(j) * half;
+            for (uint32_t x = (j % 2 == 0) ? half : 0; x <= n; x += step) {
+                double sum = 0.0;
+                int count = 0;
+                if (x >= half) { sum += cell(x - half, y); count++; }
+                if (x + half <= n) { sum += cell(x + half, y); count++; }
+                if (y >= half) { sum += cell(x, y - half); count++; }
+                if (y + half <= n) { sum += cell(x, y + half); count++; }
+                cell(x, y) = static_cast<float>(sum / count + amplitude * latticeNoise(seed, x, y));
+            }
+        }, grain);
+
+        amplitude *= opt.roughness;
+    }
+
+    // 裁剪到目标尺寸
+    ElevationGrid grid;
+    if (opt.cols == size && opt.rows == size) {
+        grid = std::move(work);
+    } else {
+        grid = ElevationGrid(opt.cols, opt.rows, opt.originX, opt.originY, opt.cellSize);
+        for (uint32_t r = 0; r < opt.rows; r++) {
+            std::memcpy(&grid.at(0, r), &work.at(0, r), opt.cols * sizeof(float));
+        }
+    }
+
+    // 拉伸到目标高程范围
+    float* out = &grid.at(0, 0);
+    const size_t cells = static_cast<size_t>(opt.cols) * opt.rows;
+    auto [lo, hi] = std::minmax_element(out, out + cells);
+    const double minH = *lo;
+    const double span = *hi - minH;
+    const double scale = span > 0 ? opt.relief / span : 0.0;
+    polygon_ops::parallelFor(opt.rows, opt.threads, [&](size_t r, size_t) {
+        float* row = out + r * opt.cols;
+        for (uint32_t c = 0; c < opt.cols; c++) {
+            row[c] = static_cast<float>(opt.baseElevation + (row[c] - minH) * scale);
+        }
+    }, 64);
+
+    return grid;
+}
+
+} // namespace radar_coverage
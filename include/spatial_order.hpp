@@ -0,0 +1,108 @@
+/**
+ * spatial_order.hpp
+ *
+ * 空间填充曲线排序 - 让相邻处理的对象在空间上也相邻（瓦片调度、缓存复用）
+ *
+ * 依赖: polygon_boolean.hpp
+ */
+
+#pragma once
+
+#include "polygon_boolean.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace radar_coverage {
+
+using polygon_ops::Point2D;
+
+/**
+ * 两个 32 位坐标按位交错（Z 序 / Morton 码）
+ */
+inline uint64_t mortonCode(uint32_t x, uint32_t y) {
+    auto spread = [](uint64_t v) {
+        v &= 0xFFFFFFFFull;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+/**
+ * 2^16 x 2^16 网格上的 Hilbert 曲线序号
+ *
+ * 与 Morton 序相比没有跨象限的长跳跃，相邻序号总是相邻格子，适合有缓存的调度。
+ */
+inline uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    const uint32_t n = 1u << 16;
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+namespace spatial_detail {
+
+/**
+ * 坐标按包围盒量化到 2^16 x 2^16 网格，按 key(qx, qy) 稳定排序后返回下标
+ */
+template <typename KeyFn>
+std::vector<size_t> curveOrder(const std::vector<Point2D>& points, KeyFn key) {
+    std::vector<size_t> order(points.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    if (points.size() < 2) return order;
+
+    double minX = points[0].x, minY = points[0].y, maxX = minX, maxY = minY;
+    for (const auto& p : points) {
+        minX = std::min(minX, p.x);
+        minY = std::min(minY, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+    const double cells = 65535.0;
+    double sx = maxX > minX ? cells / (maxX - minX) : 0.0;
+    double sy = maxY > minY ? cells / (maxY - minY) : 0.0;
+
+    std::vector<uint64_t> keys(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        keys[i] = key(static_cast<uint32_t>((points[i].x - minX) * sx),
+                      static_cast<uint32_t>((points[i].y - minY) * sy));
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    return order;
+}
+
+} // namespace spatial_detail
+
+/**
+ * 点集按 Morton 码排序后的下标
+ */
+inline std::vector<size_t> mortonOrder(const std::vector<Point2D>& points) {
+    return spatial_detail::curveOrder(points, mortonCode);
+}
+
+/**
+ * 点集按 Hilbert 序排序后的下标
+ */
+inline std::vector<size_t> hilbertOrder(const std::vector<Point2D>& points) {
+    return spatial_detail::curveOrder(points, hilbertIndex);
+}
+
+} // namespace radar_coverage
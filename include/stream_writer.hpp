@@ -0,0 +1,241 @@
+/**
+ * stream_writer.hpp
+ *
+ * 带缓冲的流式输出 - 各导出器 (GeoJSON / WKB / SVG ...) 的公共底层
+ *
+ * - 大块缓冲，满后一次性写入文件或回调 sink，不在内存中拼接整个文档
+ * - 数字格式化使用 std::to_chars，与 locale 无关
+ *
+ * 依赖: 无 (需要支持浮点 std::to_chars 的标准库, 如 GCC 11+)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 缓冲写入器
+// ============================================================================
+
+class BufferedWriter {
+public:
+    using SinkFunction = std::function<void(const char* data, size_t size)>;
+
+    static constexpr size_t kDefaultBufferSize = 1 << 20;
+
+    /**
+     * 写入文件（二进制模式）
+     */
+    explicit BufferedWriter(const std::string& path,
+                            size_t bufferSize = kDefaultBufferSize)
+        : file_(std::fopen(path.c_str(), "wb")), ownsFile_(true) {
+        if (!file_) {
+            throw std::runtime_error("BufferedWriter: cannot open " + path);
+        }
+        init(bufferSize);
+    }
+
+    /**
+     * 写入任意 sink（网络、内存、压缩流 ...）
+     */
+    explicit BufferedWriter(SinkFunction sink,
+                            size_t bufferSize = kDefaultBufferSize)
+        : sink_(std::move(sink)) {
+        init(bufferSize);
+    }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    ~BufferedWriter() {
+        try {
+            close();
+        } catch (...) {
+            // 析构中不抛出；需要错误信息请显式调用 close()
+        }
+    }
+
+    void write(const char* data, size_t size) {
+        if (size > buffer_.size() - used_) {
+            flush();
+            if (size >= buffer_.size()) {
+                emit(data, size);
+                return;
+            }
+        }
+        std::memcpy(buffer_.data() + used_, data, size);
+        used_ += size;
+    }
+
+    void write(const std::string& s) { write(s.data(), s.size()); }
+
+    template <size_t N>
+    void writeLiteral(const char (&s)[N]) { write(s, N - 1); }
+
+    void put(char c) {
+        if (used_ == buffer_.size()) flush();
+        buffer_[used_++] = c;
+    }
+
+    /**
+     * 写入浮点数
+     *
+     * @param precision <0: 最短往返表示; >=0: 定点小数位数（去除末尾 0）
+     */
+    void writeDouble(double v, int precision = -1) {
+        char* p = reserve(kMaxNumberChars);
+        used_ += formatDouble(p, v, precision) - p;
+    }
+
+    void writeInt(int64_t v) {
+        char* p = reserve(kMaxNumberChars);
+        used_ += std::to_chars(p, p + kMaxNumberChars, v).ptr - p;
+    }
+
+    void writeUInt(uint64_t v) {
+        char* p = reserve(kMaxNumberChars);
+        used_ += std::to_chars(p, p + kMaxNumberChars, v).ptr - p;
+    }
+
+    /**
+     * 以小端字节序写入定长数值（WKB 等二进制格式）
+     */
+    template <typename T>
+    void writeLE(T v) {
+        static_assert(std::is_arithmetic<T>::value, "writeLE expects arithmetic type");
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+        if (!isLittleEndian()) {
+            for (size_t i = 0; i < sizeof(T) / 2; i++) {
+                std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+        }
+        write(bytes, sizeof(T));
+    }
+
+    void flush() {
+        if (used_ > 0) {
+            emit(buffer_.data(), used_);
+            used_ = 0;
+        }
+    }
+
+    void close() {
+        flush();
+        if (file_ && ownsFile_) {
+            bool ok = std::fclose(file_) == 0;
+            file_ = nullptr;
+            if (!ok) throw std::runtime_error("BufferedWriter: close failed");
+        }
+    }
+
+    uint64_t bytesWritten() const { return flushed_ + used_; }
+
+    /**
+     * 格式化浮点数到 out（需至少 kMaxNumberChars 字节），返回结尾指针
+     */
+    static char* formatDouble(char* out, double v, int precision) {
+        if (v == 0.0) v = 0.0;  // 统一 -0 为 0
+
+        if (precision < 0) {
+            return std::to_chars(out, out + kMaxNumberChars, v).ptr;
+        }
+
+        precision = std::min(precision, 17);
+        char* end = std::to_chars(out, out + kMaxNumberChars, v,
+                                  std::chars_format::fixed, precision).ptr;
+        if (precision > 0 && std::isfinite(v)) {
+            while (end[-1] == '0') --end;
+            if (end[-1] == '.') --end;
+        }
+        // 舍入后为 0 的负数（如 -0.0001 保留 2 位）
+        if (end - out == 2 && out[0] == '-' && out[1] == '0') {
+            out[0] = '0';
+            end = out + 1;
+        }
+        return end;
+    }
+
+    static bool isLittleEndian() {
+        const uint16_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    // 定点格式下 DBL_MAX 约 309 位整数 + 小数位
+    static constexpr size_t kMaxNumberChars = 352;
+
+private:
+    void init(size_t bufferSize) {
+        buffer_.resize(std::max(bufferSize, kMaxNumberChars * 2));
+    }
+
+    char* reserve(size_t n) {
+        if (buffer_.size() - used_ < n) flush();
+        return buffer_.data() + used_;
+    }
+
+    void emit(const char* data, size_t size) {
+        if (file_) {
+            if (std::fwrite(data, 1, size, file_) != size) {
+                throw std::runtime_error("BufferedWriter: write failed");
+            }
+        } else if (sink_) {
+            sink_(data, size);
+        }
+        flushed_ += size;
+    }
+
+    std::FILE* file_ = nullptr;
+    bool ownsFile_ = false;
+    SinkFunction sink_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    uint64_t flushed_ = 0;
+};
+
+// ============================================================================
+// JSON 字符串
+// ============================================================================
+
+/**
+ * 写入 JSON 字符串（含引号与转义）
+ */
+inline void writeJsonString(BufferedWriter& out, const std::string& s) {
+    static const char* hex = "0123456789abcdef";
+    out.put('"');
+    for (char c : s) {
+        switch (c) {
+            case '"':  out.writeLiteral("\\\""); break;
+            case '\\': out.writeLiteral("\\\\"); break;
+            case '\n': out.writeLiteral("\\n"); break;
+            case '\r': out.writeLiteral("\\r"); break;
+            case '\t': out.writeLiteral("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char esc[6] = {'\\', 'u', '0', '0',
+                                   hex[(c >> 4) & 0xF], hex[c & 0xF]};
+                    out.write(esc, 6);
+                } else {
+                    out.put(c);
+                }
+        }
+    }
+    out.put('"');
+}
+
+} // namespace radar_coverage
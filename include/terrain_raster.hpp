@@ -0,0 +1,238 @@
+/**
+ * terrain_raster.hpp
+ *
+ * 规则格网 DEM（高程栅格）及其二进制文件格式
+ *
+ * 文件格式 .rcdem（小端）:
+ *   "RCDEM001"                8 字节魔数
+ *   cols u32, rows u32
+ *   originX f64, originY f64  西南角（第 0 行第 0 列像元中心）
+ *   cellSize f64
+ *   float32[rows * cols]      行主序，第 0 行位于 originY（由南向北）
+ *
+ * 加载使用内存映射，栅格数据直接引用映射区，不做拷贝。
+ *
+ * 依赖: checksum.hpp, mapped_file.hpp, stream_writer.hpp
+ */
+
+#pragma once
+
+#include "checksum.hpp"
+#include "mapped_file.hpp"
+#include "stream_writer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 高程栅格
+// ============================================================================
+
+class ElevationGrid {
+public:
+    static constexpr size_t kHeaderSize = 8 + 4 + 4 + 8 * 3;
+
+    ElevationGrid() = default;
+
+    /**
+     * 创建内存栅格（初始高程为 0）
+     */
+    ElevationGrid(uint32_t cols, uint32_t rows, double originX, double originY, double cellSize)
+        : cols_(cols), rows_(rows), originX_(originX), originY_(originY), cellSize_(cellSize),
+          owned_(static_cast<size_t>(cols) * rows, 0.0f) {
+        if (cols < 2 || rows < 2 || !(cellSize > 0)) {
+            throw std::invalid_argument("ElevationGrid: need at least 2x2 cells and cellSize > 0");
+        }
+        data_ = owned_.data();
+    }
+
+    ElevationGrid(const ElevationGrid& o) { *this = o; }
+    ElevationGrid(ElevationGrid&&) noexcept = default;
+    ElevationGrid& operator=(ElevationGrid&&) noexcept = default;
+
+    ElevationGrid& operator=(const ElevationGrid& o) {
+        if (this == &o) return *this;
+        cols_ = o.cols_;
+        rows_ = o.rows_;
+        originX_ = o.originX_;
+        originY_ = o.originY_;
+        cellSize_ = o.cellSize_;
+        mapping_ = o.mapping_;
+        owned_ = o.owned_;
+        data_ = mapping_ ? o.data_ : owned_.data();
+        return *this;
+    }
+
+    /**
+     * (x, y) 是否落在栅格范围内（含边界）
+     */
+    bool contains(double x, double y) const {
+        double fx = (x - originX_) / cellSize_;
+        double fy = (y - originY_) / cellSize_;
+        return fx >= 0.0 && fy >= 0.0 && fx <= cols_ - 1 && fy <= rows_ - 1;
+    }
+
+    /**
+     * 双线性插值采样；范围外返回 0
+     */
+    double sample(double x, double y) const {
+        double fx = (x - originX_) / cellSize_;
+        double fy = (y - originY_) / cellSize_;
+        if (!(fx >= 0.0 && fy >= 0.0 && fx <= cols_ - 1 && fy <= rows_ - 1)) return 0.0;
+
+        uint32_t c0 = std::min(static_cast<uint32_t>(fx), cols_ - 2);
+        uint32_t r0 = std::min(static_cast<uint32_t>(fy), rows_ - 2);
+        double tx = fx - c0;
+        double ty = fy - r0;
+
+        const float* row0 = data_ + static_cast<size_t>(r0) * cols_ + c0;
+        const float* row1 = row0 + cols_;
+        double a = row0[0] + (row0[1] - row0[0]) * tx;
+        double b = row1[0] + (row1[1] - row1[0]) * tx;
+        return a + (b - a) * ty;
+    }
+
+    /**
+     * 批量采样（坐标为结构数组）
+     */
+    void sample(const double* x, const double* y, double* out, size_t n) const {
+        for (size_t i = 0; i < n; i++) out[i] = sample(x[i], y[i]);
+    }
+
+    float at(uint32_t col, uint32_t row) const { return data_[static_cast<size_t>(row) * cols_ + col]; }
+
+    /**
+     * 可写访问（仅内存栅格；映射自文件的栅格为只读）
+     */
+    float& at(uint32_t col, uint32_t row) {
+        if (mapping_) throw std::logic_error("ElevationGrid: mapped grid is read-only");
+        return owned_[static_cast<size_t>(row) * cols_ + col];
+    }
+
+    /**
+     * 适配 TerrainModel::setElevationFunction（共享栅格，不复制数据）
+     */
+    static std::function<double(double, double)> asFunction(std::shared_ptr<const ElevationGrid> grid) {
+        return [grid](double x, double y) { return grid->sample(x, y); };
+    }
+
+    uint32_t cols() const { return cols_; }
+    uint32_t rows() const { return rows_; }
+    double originX() const { return originX_; }
+    double originY() const { return originY_; }
+    double cellSize() const { return cellSize_; }
+    double maxX() const { return originX_ + (cols_ - 1) * cellSize_; }
+    double maxY() const { return originY_ + (rows_ - 1) * cellSize_; }
+    const float* data() const { return data_; }
+    size_t memoryBytes() const { return owned_.size() * sizeof(float); }
+
+    /**
+     * 栅格几何与全部高程的校验和（持久缓存的地形键）
+     */
+    uint64_t checksum() const {
+        Hasher64 h;
+        h.add(cols_).add(rows_).add(originX_).add(originY_).add(cellSize_);
+        h.update(data_, static_cast<size_t>(cols_) * rows_ * sizeof(float));
+        return h.digest();
+    }
+
+    // ------------------------------------------------------------------------
+    // 文件读写
+    // ------------------------------------------------------------------------
+
+    static ElevationGrid load(const std::string& path) {
+        auto file = std::make_shared<MappedFile>(path);
+        const uint8_t* p = file->data();
+        if (file->size() < kHeaderSize || std::memcmp(p, "RCDEM001", 8) != 0) {
+            throw std::runtime_error("ElevationGrid: not an .rcdem file: " + path);
+        }
+        if (!BufferedWriter::isLittleEndian()) {
+            throw std::runtime_error("ElevationGrid: big-endian hosts are not supported");
+        }
+
+        ElevationGrid g;
+        std::memcpy(&g.cols_, p + 8, 4);
+        std::memcpy(&g.rows_, p + 12, 4);
+        std::memcpy(&g.originX_, p + 16, 8);
+        std::memcpy(&g.originY_, p + 24, 8);
+        std::memcpy(&g.cellSize_, p + 32, 8);
+
+        size_t cells = static_cast<size_t>(g.cols_) * g.rows_;
+        if (g.cols_ < 2 || g.rows_ < 2 || !(g.cellSize_ > 0) ||
+            (file->size() - kHeaderSize) / sizeof(float) < cells) {
+            throw std::runtime_error("ElevationGrid: corrupt header or truncated data: " + path);
+        }
+        g.mapping_ = file;
+        g.data_ = reinterpret_cast<const float*>(p + kHeaderSize);
+        return g;
+    }
+
+    void save(const std::string& path) const {
+        BufferedWriter out(path);
+        out.writeLiteral("RCDEM001");
+        out.writeLE<uint32_t>(cols_);
+        out.writeLE<uint32_t>(rows_);
+        out.writeLE<double>(originX_);
+        out.writeLE<double>(originY_);
+        out.writeLE<double>(cellSize_);
+        out.write(reinterpret_cast<const char*>(data_),
+                  static_cast<size_t>(cols_) * rows_ * sizeof(float));
+        out.close();
+    }
+
+private:
+    uint32_t cols_ = 0, rows_ = 0;
+    double originX_ = 0, originY_ = 0, cellSize_ = 1;
+    std::shared_ptr<MappedFile> mapping_;
+    std::vector<float> owned_;
+    const float* data_ = nullptr;
+};
+
+// ============================================================================
+// 栅格缓存（多场景共享同一 DEM）
+// ============================================================================
+
+class ElevationGridCache {
+public:
+    /**
+     * 按路径加载；同一路径只映射一次（线程安全）
+     */
+    std::shared_ptr<const ElevationGrid> get(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = grids_.find(path);
+        if (it != grids_.end()) {
+            hits_++;
+            return it->second;
+        }
+        auto grid = std::make_shared<const ElevationGrid>(ElevationGrid::load(path));
+        grids_.emplace(path, grid);
+        return grid;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return grids_.size();
+    }
+
+    size_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const ElevationGrid>> grids_;
+    size_t hits_ = 0;
+};
+
+} // namespace radar_coverage
@@ -0,0 +1,314 @@
+/**
+ * tiled_coverage.hpp
+ *
+ * 大范围分块计算 - 按固定世界瓦片求并，单瓦片内存有界、瓦片间并行
+ *
+ * - 每部雷达按量程圆分配到与之相交的世界瓦片（原点对齐，边长 tileSize）；
+ *   雷达数超过 maxRadarsPerTile 的瓦片递归四分，直到不再减少或到达 maxSubdivision 层
+ * - 各瓦片在工作线程上独立求并、简化、平滑，最后用 Clipper2 RectClip 裁剪到瓦片边界，
+ *   完成后立即交给回调（可写出后丢弃），不保留全局结果
+ * - 单雷达覆盖在第一个需要它的瓦片中生成，最后一个引用它的瓦片完成后释放；
+ *   瓦片按 Hilbert 序领取，驻留的单雷达覆盖（及分块 DEM 的瓦片）只限于正在处理的一带
+ * - stitchTiles 按同样的 Hilbert 序两两并行合并瓦片，得到无接缝的全局结果（可选）
+ *
+ * 瓦片内只包含量程圆与该瓦片相交的雷达，因此裁剪后的瓦片结果与全局并集在该瓦片内一致；
+ * 开启简化时，相邻瓦片在接缝处可能有不超过简化容差的错位。
+ *
+ * 用法:
+ *   TiledCoverageOptions opt;
+ *   opt.tileSize = 200000;
+ *   computeTiledCoverage(radars, terrain, opt, [&](CoverageTile&& tile) {
+ *       writeTile(tile.id, tile.coverage);
+ *   });
+ *
+ * 依赖: radar_coverage.hpp, spatial_order.hpp
+ */
+
+#pragma once
+
+#include "radar_coverage.hpp"
+#include "spatial_order.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 参数与结果
+// ============================================================================
+
+struct TiledCoverageOptions {
+    double tileSize = 200000.0;         // 0 层世界瓦片边长 (米)
+    int numRays = 72;
+    double simplifyEpsilon = 5.0;
+    int smoothIterations = 1;
+    size_t numThreads = 0;              // 0 = 硬件线程数
+    size_t maxRadarsPerTile = 0;        // 0 = 不细分
+    int maxSubdivision = 4;             // 最多四分的层数
+    CoverageMergeManager::CoverageGenerator generator;     // 空 = generateCoveragePolygon
+};
+
+/**
+ * 瓦片编号：level 层瓦片边长为 tileSize / 2^level，(x, y) = floor(坐标 / 边长)
+ */
+struct WorldTileId {
+    int level = 0;
+    int64_t x = 0;
+    int64_t y = 0;
+};
+
+struct CoverageTile {
+    WorldTileId id;
+    PolygonUtils::BoundingBox bounds{0, 0, 0, 0};
+    std::vector<size_t> radars;         // 量程圆与瓦片相交的雷达下标
+    MultiPolygon coverage;              // 已裁剪到 bounds
+};
+
+struct TiledCoverageStats {
+    size_t tiles = 0;
+    size_t subdividedTiles = 0;         // 被四分的瓦片数（各层累计）
+    size_t radarAssignments = 0;        // 雷达-瓦片对数
+    size_t maxTileRadars = 0;
+    size_t maxTileVertices = 0;         // 单瓦片并集的最大顶点数（单瓦片内存的主要部分）
+    size_t maxLiveCoverages = 0;        // 同时驻留的单雷达覆盖峰值
+    double totalMs = 0.0;
+};
+
+// ============================================================================
+// 瓦片规划
+// ============================================================================
+
+namespace tiled_detail {
+
+inline bool circleIntersectsBox(const RadarParams& r, const PolygonUtils::BoundingBox& b) {
+    double dx = r.position.x - std::max(b.minX, std::min(r.position.x, b.maxX));
+    double dy = r.position.y - std::max(b.minY, std::min(r.position.y, b.maxY));
+    return dx * dx + dy * dy < r.range * r.range;
+}
+
+inline PolygonUtils::BoundingBox tileBounds(const WorldTileId& id, double tileSize) {
+    double size = std::ldexp(tileSize, -id.level);
+    return {id.x * size, id.y * size, (id.x + 1) * size, (id.y + 1) * size};
+}
+
+inline void subdivide(CoverageTile tile, const std::vector<RadarParams>& radars,
+                      const TiledCoverageOptions& options, std::vector<CoverageTile>& out,
+                      TiledCoverageStats& stats) {
+    if (options.maxRadarsPerTile == 0 || tile.radars.size() <= options.maxRadarsPerTile ||
+        tile.id.level >= options.maxSubdivision) {
+        out.push_back(std::move(tile));
+        return;
+    }
+
+    CoverageTile children[4];
+    size_t largest = 0;
+    for (int q = 0; q < 4; q++) {
+        CoverageTile& c = children[q];
+        c.id = {tile.id.level + 1, 2 * tile.id.x + (q & 1), 2 * tile.id.y + (q >> 1)};
+        c.bounds = tileBounds(c.id, options.tileSize);
+        for (size_t r : tile.radars) {
+            if (circleIntersectsBox(radars[r], c.bounds)) c.radars.push_back(r);
+        }
+        largest = std::max(largest, c.radars.size());
+    }
+    // 雷达都覆盖整个瓦片时四分无济于事
+    if (largest == tile.radars.size()) {
+        out.push_back(std::move(tile));
+        return;
+    }
+    stats.subdividedTiles++;
+    for (auto& c : children) {
+        if (!c.radars.empty()) subdivide(std::move(c), radars, options, out, stats);
+    }
+}
+
+} // namespace tiled_detail
+
+/**
+ * 把雷达按量程圆分配到瓦片（含细分），瓦片与瓦片内的雷达均按 Hilbert 序排列；不含无雷达的瓦片
+ */
+inline std::vector<CoverageTile> planTiles(const std::vector<RadarParams>& radars,
+                                           const TiledCoverageOptions& options,
+                                           TiledCoverageStats* stats = nullptr) {
+    if (!(options.tileSize > 0)) throw std::invalid_argument("planTiles: tileSize must be > 0");
+
+    std::map<std::pair<int64_t, int64_t>, std::vector<size_t>> byTile;
+    std::vector<Point2D> sites;
+    sites.reserve(radars.size());
+    for (const auto& r : radars) sites.push_back(r.position);
+    for (size_t i : hilbertOrder(sites)) {
+        const RadarParams& r = radars[i];
+        int64_t x0 = static_cast<int64_t>(std::floor((r.position.x - r.range) / options.tileSize));
+        int64_t x1 = static_cast<int64_t>(std::floor((r.position.x + r.range) / options.tileSize));
+        int64_t y0 = static_cast<int64_t>(std::floor((r.position.y - r.range) / options.tileSize));
+        int64_t y1 = static_cast<int64_t>(std::floor((r.position.y + r.range) / options.tileSize));
+        for (int64_t ty = y0; ty <= y1; ty++) {
+            for (int64_t tx = x0; tx <= x1; tx++) {
+                WorldTileId id{0, tx, ty};
+                if (tiled_detail::circleIntersectsBox(r, tiled_detail::tileBounds(id, options.tileSize))) {
+                    byTile[{tx, ty}].push_back(i);
+                }
+            }
+        }
+    }
+
+    TiledCoverageStats local;
+    std::vector<CoverageTile> tiles;
+    for (auto& entry : byTile) {
+        CoverageTile tile;
+        tile.id = {0, entry.first.first, entry.first.second};
+        tile.bounds = tiled_detail::tileBounds(tile.id, options.tileSize);
+        tile.radars = std::move(entry.second);
+        tiled_detail::subdivide(std::move(tile), radars, options, tiles, local);
+    }
+
+    std::vector<Point2D> centers;
+    centers.reserve(tiles.size());
+    for (const auto& t : tiles) centers.push_back(t.bounds.center());
+    std::vector<size_t> order = hilbertOrder(centers);
+    std::vector<CoverageTile> sorted;
+    sorted.reserve(tiles.size());
+    for (size_t i : order) sorted.push_back(std::move(tiles[i]));
+
+    if (stats) {
+        stats->tiles = sorted.size();
+        stats->subdividedTiles = local.subdividedTiles;
+        for (const auto& t : sorted) {
+            stats->radarAssignments += t.radars.size();
+            stats->maxTileRadars = std::max(stats->maxTileRadars, t.radars.size());
+        }
+    }
+    return sorted;
+}
+
+// ============================================================================
+// 分块计算
+// ============================================================================
+
+/**
+ * 逐瓦片计算覆盖；每完成一个非空瓦片调用一次 sink（在工作线程上串行调用）
+ */
+inline TiledCoverageStats computeTiledCoverage(const std::vector<RadarParams>& radars,
+                                               const TerrainModel& terrain,
+                                               const TiledCoverageOptions& options,
+                                               const std::function<void(CoverageTile&&)>& sink) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("computeTiledCoverage", "tiled", "radars", radars.size());
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    TiledCoverageStats stats;
+    std::vector<CoverageTile> tiles = planTiles(radars, options, &stats);
+
+    // 单雷达覆盖：首次需要时生成，引用计数归零时释放
+    std::vector<Polygon> coverages(radars.size());
+    std::unique_ptr<std::once_flag[]> generated(new std::once_flag[radars.size()]);
+    std::unique_ptr<std::atomic<uint32_t>[]> refs(new std::atomic<uint32_t>[radars.size()]);
+    for (size_t i = 0; i < radars.size(); i++) refs[i].store(0, std::memory_order_relaxed);
+    for (const auto& t : tiles) {
+        for (size_t r : t.radars) refs[r].fetch_add(1, std::memory_order_relaxed);
+    }
+    std::atomic<size_t> live{0}, maxLive{0}, maxVertices{0};
+    auto raiseTo = [](std::atomic<size_t>& peak, size_t v) {
+        size_t cur = peak.load(std::memory_order_relaxed);
+        while (v > cur && !peak.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+    };
+
+    std::mutex sinkMutex;
+    polygon_ops::parallelFor(tiles.size(), options.numThreads, [&](size_t t, size_t) {
+        CoverageTile& tile = tiles[t];
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("unionTile", "tiled", "radars", tile.radars.size());
+
+        std::vector<Polygon> polygons;
+        polygons.reserve(tile.radars.size());
+        for (size_t r : tile.radars) {
+            std::call_once(generated[r], [&]() {
+                coverages[r] = options.generator
+                    ? options.generator(radars[r], terrain, options.numRays, nullptr)
+                    : generateCoveragePolygon(radars[r], terrain, options.numRays);
+                raiseTo(maxLive, live.fetch_add(1, std::memory_order_relaxed) + 1);
+            });
+            polygons.push_back(coverages[r]);
+        }
+        for (size_t r : tile.radars) {
+            if (refs[r].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Polygon().swap(coverages[r]);
+                live.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        MultiPolygon merged = PolygonBoolean::unionAll(polygons);
+        std::vector<Polygon>().swap(polygons);
+        size_t vertices = 0;
+        for (const auto& pwh : merged) {
+            vertices += pwh.outer.size();
+            for (const auto& hole : pwh.holes) vertices += hole.size();
+        }
+        raiseTo(maxVertices, vertices);
+
+        if (options.simplifyEpsilon > 0) {
+            merged = PolygonProcessor::simplifyAll(merged, options.simplifyEpsilon);
+        }
+        if (options.smoothIterations > 0) {
+            merged = PolygonProcessor::smoothAll(merged, options.smoothIterations);
+        }
+        // 后处理后再裁剪：瓦片边界保持为精确直线，相邻瓦片可直接拼接
+        tile.coverage = PolygonBoolean::classifyResult(PolygonBoolean::clipToRect(merged, tile.bounds));
+        if (tile.coverage.empty()) return;
+
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        sink(std::move(tile));
+        MultiPolygon().swap(tile.coverage);
+    });
+
+    stats.maxLiveCoverages = maxLive.load();
+    stats.maxTileVertices = maxVertices.load();
+    stats.totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return stats;
+}
+
+// ============================================================================
+// 接缝拼接
+// ============================================================================
+
+/**
+ * 把各瓦片结果合并为一个全局结果
+ *
+ * 瓦片按 Hilbert 序（与 planTiles 相同）两两合并，同层并行，避免把所有瓦片一次送入单个并集。
+ * 序中相邻的两块通常离得近，但细分与空瓦片使之不一定共边，结果不依赖于此。
+ */
+inline MultiPolygon stitchTiles(const std::vector<CoverageTile>& tiles, size_t numThreads = 0) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("stitchTiles", "tiled", "tiles", tiles.size());
+    if (tiles.empty()) return {};
+
+    std::vector<Point2D> centers;
+    centers.reserve(tiles.size());
+    for (const auto& t : tiles) centers.push_back(t.bounds.center());
+    std::vector<size_t> order = hilbertOrder(centers);
+
+    std::vector<polygon_ops::ClipperPaths> level(tiles.size());
+    for (size_t i = 0; i < order.size(); i++) level[i] = PolygonBoolean::toPaths(tiles[order[i]].coverage);
+
+    while (level.size() > 1) {
+        std::vector<polygon_ops::ClipperPaths> next((level.size() + 1) / 2);
+        polygon_ops::parallelFor(next.size(), numThreads, [&](size_t i, size_t) {
+            if (2 * i + 1 < level.size()) {
+                next[i] = PolygonBoolean::combine(Clipper2Lib::ClipType::Union,
+                                                  level[2 * i], level[2 * i + 1]);
+            } else {
+                next[i] = std::move(level[2 * i]);
+            }
+        });
+        level.swap(next);
+    }
+    return PolygonBoolean::classifyResult(level[0]);
+}
+
+} // namespace radar_coverage
@@ -0,0 +1,556 @@
+/**
+ * tiled_dem.hpp
+ *
+ * 分块 DEM - 超出内存的高程数据按瓦片从磁盘流式读取，经有字节上限的 LRU 缓存采样
+ *
+ * 文件格式 .rctdem（小端）:
+ *   "RCTDEM01"                8 字节魔数
+ *   cols u32, rows u32        整个格网的像元数（与 .rcdem 相同的像元中心约定）
+ *   tileCells u32             瓦片边长（像元间隔数）；每块存 (tileCells + 1)^2 个采样，
+ *                             相邻瓦片共享边界采样，双线性插值不跨瓦片
+ *   reserved u32 (= 0)
+ *   originX f64, originY f64  西南角像元中心
+ *   cellSize f64
+ *   float32 瓦片[]            瓦片按行主序（由南向北），块内同样行主序；
+ *                             右/上边缘瓦片超出格网的部分复制边缘采样
+ *
+ * 采样结果与同一格网的 ElevationGrid::sample 一致，内存占用只取决于缓存上限。
+ * 每个线程保留最近访问的一块瓦片（不加锁的快速路径），因此实际驻留
+ * 最多比上限多出每线程一块。
+ *
+ * 用法:
+ *   TiledDem::write(ElevationGrid::load("country.rcdem"), "country.rctdem", 256);
+ *   auto dem = std::make_shared<TiledDem>("country.rctdem", 8ull << 30);   // 8 GB 缓存
+ *   terrain.setElevationFunction(TiledDem::asFunction(dem));
+ *   ...
+ *   DemCacheStats s = dem->stats();   // s.hitRate()
+ *
+ * 依赖: terrain_raster.hpp, trace_events.hpp
+ */
+
+#pragma once
+
+#include "terrain_raster.hpp"
+#include "trace_events.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace radar_coverage {
+
+// ============================================================================
+// 瓦片与统计
+// ============================================================================
+
+struct DemTile {
+    uint32_t tx = 0, ty = 0;
+    std::vector<float> data;            // (tileCells + 1)^2，行主序
+};
+
+struct DemCacheStats {
+    uint64_t hits = 0;                  // 瓦片已在缓存中（含 threadHits）
+    uint64_t threadHits = 0;            // 其中由线程快速路径命中（按线程攒批计入，每线程最多滞后 64 次）
+    uint64_t misses = 0;                // 需要读盘（含等待其他线程正在读取的同一瓦片）
+    uint64_t evictions = 0;
+    uint64_t bytesRead = 0;
+    size_t residentBytes = 0;
+    size_t peakResidentBytes = 0;
+    size_t budgetBytes = 0;
+
+    uint64_t waits = 0;                 // 未命中但瓦片正由其他线程（含预取线程）读取
+    uint64_t prefetched = 0;            // 预取线程读入的瓦片数
+    uint64_t prefetchUsed = 0;          // 其中被计算线程用到的
+    uint64_t prefetchWasted = 0;        // 用到前即被淘汰的
+
+    double hitRate() const {
+        uint64_t lookups = hits + misses;
+        return lookups ? static_cast<double>(hits) / lookups : 0.0;
+    }
+};
+
+namespace dem_detail {
+
+/**
+ * 线程安全的定位读取（POSIX pread；其他平台串行 fseek + fread）
+ */
+class RandomAccessFile {
+public:
+    explicit RandomAccessFile(const std::string& path) : path_(path) {
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error("TiledDem: cannot open " + path);
+#else
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_) throw std::runtime_error("TiledDem: cannot open " + path);
+#endif
+    }
+
+    RandomAccessFile(const RandomAccessFile&) = delete;
+    RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+
+    ~RandomAccessFile() {
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+        if (fd_ >= 0) ::close(fd_);
+#else
+        if (file_) std::fclose(file_);
+#endif
+    }
+
+    /**
+     * @throws std::runtime_error 读取失败或文件过短
+     */
+    void read(uint64_t offset, void* out, size_t size) const {
+        uint8_t* p = static_cast<uint8_t*>(out);
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+        while (size > 0) {
+            ssize_t n = ::pread(fd_, p, size, static_cast<off_t>(offset));
+            if (n <= 0) throw std::runtime_error("TiledDem: short read from " + path_);
+            p += n;
+            offset += static_cast<uint64_t>(n);
+            size -= static_cast<size_t>(n);
+        }
+#else
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fread(p, 1, size, file_) != size) {
+            throw std::runtime_error("TiledDem: short read from " + path_);
+        }
+#endif
+    }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+#if defined(RADAR_COVERAGE_HAS_MMAP)
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+    mutable std::mutex mutex_;
+#endif
+};
+
+inline uint64_t nextSourceId() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+} // namespace dem_detail
+
+// ============================================================================
+// 分块 DEM
+// ============================================================================
+
+class TiledDem {
+public:
+    static constexpr size_t kHeaderSize = 8 + 4 * 4 + 8 * 3;
+
+    using TilePtr = std::shared_ptr<const DemTile>;
+
+    /**
+     * @param cacheBytes 缓存字节上限，至少容纳一块瓦片
+     * @throws std::runtime_error 文件格式错误；std::invalid_argument 上限过小
+     */
+    TiledDem(const std::string& path, size_t cacheBytes)
+        : file_(path), id_(dem_detail::nextSourceId()) {
+        uint8_t header[kHeaderSize];
+        file_.read(0, header, kHeaderSize);
+        if (std::memcmp(header, "RCTDEM01", 8) != 0) {
+            throw std::runtime_error("TiledDem: not an .rctdem file: " + path);
+        }
+        if (!BufferedWriter::isLittleEndian()) {
+            throw std::runtime_error("TiledDem: big-endian hosts are not supported");
+        }
+        std::memcpy(&cols_, header + 8, 4);
+        std::memcpy(&rows_, header + 12, 4);
+        std::memcpy(&tileCells_, header + 16, 4);
+        std::memcpy(&originX_, header + 24, 8);
+        std::memcpy(&originY_, header + 32, 8);
+        std::memcpy(&cellSize_, header + 40, 8);
+        if (cols_ < 2 || rows_ < 2 || tileCells_ < 1 || !(cellSize_ > 0)) {
+            throw std::runtime_error("TiledDem: corrupt header: " + path);
+        }
+        tilesX_ = (cols_ - 2) / tileCells_ + 1;
+        tilesY_ = (rows_ - 2) / tileCells_ + 1;
+        setCacheBudget(cacheBytes);
+    }
+
+    TiledDem(const TiledDem&) = delete;
+    TiledDem& operator=(const TiledDem&) = delete;
+
+    /**
+     * 双线性插值采样；范围外返回 0（与 ElevationGrid::sample 相同）
+     */
+    double sample(double x, double y) const {
+        double fx = (x - originX_) / cellSize_;
+        double fy = (y - originY_) / cellSize_;
+        if (!(fx >= 0.0 && fy >= 0.0 && fx <= cols_ - 1 && fy <= rows_ - 1)) return 0.0;
+
+        uint32_t tx = std::min(static_cast<uint32_t>(fx) / tileCells_, tilesX_ - 1);
+        uint32_t ty = std::min(static_cast<uint32_t>(fy) / tileCells_, tilesY_ - 1);
+        double lx = fx - static_cast<double>(tx) * tileCells_;
+        double ly = fy - static_cast<double>(ty) * tileCells_;
+        uint32_t c0 = std::min(static_cast<uint32_t>(lx), tileCells_ - 1);
+        uint32_t r0 = std::min(static_cast<uint32_t>(ly), tileCells_ - 1);
+        double t = lx - c0;
+        double u = ly - r0;
+
+        const DemTile& tile = tileForThread(tx, ty);
+        const size_t stride = tileCells_ + 1;
+        const float* row0 = tile.data.data() + r0 * stride + c0;
+        const float* row1 = row0 + stride;
+        double a = row0[0] + (row0[1] - row0[0]) * t;
+        double b = row1[0] + (row1[1] - row1[0]) * t;
+        return a + (b - a) * u;
+    }
+
+    /**
+     * 适配 TerrainModel::setElevationFunction（共享数据源）
+     */
+    static std::function<double(double, double)> asFunction(std::shared_ptr<const TiledDem> dem) {
+        return [dem](double x, double y) { return dem->sample(x, y); };
+    }
+
+    /**
+     * 取得一块瓦片：命中则移到 LRU 头部，否则读盘；并发请求同一瓦片时只读一次
+     */
+    TilePtr acquire(uint32_t tx, uint32_t ty) const {
+        if (tx >= tilesX_ || ty >= tilesY_) throw std::out_of_range("TiledDem: tile index out of range");
+        const uint64_t key = tileKey(tx, ty);
+
+        std::promise<TilePtr> promise;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                stats_.hits++;
+                consumePrefetchLocked(it->second->prefetchSeq);
+                it->second->prefetchSeq = 0;
+                lru_.splice(lru_.begin(), lru_, it->second);
+                return it->second->tile;
+            }
+            stats_.misses++;
+            auto pending = loading_.find(key);
+            if (pending != loading_.end()) {
+                stats_.waits++;
+                consumePrefetchLocked(pending->second.prefetchSeq);
+                pending->second.prefetchSeq = 0;
+                std::shared_future<TilePtr> wait = pending->second.tile;
+                lock.unlock();
+                return wait.get();
+            }
+            loading_.emplace(key, Loading{promise.get_future().share(), 0});
+        }
+        return finishLoad(tx, ty, promise);
+    }
+
+    /**
+     * 预取一块瓦片（由预取线程调用）；已驻留或正在读取时返回 false
+     *
+     * @param seq 预取序号（> 0，单调递增）；计算线程用到该瓦片时推进 prefetchProgress()
+     */
+    bool prefetch(uint32_t tx, uint32_t ty, uint64_t seq) const {
+        if (tx >= tilesX_ || ty >= tilesY_) return false;
+        const uint64_t key = tileKey(tx, ty);
+
+        std::promise<TilePtr> promise;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                // 计算线程已先读入：说明计算已推进到这里（不是预取读入的，不计入 prefetchUsed）
+                if (it->second->prefetchSeq == 0) advancePrefetchLocked(seq);
+                return false;
+            }
+            if (loading_.count(key)) return false;
+            loading_.emplace(key, Loading{promise.get_future().share(), seq});
+        }
+        finishLoad(tx, ty, promise);
+        return true;
+    }
+
+    /**
+     * 计算线程已用到的最大预取序号
+     */
+    uint64_t prefetchProgress() const { return prefetchProgress_.load(std::memory_order_acquire); }
+
+    /**
+     * 将 prefetchProgress() 推进到 seq（预取重新调度时调用）：此前排入的序号不再推动进度
+     */
+    void skipPrefetchTo(uint64_t seq) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        advancePrefetchLocked(seq);
+    }
+
+    /**
+     * 注册 prefetchProgress() 推进时的回调（在缓存锁内调用，回调不得再访问本 DEM）
+     *
+     * @return 用于 removeProgressListener 的标识
+     */
+    uint64_t addProgressListener(std::function<void()> listener) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listeners_.push_back({++nextListener_, std::move(listener)});
+        return nextListener_;
+    }
+
+    /**
+     * 注销回调；返回后该回调不会再被调用
+     */
+    void removeProgressListener(uint64_t id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+            if (it->first == id) {
+                listeners_.erase(it);
+                break;
+            }
+        }
+    }
+
+    /**
+     * 修改缓存上限（立即按新上限淘汰）
+     */
+    void setCacheBudget(size_t bytes) {
+        if (bytes < tileBytes()) {
+            throw std::invalid_argument("TiledDem: cache budget smaller than one tile");
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.budgetBytes = bytes;
+        evictLocked();
+    }
+
+    DemCacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DemCacheStats s = stats_;
+        s.threadHits = threadHits_->load(std::memory_order_relaxed);
+        s.hits += s.threadHits;
+        return s;
+    }
+
+    /**
+     * 清零命中/读盘计数（驻留量与上限保留）
+     */
+    void resetStats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.hits = stats_.misses = stats_.evictions = stats_.bytesRead = 0;
+        threadHits_->store(0, std::memory_order_relaxed);
+        stats_.waits = stats_.prefetched = stats_.prefetchUsed = stats_.prefetchWasted = 0;
+        stats_.peakResidentBytes = stats_.residentBytes;
+    }
+
+    /**
+     * 坐标所在瓦片；范围外返回 false
+     */
+    bool tileAt(double x, double y, uint32_t& tx, uint32_t& ty) const {
+        double fx = (x - originX_) / cellSize_;
+        double fy = (y - originY_) / cellSize_;
+        if (!(fx >= 0.0 && fy >= 0.0 && fx <= cols_ - 1 && fy <= rows_ - 1)) return false;
+        tx = std::min(static_cast<uint32_t>(fx) / tileCells_, tilesX_ - 1);
+        ty = std::min(static_cast<uint32_t>(fy) / tileCells_, tilesY_ - 1);
+        return true;
+    }
+
+    uint32_t cols() const { return cols_; }
+    uint32_t rows() const { return rows_; }
+    uint32_t tileCells() const { return tileCells_; }
+    uint32_t tilesX() const { return tilesX_; }
+    uint32_t tilesY() const { return tilesY_; }
+    double originX() const { return originX_; }
+    double originY() const { return originY_; }
+    double cellSize() const { return cellSize_; }
+    size_t tileBytes() const { return static_cast<size_t>(tileCells_ + 1) * (tileCells_ + 1) * sizeof(float); }
+    const std::string& path() const { return file_.path(); }
+
+    /**
+     * 整个文件内容的校验和（持久缓存的地形键）
+     *
+     * 顺序读一遍文件，不经过瓦片缓存；大文件上耗时可观，启动时算一次即可。
+     */
+    uint64_t checksum() const { return fileChecksum(path()); }
+
+    // ------------------------------------------------------------------------
+    // 转换
+    // ------------------------------------------------------------------------
+
+    /**
+     * 把规则格网写成分块格式；ElevationGrid::load 映射的大文件逐块读出，不整体载入内存
+     */
+    static void write(const ElevationGrid& grid, const std::string& path, uint32_t tileCells = 256) {
+        if (tileCells < 1) throw std::invalid_argument("TiledDem: tileCells must be >= 1");
+        const uint32_t cols = grid.cols(), rows = grid.rows();
+        const uint32_t tilesX = (cols - 2) / tileCells + 1;
+        const uint32_t tilesY = (rows - 2) / tileCells + 1;
+
+        BufferedWriter out(path);
+        out.writeLiteral("RCTDEM01");
+        out.writeLE<uint32_t>(cols);
+        out.writeLE<uint32_t>(rows);
+        out.writeLE<uint32_t>(tileCells);
+        out.writeLE<uint32_t>(0);
+        out.writeLE<double>(grid.originX());
+        out.writeLE<double>(grid.originY());
+        out.writeLE<double>(grid.cellSize());
+
+        std::vector<float> tile(static_cast<size_t>(tileCells + 1) * (tileCells + 1));
+        for (uint32_t ty = 0; ty < tilesY; ty++) {
+            for (uint32_t tx = 0; tx < tilesX; tx++) {
+                float* p = tile.data();
+                for (uint32_t r = 0; r <= tileCells; r++) {
+                    uint32_t row = std::min(ty * tileCells + r, rows - 1);
+                    for (uint32_t c = 0; c <= tileCells; c++) {
+                        *p++ = grid.at(std::min(tx * tileCells + c, cols - 1), row);
+                    }
+                }
+                out.write(reinterpret_cast<const char*>(tile.data()), tile.size() * sizeof(float));
+            }
+        }
+        out.close();
+    }
+
+private:
+    static uint64_t tileKey(uint32_t tx, uint32_t ty) {
+        return (static_cast<uint64_t>(ty) << 32) | tx;
+    }
+
+    TilePtr readTile(uint32_t tx, uint32_t ty) const {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("readDemTile", "io", "tile", tileKey(tx, ty));
+        auto tile = std::make_shared<DemTile>();
+        tile->tx = tx;
+        tile->ty = ty;
+        tile->data.resize(tileBytes() / sizeof(float));
+        uint64_t offset = kHeaderSize + (static_cast<uint64_t>(ty) * tilesX_ + tx) * tileBytes();
+        file_.read(offset, tile->data.data(), tileBytes());
+        return tile;
+    }
+
+    /**
+     * 读盘并插入 LRU；seq > 0 表示尚未被计算线程用到的预取瓦片
+     */
+    TilePtr finishLoad(uint32_t tx, uint32_t ty, std::promise<TilePtr>& promise) const {
+        const uint64_t key = tileKey(tx, ty);
+        TilePtr tile;
+        try {
+            tile = readTile(tx, ty);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            loading_.erase(key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto pending = loading_.find(key);
+            uint64_t seq = pending->second.prefetchSeq;
+            loading_.erase(pending);
+            if (seq) stats_.prefetched++;
+            lru_.push_front(CacheEntry{tile, seq});
+            index_[key] = lru_.begin();
+            stats_.bytesRead += tileBytes();
+            stats_.residentBytes += tileBytes();
+            evictLocked();
+            stats_.peakResidentBytes = std::max(stats_.peakResidentBytes, stats_.residentBytes);
+        }
+        promise.set_value(tile);
+        return tile;
+    }
+
+    void consumePrefetchLocked(uint64_t seq) const {
+        if (seq == 0) return;
+        stats_.prefetchUsed++;
+        advancePrefetchLocked(seq);
+    }
+
+    void advancePrefetchLocked(uint64_t seq) const {
+        if (seq <= prefetchProgress_.load(std::memory_order_relaxed)) return;
+        prefetchProgress_.store(seq, std::memory_order_release);
+        for (const auto& l : listeners_) l.second();
+    }
+
+    /**
+     * 每线程记住最近一块瓦片；切换瓦片时才经过带锁的 LRU
+     *
+     * 之后若有瓦片被淘汰，记住的这块可能已不在缓存中并被预取线程重新读入（带预取序号），
+     * 因此淘汰后也重新经过 acquire，使预取进度得到报告。
+     */
+    const DemTile& tileForThread(uint32_t tx, uint32_t ty) const {
+        // 快速路径命中先记在线程内，攒满或换瓦片、线程退出时才加到共享计数（避免每次采样争用一条缓存行）
+        struct LastTile {
+            uint64_t source = 0;
+            uint64_t evictions = 0;
+            TilePtr tile;
+            std::shared_ptr<std::atomic<uint64_t>> hitCounter;     // 所属 DEM 析构后仍可安全写入
+            uint64_t pendingHits = 0;
+
+            void flushHits() {
+                if (pendingHits && hitCounter) hitCounter->fetch_add(pendingHits, std::memory_order_relaxed);
+                pendingHits = 0;
+            }
+            ~LastTile() { flushHits(); }
+        };
+        thread_local LastTile last;
+        const uint64_t evictions = evictionCount_.load(std::memory_order_acquire);
+        if (last.source != id_ || last.evictions != evictions || !last.tile || last.tile->tx != tx ||
+            last.tile->ty != ty) {
+            last.flushHits();
+            last.tile = acquire(tx, ty);
+            last.source = id_;
+            last.evictions = evictions;
+            last.hitCounter = threadHits_;
+        } else if (++last.pendingHits == 64) {
+            last.flushHits();
+        }
+        return *last.tile;
+    }
+
+    void evictLocked() const {
+        while (stats_.residentBytes > stats_.budgetBytes && lru_.size() > 1) {
+            const CacheEntry& victim = lru_.back();
+            if (victim.prefetchSeq) stats_.prefetchWasted++;
+            index_.erase(tileKey(victim.tile->tx, victim.tile->ty));
+            lru_.pop_back();
+            stats_.residentBytes -= tileBytes();
+            stats_.evictions++;
+            evictionCount_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    struct CacheEntry {
+        TilePtr tile;
+        uint64_t prefetchSeq;           // 0 = 非预取或已被用到
+    };
+
+    struct Loading {
+        std::shared_future<TilePtr> tile;
+        uint64_t prefetchSeq;
+    };
+
+    dem_detail::RandomAccessFile file_;
+    uint64_t id_;
+    uint32_t cols_ = 0, rows_ = 0, tileCells_ = 1;
+    uint32_t tilesX_ = 1, tilesY_ = 1;
+    double originX_ = 0, originY_ = 0, cellSize_ = 1;
+
+    mutable std::mutex mutex_;
+    mutable std::list<CacheEntry> lru_;
+    mutable std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> index_;
+    mutable std::unordered_map<uint64_t, Loading> loading_;
+    mutable DemCacheStats stats_;
+    mutable std::atomic<uint64_t> prefetchProgress_{0};
+    std::shared_ptr<std::atomic<uint64_t>> threadHits_ = std::make_shared<std::atomic<uint64_t>>(0);
+    mutable std::atomic<uint64_t> evictionCount_{0};   // 不随 resetStats 清零，供 tileForThread 判断
+    mutable std::vector<std::pair<uint64_t, std::function<void()>>> listeners_;
+    mutable uint64_t nextListener_ = 0;
+};
+
+} // namespace radar_coverage
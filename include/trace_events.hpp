@@ -0,0 +1,321 @@
+/**
+ * trace_events.hpp
+ *
+ * 流水线执行追踪 - 导出 Chrome trace_event JSON（可直接在 Perfetto / chrome://tracing 打开）
+ *
+ * - 每个线程写自己的缓冲区（定长块链表），记录路径无锁；线程首次记录时登记一次
+ * - 每个区间记录为一个 "X"（complete）事件：开始时间 + 持续时间 + 线程号
+ * - 未启用追踪时每个区间只有一次 relaxed 原子读；定义 RADAR_COVERAGE_TRACING=0
+ *   则所有埋点在编译期移除
+ *
+ * 用法:
+ *   polygon_ops::Tracer tracer;
+ *   tracer.start();
+ *   ... 计算 ...
+ *   tracer.stop();
+ *   radar_coverage::writeChromeTrace("trace.json", tracer);
+ *
+ * 依赖: stream_writer.hpp
+ */
+
+#pragma once
+
+#include "stream_writer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef RADAR_COVERAGE_TRACING
+#define RADAR_COVERAGE_TRACING 1
+#endif
+
+namespace polygon_ops {
+
+// ============================================================================
+// 追踪事件与线程缓冲
+// ============================================================================
+
+struct TraceEvent {
+    const char* name;       // 静态字符串（不复制）
+    const char* category;
+    const char* argName;    // 可为 nullptr
+    int64_t argValue;
+    int64_t beginNs;        // 相对 Tracer::start()
+    int64_t durationNs;
+};
+
+/**
+ * 单线程写、任意线程读的事件缓冲
+ *
+ * 写入方只追加到尾块并以 release 发布计数；读取方以 acquire 读取计数后遍历，
+ * 因此 dump 可与仍在运行的工作线程并发进行（只看到已发布的事件）。
+ */
+class TraceThreadBuffer {
+public:
+    static constexpr size_t kChunkEvents = 4096;
+
+    explicit TraceThreadBuffer(uint32_t tid) : tid_(tid), head_(new Chunk), tail_(head_.get()) {}
+
+    ~TraceThreadBuffer() {
+        // 逐块释放，避免长链表递归析构
+        std::unique_ptr<Chunk> c = std::move(head_);
+        while (c) c = std::move(c->next);
+    }
+
+    void push(const TraceEvent& e) {
+        size_t n = tail_->count.load(std::memory_order_relaxed);
+        if (n == kChunkEvents) {
+            Chunk* next = new Chunk;
+            tail_->nextRaw.store(next, std::memory_order_release);
+            tail_->next.reset(next);
+            tail_ = next;
+            n = 0;
+        }
+        tail_->events[n] = e;
+        tail_->count.store(n + 1, std::memory_order_release);
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Chunk* c = head_.get(); c; c = c->nextRaw.load(std::memory_order_acquire)) {
+            size_t n = c->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < n; i++) fn(c->events[i]);
+        }
+    }
+
+    uint32_t tid() const { return tid_; }
+
+private:
+    struct Chunk {
+        TraceEvent events[kChunkEvents];
+        std::atomic<size_t> count{0};
+        std::atomic<Chunk*> nextRaw{nullptr};
+        std::unique_ptr<Chunk> next;
+    };
+
+    uint32_t tid_;
+    std::unique_ptr<Chunk> head_;
+    Chunk* tail_;
+};
+
+// ============================================================================
+// 追踪器
+// ============================================================================
+
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Tracer() : id_(nextId()), origin_(Clock::now().time_since_epoch().count()) {}
+    ~Tracer() { stop(); }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * 设为当前进程的活动追踪器（同一时刻只有一个）；时间原点重置为此刻
+     *
+     * 其他线程可能正在本追踪器上记录，原点为原子量；经 current() 取得追踪器的线程看到新原点。
+     */
+    void start() {
+        origin_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        active().store(this, std::memory_order_release);
+    }
+
+    void stop() {
+        Tracer* self = this;
+        active().compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+    }
+
+    static Tracer* current() { return active().load(std::memory_order_acquire); }
+
+    int64_t nowNs() const {
+        Clock::duration origin(origin_.load(std::memory_order_relaxed));
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch() - origin)
+            .count();
+    }
+
+    void record(const char* name, const char* category, int64_t beginNs,
+                const char* argName = nullptr, int64_t argValue = 0) {
+        threadBuffer().push({name, category, argName, argValue, beginNs, nowNs() - beginNs});
+    }
+
+    /**
+     * 为当前线程命名（导出为 thread_name 元数据）
+     */
+    void setThreadName(const std::string& name) {
+        TraceThreadBuffer& buf = threadBuffer();
+        std::lock_guard<std::mutex> lock(mutex_);
+        threadNames_.emplace_back(buf.tid(), name);
+    }
+
+    template <typename Fn>
+    void forEachBuffer(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& b : buffers_) fn(*b);
+    }
+
+    std::vector<std::pair<uint32_t, std::string>> threadNames() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threadNames_;
+    }
+
+private:
+    static std::atomic<Tracer*>& active() {
+        static std::atomic<Tracer*> tracer{nullptr};
+        return tracer;
+    }
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    /**
+     * 当前线程在本追踪器中的缓冲；首次调用时加锁登记，之后只读 thread_local 缓存
+     */
+    TraceThreadBuffer& threadBuffer() {
+        struct Cache {
+            uint64_t tracerId = 0;
+            TraceThreadBuffer* buffer = nullptr;
+        };
+        static thread_local Cache cache;
+        if (cache.tracerId != id_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(std::make_unique<TraceThreadBuffer>(
+                static_cast<uint32_t>(buffers_.size() + 1)));
+            cache.buffer = buffers_.back().get();
+            cache.tracerId = id_;
+        }
+        return *cache.buffer;
+    }
+
+    uint64_t id_;
+    std::atomic<Clock::rep> origin_;                    // 时间原点（Clock 计数）
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> buffers_;
+    std::vector<std::pair<uint32_t, std::string>> threadNames_;
+};
+
+/**
+ * 作用域区间：构造时取开始时间，析构时写入一个完整事件
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category,
+              const char* argName = nullptr, int64_t argValue = 0)
+        : tracer_(Tracer::current()) {
+        if (tracer_) {
+            name_ = name;
+            category_ = category;
+            argName_ = argName;
+            argValue_ = argValue;
+            beginNs_ = tracer_->nowNs();
+        }
+    }
+
+    ~TraceSpan() {
+        if (tracer_) tracer_->record(name_, category_, beginNs_, argName_, argValue_);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    Tracer* tracer_;
+    const char* name_ = nullptr;
+    const char* category_ = nullptr;
+    const char* argName_ = nullptr;
+    int64_t argValue_ = 0;
+    int64_t beginNs_ = 0;
+};
+
+} // namespace polygon_ops
+
+// ============================================================================
+// 埋点宏
+// ============================================================================
+
+#define RADAR_COVERAGE_TRACE_CONCAT_(a, b) a##b
+#define RADAR_COVERAGE_TRACE_CONCAT(a, b) RADAR_COVERAGE_TRACE_CONCAT_(a, b)
+
+#if RADAR_COVERAGE_TRACING
+#define RADAR_COVERAGE_TRACE_SCOPE(name, category)                          \
+    ::polygon_ops::TraceSpan RADAR_COVERAGE_TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
+#define RADAR_COVERAGE_TRACE_SCOPE_ARG(name, category, argName, argValue)   \
+    ::polygon_ops::TraceSpan RADAR_COVERAGE_TRACE_CONCAT(traceSpan_, __LINE__)( \
+        name, category, argName, static_cast<int64_t>(argValue))
+#else
+#define RADAR_COVERAGE_TRACE_SCOPE(name, category) do {} while (0)
+#define RADAR_COVERAGE_TRACE_SCOPE_ARG(name, category, argName, argValue) \
+    do { (void)sizeof(argValue); } while (0)
+#endif
+
+namespace radar_coverage {
+
+// ============================================================================
+// Chrome trace_event 导出
+// ============================================================================
+
+/**
+ * 写出 {"traceEvents": [...]}；时间单位为微秒
+ *
+ * 可在计算进行中调用（只包含已完成的区间）
+ */
+inline void writeChromeTrace(BufferedWriter& out, const polygon_ops::Tracer& tracer) {
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out.put(',');
+        out.put('\n');
+        first = false;
+    };
+
+    out.writeLiteral("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (const auto& tn : tracer.threadNames()) {
+        separator();
+        out.writeLiteral("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+        out.writeUInt(tn.first);
+        out.writeLiteral(",\"args\":{\"name\":");
+        writeJsonString(out, tn.second);
+        out.writeLiteral("}}");
+    }
+
+    tracer.forEachBuffer([&](const polygon_ops::TraceThreadBuffer& buf) {
+        buf.forEach([&](const polygon_ops::TraceEvent& e) {
+            separator();
+            out.writeLiteral("{\"name\":");
+            writeJsonString(out, e.name);
+            out.writeLiteral(",\"cat\":");
+            writeJsonString(out, e.category);
+            out.writeLiteral(",\"ph\":\"X\",\"ts\":");
+            out.writeDouble(e.beginNs / 1000.0, 3);
+            out.writeLiteral(",\"dur\":");
+            out.writeDouble(e.durationNs / 1000.0, 3);
+            out.writeLiteral(",\"pid\":1,\"tid\":");
+            out.writeUInt(buf.tid());
+            if (e.argName) {
+                out.writeLiteral(",\"args\":{");
+                writeJsonString(out, e.argName);
+                out.put(':');
+                out.writeInt(e.argValue);
+                out.put('}');
+            }
+            out.put('}');
+        });
+    });
+
+    out.writeLiteral("\n]}\n");
+}
+
+inline void writeChromeTrace(const std::string& path, const polygon_ops::Tracer& tracer) {
+    BufferedWriter out(path);
+    writeChromeTrace(out, tracer);
+    out.close();
+}
+
+} // namespace radar_coverage
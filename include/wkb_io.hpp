@@ -0,0 +1,386 @@
+/**
+ * wkb_io.hpp
+ *
+ * MultiPolygon 的 WKB / EWKB / WKT 导入导出 (用于 PostGIS 等空间数据库)
+ *
+ * - WKB 直接从环数据逐值写入 BufferedWriter，不生成中间字符串
+ * - 输出固定为小端 (NDR)；读取同时支持大端与小端
+ * - EWKB: 设置 SRID 时在几何类型上附加 0x20000000 标志并写入 SRID
+ * - 环在输出时自动闭合，读取时去除重复的闭合点
+ *
+ * 依赖: polygon_boolean.hpp, stream_writer.hpp
+ */
+
+#pragma once
+
+#include "polygon_boolean.hpp"
+#include "stream_writer.hpp"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace radar_coverage {
+
+using polygon_ops::Point2D;
+using polygon_ops::Polygon;
+using polygon_ops::PolygonWithHoles;
+using polygon_ops::MultiPolygon;
+
+namespace wkb {
+
+constexpr uint32_t kPolygon = 3;
+constexpr uint32_t kMultiPolygon = 6;
+constexpr uint32_t kSRIDFlag = 0x20000000;
+constexpr uint32_t kZFlag = 0x80000000;
+constexpr uint32_t kMFlag = 0x40000000;
+constexpr int32_t kNoSRID = -1;
+
+inline bool ringIsClosed(const Polygon& ring) {
+    return ring.size() > 1 &&
+           ring.front().x == ring.back().x && ring.front().y == ring.back().y;
+}
+
+inline size_t closedRingSize(const Polygon& ring) {
+    if (ring.empty()) return 0;
+    return ringIsClosed(ring) ? ring.size() : ring.size() + 1;
+}
+
+// ============================================================================
+// 编码器（模板化输出端：二进制或十六进制文本）
+// ============================================================================
+
+template <typename Out>
+class Encoder {
+public:
+    explicit Encoder(Out& out) : out_(out) {}
+
+    void writeMultiPolygon(const MultiPolygon& mp, int32_t srid) {
+        writeHeader(kMultiPolygon, srid);
+        out_.template writeLE<uint32_t>(static_cast<uint32_t>(mp.size()));
+        for (const auto& pwh : mp) {
+            writePolygon(pwh);
+        }
+    }
+
+    void writePolygon(const PolygonWithHoles& pwh) {
+        writeHeader(kPolygon, kNoSRID);
+        uint32_t rings = pwh.outer.empty() ? 0 : 1 + static_cast<uint32_t>(pwh.holes.size());
+        out_.template writeLE<uint32_t>(rings);
+        if (rings == 0) return;
+        writeRing(pwh.outer);
+        for (const auto& hole : pwh.holes) {
+            writeRing(hole);
+        }
+    }
+
+private:
+    void writeHeader(uint32_t type, int32_t srid) {
+        out_.template writeLE<uint8_t>(1);  // NDR
+        if (srid != kNoSRID) {
+            out_.template writeLE<uint32_t>(type | kSRIDFlag);
+            out_.template writeLE<int32_t>(srid);
+        } else {
+            out_.template writeLE<uint32_t>(type);
+        }
+    }
+
+    void writeRing(const Polygon& ring) {
+        out_.template writeLE<uint32_t>(static_cast<uint32_t>(closedRingSize(ring)));
+        for (const auto& p : ring) {
+            out_.template writeLE<double>(p.x);
+            out_.template writeLE<double>(p.y);
+        }
+        if (!ring.empty() && !ringIsClosed(ring)) {
+            out_.template writeLE<double>(ring[0].x);
+            out_.template writeLE<double>(ring[0].y);
+        }
+    }
+
+    Out& out_;
+};
+
+/**
+ * 将字节以大写十六进制写出（PostGIS COPY / hex-EWKB 文本格式）
+ */
+class HexAdapter {
+public:
+    explicit HexAdapter(BufferedWriter& out) : out_(out) {}
+
+    template <typename T>
+    void writeLE(T v) {
+        static const char* hex = "0123456789ABCDEF";
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+        if (!BufferedWriter::isLittleEndian()) {
+            for (size_t i = 0; i < sizeof(T) / 2; i++) {
+                std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+        }
+        char text[2 * sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i++) {
+            text[2 * i] = hex[bytes[i] >> 4];
+            text[2 * i + 1] = hex[bytes[i] & 0xF];
+        }
+        out_.write(text, sizeof(text));
+    }
+
+private:
+    BufferedWriter& out_;
+};
+
+/**
+ * 直接追加到字节数组（toWKB 使用，避免二次缓冲）
+ */
+class ByteVectorAdapter {
+public:
+    explicit ByteVectorAdapter(std::vector<uint8_t>& bytes) : bytes_(bytes) {}
+
+    template <typename T>
+    void writeLE(T v) {
+        unsigned char raw[sizeof(T)];
+        std::memcpy(raw, &v, sizeof(T));
+        if (!BufferedWriter::isLittleEndian()) {
+            for (size_t i = 0; i < sizeof(T) / 2; i++) {
+                std::swap(raw[i], raw[sizeof(T) - 1 - i]);
+            }
+        }
+        bytes_.insert(bytes_.end(), raw, raw + sizeof(T));
+    }
+
+private:
+    std::vector<uint8_t>& bytes_;
+};
+
+// ============================================================================
+// 解码器
+// ============================================================================
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    MultiPolygon readGeometry(int32_t* sridOut) {
+        int32_t srid = kNoSRID;
+        uint32_t type = readHeader(&srid);
+        if (sridOut) *sridOut = srid;
+
+        MultiPolygon mp;
+        if (type == kPolygon) {
+            PolygonWithHoles pwh = readPolygonBody();
+            if (!pwh.outer.empty()) mp.push_back(std::move(pwh));
+        } else if (type == kMultiPolygon) {
+            uint32_t count = read<uint32_t>();
+            requireBytes(static_cast<size_t>(count) * 9);  // 每个子几何至少 9 字节
+            mp.reserve(count);
+            for (uint32_t i = 0; i < count; i++) {
+                if (readHeader(nullptr) != kPolygon) {
+                    throw std::runtime_error("WKB: MultiPolygon member is not a Polygon");
+                }
+                PolygonWithHoles pwh = readPolygonBody();
+                if (!pwh.outer.empty()) mp.push_back(std::move(pwh));
+            }
+        } else {
+            throw std::runtime_error("WKB: unsupported geometry type " + std::to_string(type));
+        }
+        return mp;
+    }
+
+    size_t consumed() const { return pos_; }
+
+private:
+    uint32_t readHeader(int32_t* sridOut) {
+        uint8_t order = read<uint8_t>();
+        if (order > 1) throw std::runtime_error("WKB: invalid byte order marker");
+        swap_ = (order == 1) != BufferedWriter::isLittleEndian();
+
+        uint32_t type = read<uint32_t>();
+        if (type & (kZFlag | kMFlag)) {
+            throw std::runtime_error("WKB: Z/M coordinates are not supported");
+        }
+        if (type & kSRIDFlag) {
+            int32_t srid = read<int32_t>();
+            if (sridOut) *sridOut = srid;
+            type &= ~kSRIDFlag;
+        }
+        if (type > 1000) {
+            throw std::runtime_error("WKB: ISO Z/M geometry types are not supported");
+        }
+        return type;
+    }
+
+    PolygonWithHoles readPolygonBody() {
+        PolygonWithHoles pwh;
+        uint32_t rings = read<uint32_t>();
+        requireBytes(static_cast<size_t>(rings) * 4);
+        for (uint32_t r = 0; r < rings; r++) {
+            Polygon ring = readRing();
+            if (r == 0) {
+                pwh.outer = std::move(ring);
+            } else {
+                pwh.holes.push_back(std::move(ring));
+            }
+        }
+        return pwh;
+    }
+
+    Polygon readRing() {
+        uint32_t n = read<uint32_t>();
+        requireBytes(static_cast<size_t>(n) * 16);
+        Polygon ring;
+        ring.reserve(n);
+        for (uint32_t i = 0; i < n; i++) {
+            double x = read<double>();
+            double y = read<double>();
+            ring.emplace_back(x, y);
+        }
+        if (ringIsClosed(ring)) ring.pop_back();
+        return ring;
+    }
+
+    void requireBytes(size_t n) const {
+        if (n > size_ - pos_) throw std::runtime_error("WKB: truncated input");
+    }
+
+    template <typename T>
+    T read() {
+        requireBytes(sizeof(T));
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        if (swap_) {
+            for (size_t i = 0; i < sizeof(T) / 2; i++) {
+                std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+        }
+        T v;
+        std::memcpy(&v, bytes, sizeof(T));
+        return v;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool swap_ = false;
+};
+
+} // namespace wkb
+
+// ============================================================================
+// WKB 导出 / 导入
+// ============================================================================
+
+/**
+ * WKB 编码后的字节数（用于预分配）
+ */
+inline size_t wkbSize(const MultiPolygon& mp, int32_t srid = wkb::kNoSRID) {
+    size_t bytes = 1 + 4 + 4 + (srid != wkb::kNoSRID ? 4 : 0);
+    for (const auto& pwh : mp) {
+        bytes += 1 + 4 + 4;
+        if (pwh.outer.empty()) continue;
+        bytes += 4 + 16 * wkb::closedRingSize(pwh.outer);
+        for (const auto& hole : pwh.holes) {
+            bytes += 4 + 16 * wkb::closedRingSize(hole);
+        }
+    }
+    return bytes;
+}
+
+/**
+ * 写出 MultiPolygon 为 WKB；srid != kNoSRID 时写出 EWKB
+ */
+inline void writeWKB(BufferedWriter& out, const MultiPolygon& mp,
+                     int32_t srid = wkb::kNoSRID) {
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("writeWKB", "export", "regions", mp.size());
+    wkb::Encoder<BufferedWriter> encoder(out);
+    encoder.writeMultiPolygon(mp, srid);
+}
+
+/**
+ * 写出十六进制 (E)WKB 文本，可直接用于 PostGIS COPY
+ */
+inline void writeHexWKB(BufferedWriter& out, const MultiPolygon& mp,
+                        int32_t srid = wkb::kNoSRID) {
+    wkb::HexAdapter hex(out);
+    wkb::Encoder<wkb::HexAdapter> encoder(hex);
+    encoder.writeMultiPolygon(mp, srid);
+}
+
+inline std::vector<uint8_t> toWKB(const MultiPolygon& mp, int32_t srid = wkb::kNoSRID) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve(wkbSize(mp, srid));
+    wkb::ByteVectorAdapter adapter(bytes);
+    wkb::Encoder<wkb::ByteVectorAdapter> encoder(adapter);
+    encoder.writeMultiPolygon(mp, srid);
+    return bytes;
+}
+
+/**
+ * 解析 (E)WKB 的 Polygon 或 MultiPolygon
+ *
+ * @param sridOut 若非空，写入 EWKB 中的 SRID（无则为 kNoSRID）
+ * @throws std::runtime_error 输入截断或包含不支持的几何类型
+ */
+inline MultiPolygon readWKB(const uint8_t* data, size_t size, int32_t* sridOut = nullptr) {
+    wkb::Decoder decoder(data, size);
+    return decoder.readGeometry(sridOut);
+}
+
+inline MultiPolygon readWKB(const std::vector<uint8_t>& bytes, int32_t* sridOut = nullptr) {
+    return readWKB(bytes.data(), bytes.size(), sridOut);
+}
+
+// ============================================================================
+// WKT 导出（调试用）
+// ============================================================================
+
+inline void writeWKT(BufferedWriter& out, const MultiPolygon& mp, int precision = -1) {
+    if (mp.empty()) {
+        out.writeLiteral("MULTIPOLYGON EMPTY");
+        return;
+    }
+
+    auto writeRing = [&](const Polygon& ring) {
+        out.put('(');
+        for (size_t i = 0; i < ring.size(); i++) {
+            if (i > 0) out.writeLiteral(", ");
+            out.writeDouble(ring[i].x, precision);
+            out.put(' ');
+            out.writeDouble(ring[i].y, precision);
+        }
+        if (!ring.empty() && !wkb::ringIsClosed(ring)) {
+            out.writeLiteral(", ");
+            out.writeDouble(ring[0].x, precision);
+            out.put(' ');
+            out.writeDouble(ring[0].y, precision);
+        }
+        out.put(')');
+    };
+
+    out.writeLiteral("MULTIPOLYGON (");
+    for (size_t i = 0; i < mp.size(); i++) {
+        if (i > 0) out.writeLiteral(", ");
+        out.put('(');
+        writeRing(mp[i].outer);
+        for (const auto& hole : mp[i].holes) {
+            out.writeLiteral(", ");
+            writeRing(hole);
+        }
+        out.put(')');
+    }
+    out.put(')');
+}
+
+inline std::string exportToWKT(const MultiPolygon& mp, int precision = -1) {
+    std::string wkt;
+    {
+        BufferedWriter out([&wkt](const char* data, size_t size) {
+            wkt.append(data, size);
+        }, 64 * 1024);
+        writeWKT(out, mp, precision);
+    }
+    return wkt;
+}
+
+} // namespace radar_coverage
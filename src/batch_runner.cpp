@@ -0,0 +1,453 @@
+/**
+ * batch_runner.cpp
+ *
+ * 批量场景评估 - 在线程池上并行计算成千上万个场景
+ *
+ * 用法:
+ *   radar_coverage_batch <manifest> [--threads N] [--out DIR] [--no-export] [--trace FILE]
+ *
+ * 清单文件两种形式:
+ *   1. 纯文本: 每行一个场景路径，# 开头为注释
+ *   2. JSON:
+ *      {
+ *        "outputDir": "batch_out",
+ *        "threads": 0,
+ *        "exports": ["geojson", "svg"],
+ *        "scenarios": ["a.json", "b.rcscn"]
+ *      }
+ * 场景路径相对于清单所在目录解析。
+ *
+ * 输出:
+ *   <outputDir>/batch_stats.csv       每个场景一行（统计量 + 各阶段耗时 + 错误信息）
+ *   <outputDir>/batch_summary.json    吞吐量与各阶段累计耗时
+ *   <outputDir>/<序号>_<场景名>.geojson / .svg
+ *   --trace FILE                      Chrome trace_event JSON（Perfetto 中查看各线程时间线）
+ *
+ * 同一 DEM 在所有场景间只映射一次（共享 ElevationGridCache）。
+ */
+
+#include "polygon_boolean.hpp"
+#include "radar_coverage.hpp"
+#include "geojson_writer.hpp"
+#include "scenario.hpp"
+#include "parallel_for.hpp"
+#include "perf_allocation_hooks.hpp"
+#include "trace_events.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace polygon_ops;
+namespace rc = radar_coverage;
+namespace fs = std::filesystem;
+
+namespace {
+
+// ============================================================================
+// 清单
+// ============================================================================
+
+struct BatchManifest {
+    std::vector<std::string> scenarios;
+    std::string outputDir = "batch_out";
+    unsigned threads = 0;
+    bool exportGeoJSON = true;
+    bool exportSVG = false;
+    std::string tracePath;
+};
+
+BatchManifest loadManifest(const std::string& path) {
+    rc::MappedFile file(path);
+    const char* text = reinterpret_cast<const char*>(file.data());
+    size_t size = file.size();
+    fs::path baseDir = fs::path(path).parent_path();
+
+    BatchManifest manifest;
+    size_t first = 0;
+    while (first < size && std::isspace(static_cast<unsigned char>(text[first]))) first++;
+
+    if (first < size && text[first] == '{') {
+        rc::JsonValue root = rc::JsonParser::parse(text, size);
+        for (const auto& s : root.at("scenarios").items()) {
+            manifest.scenarios.push_back(s.asString());
+        }
+        manifest.outputDir = root.stringOr("outputDir", manifest.outputDir);
+        manifest.threads = root.intOr("threads", 0u);
+        if (const rc::JsonValue* exports = root.find("exports")) {
+            manifest.exportGeoJSON = false;
+            for (const auto& e : exports->items()) {
+                if (e.asString() == "geojson") manifest.exportGeoJSON = true;
+                else if (e.asString() == "svg") manifest.exportSVG = true;
+                else throw std::runtime_error("manifest: unknown export '" + e.asString() + "'");
+            }
+        }
+    } else {
+        size_t pos = 0;
+        while (pos < size) {
+            size_t end = pos;
+            while (end < size && text[end] != '\n') end++;
+            std::string line(text + pos, end - pos);
+            pos = end + 1;
+
+            size_t b = line.find_first_not_of(" \t\r");
+            size_t e = line.find_last_not_of(" \t\r");
+            if (b == std::string::npos || line[b] == '#') continue;
+            manifest.scenarios.push_back(line.substr(b, e - b + 1));
+        }
+    }
+
+    for (auto& s : manifest.scenarios) {
+        if (fs::path(s).is_relative() && !baseDir.empty()) s = (baseDir / s).string();
+    }
+    return manifest;
+}
+
+// ============================================================================
+// 单场景评估
+// ============================================================================
+
+enum Stage { kLoad, kApply, kGenerate, kUnion, kPostProcess, kStats, kExport, kStageCount };
+
+const char* const kStageNames[kStageCount] = {
+    "load", "apply", "generate", "union", "postprocess", "stats", "export"
+};
+
+struct ScenarioResult {
+    std::string name;
+    size_t radarCount = 0;
+    PolygonStats stats = {0, 0, 0.0, 0.0};
+    double stageMs[kStageCount] = {};
+    PerfStats perf;
+    std::string error;
+};
+
+class StageClock {
+public:
+    explicit StageClock(double* stageMs) : stageMs_(stageMs), last_(Clock::now()) {}
+
+    void lap(Stage stage) {
+        auto now = Clock::now();
+        stageMs_[stage] += std::chrono::duration<double, std::milli>(now - last_).count();
+        last_ = now;
+    }
+
+    /**
+     * 丢弃自上次 lap 以来的耗时（该段已按其他来源计入）
+     */
+    void restart() { last_ = Clock::now(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    double* stageMs_;
+    Clock::time_point last_;
+};
+
+std::string outputStem(size_t index, const rc::Scenario& sc, const std::string& path) {
+    std::string name = sc.name.empty() ? fs::path(path).stem().string() : sc.name;
+    for (char& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') c = '_';
+    }
+    std::ostringstream ss;
+    ss << std::setw(5) << std::setfill('0') << index << '_' << name;
+    return ss.str();
+}
+
+/**
+ * 通过 CoverageMergeManager 计算合并覆盖，各阶段耗时取自管理器的 UpdateTimings
+ */
+void evaluateScenario(size_t index, const std::string& path, const BatchManifest& manifest,
+                      rc::ElevationGridCache& demCache, ScenarioResult& result) {
+    StageClock clock(result.stageMs);
+    PerfSinkScope perfScope(&result.perf);
+    RADAR_COVERAGE_TRACE_SCOPE_ARG("scenario", "batch", "index", index);
+
+    rc::Scenario scenario;
+    {
+        RADAR_COVERAGE_TRACE_SCOPE("loadScenario", "batch");
+        scenario = rc::loadScenario(path);
+    }
+    result.name = scenario.name.empty() ? fs::path(path).stem().string() : scenario.name;
+    result.radarCount = scenario.radars.size();
+    clock.lap(kLoad);
+
+    rc::CoverageMergeManager manager;
+    manager.setNumThreads(1);   // 并行度在场景之间，单个场景内串行
+    rc::applyScenario(scenario, manager, &demCache);
+    clock.lap(kApply);
+
+    const MultiPolygon& merged = manager.getMergedCoverage();
+    const rc::UpdateTimings& t = manager.getLastUpdateTimings();
+    result.stageMs[kGenerate] += t.generateMs;
+    result.stageMs[kUnion] += t.unionMs;
+    result.stageMs[kPostProcess] += t.simplifyMs + t.smoothMs;
+    clock.restart();
+
+    result.stats = PolygonStats::compute(merged);
+    clock.lap(kStats);
+
+    std::string stem = (fs::path(manifest.outputDir) / outputStem(index, scenario, path)).string();
+    if (manifest.exportGeoJSON) {
+        rc::GeoJSONOptions options;
+        options.precision = 3;
+        rc::writeGeoJSON(stem + ".geojson", merged, options);
+    }
+    if (manifest.exportSVG && !merged.empty()) {
+        PolygonUtils::BoundingBox bounds = PolygonUtils::boundingBox(merged[0].outer);
+        for (const auto& pwh : merged) {
+            PolygonUtils::BoundingBox b = PolygonUtils::boundingBox(pwh.outer);
+            bounds.minX = std::min(bounds.minX, b.minX);
+            bounds.minY = std::min(bounds.minY, b.minY);
+            bounds.maxX = std::max(bounds.maxX, b.maxX);
+            bounds.maxY = std::max(bounds.maxY, b.maxY);
+        }
+        rc::exportToSVGFile(stem + ".svg", manager.getRadars(), manager.getIndividualCoverages(),
+                            merged, manager.terrain(), rc::SvgViewport::fitTo(bounds, 800, 600));
+    }
+    clock.lap(kExport);
+
+    // 管理器在重算期间使用自己的计数接收者
+    result.perf.merge(manager.getPerfStats());
+}
+
+// ============================================================================
+// 结果输出
+// ============================================================================
+
+void writeStatsCSV(const std::string& path, const std::vector<std::string>& scenarios,
+                   const std::vector<ScenarioResult>& results) {
+    rc::BufferedWriter out(path);
+    out.writeLiteral("index,scenario,path,radars,regions,holes,area,perimeter");
+    for (const char* stage : kStageNames) {
+        out.writeLiteral(",");
+        out.write(std::string(stage) + "_ms");
+    }
+    out.writeLiteral(",elevation_evals,los_checks,bisection_iters,clipper_in,clipper_out,"
+                     "allocations,error\n");
+
+    // CSV 字段转义：含逗号/引号/换行时加引号
+    auto field = [&out](const std::string& s) {
+        if (s.find_first_of(",\"\n\r") == std::string::npos) {
+            out.write(s);
+            return;
+        }
+        out.put('"');
+        for (char c : s) {
+            if (c == '"') out.put('"');
+            out.put(c);
+        }
+        out.put('"');
+    };
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const ScenarioResult& r = results[i];
+        out.writeUInt(i);
+        out.put(',');
+        field(r.name);
+        out.put(',');
+        field(scenarios[i]);
+        out.put(',');
+        out.writeUInt(r.radarCount);
+        out.put(',');
+        out.writeUInt(r.stats.regionCount);
+        out.put(',');
+        out.writeUInt(r.stats.totalHoleCount);
+        out.put(',');
+        out.writeDouble(r.stats.totalArea, 3);
+        out.put(',');
+        out.writeDouble(r.stats.totalPerimeter, 3);
+        for (double ms : r.stageMs) {
+            out.put(',');
+            out.writeDouble(ms, 3);
+        }
+        for (uint64_t n : {r.perf.elevationEvaluations, r.perf.losChecks,
+                           r.perf.bisectionIterations, r.perf.clipperInputVertices,
+                           r.perf.clipperOutputVertices, r.perf.allocations}) {
+            out.put(',');
+            out.writeUInt(n);
+        }
+        out.put(',');
+        field(r.error);
+        out.put('\n');
+    }
+    out.close();
+}
+
+void writeSummaryJSON(const std::string& path, size_t total, size_t failed, unsigned threads,
+                      double wallSeconds, const double (&stageTotals)[kStageCount],
+                      const PerfStats& perf) {
+    rc::BufferedWriter out(path);
+    out.writeLiteral("{\n  \"scenarios\": ");
+    out.writeUInt(total);
+    out.writeLiteral(",\n  \"failed\": ");
+    out.writeUInt(failed);
+    out.writeLiteral(",\n  \"threads\": ");
+    out.writeUInt(threads);
+    out.writeLiteral(",\n  \"wallSeconds\": ");
+    out.writeDouble(wallSeconds, 6);
+    out.writeLiteral(",\n  \"scenariosPerSecond\": ");
+    out.writeDouble(wallSeconds > 0 ? total / wallSeconds : 0.0, 3);
+    out.writeLiteral(",\n  \"stageTotalsMs\": {");
+    for (int s = 0; s < kStageCount; s++) {
+        if (s > 0) out.writeLiteral(", ");
+        rc::writeJsonString(out, kStageNames[s]);
+        out.writeLiteral(": ");
+        out.writeDouble(stageTotals[s], 3);
+    }
+    out.writeLiteral("},\n  \"counters\": {\"elevationEvaluations\": ");
+    out.writeUInt(perf.elevationEvaluations);
+    out.writeLiteral(", \"losChecks\": ");
+    out.writeUInt(perf.losChecks);
+    out.writeLiteral(", \"bisectionIterations\": ");
+    out.writeUInt(perf.bisectionIterations);
+    out.writeLiteral(", \"clipperInputVertices\": ");
+    out.writeUInt(perf.clipperInputVertices);
+    out.writeLiteral(", \"clipperOutputVertices\": ");
+    out.writeUInt(perf.clipperOutputVertices);
+    out.writeLiteral(", \"allocations\": ");
+    out.writeUInt(perf.allocations);
+    out.writeLiteral(", \"allocatedBytes\": ");
+    out.writeUInt(perf.allocatedBytes);
+    out.writeLiteral("}\n}\n");
+    out.close();
+}
+
+void printUsage() {
+    std::cerr << "用法: radar_coverage_batch <manifest> [--threads N] [--out DIR] [--no-export]"
+                 " [--trace FILE]\n";
+}
+
+} // namespace
+
+// ============================================================================
+// 主程序
+// ============================================================================
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+
+    BatchManifest manifest;
+    try {
+        manifest = loadManifest(argv[1]);
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                manifest.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--out" && i + 1 < argc) {
+                manifest.outputDir = argv[++i];
+            } else if (arg == "--trace" && i + 1 < argc) {
+                manifest.tracePath = argv[++i];
+            } else if (arg == "--no-export") {
+                manifest.exportGeoJSON = false;
+                manifest.exportSVG = false;
+            } else {
+                printUsage();
+                return 2;
+            }
+        }
+        fs::create_directories(manifest.outputDir);
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    const size_t count = manifest.scenarios.size();
+    const unsigned threads = std::max(1u, std::min<unsigned>(
+        manifest.threads ? manifest.threads : hardwareThreads(),
+        static_cast<unsigned>(std::max<size_t>(count, 1))));
+
+    std::cout << "[1] 清单: " << argv[1] << " (" << count << " 个场景, "
+              << threads << " 线程)\n";
+
+    rc::ElevationGridCache demCache;
+    std::vector<ScenarioResult> results(count);
+
+    Tracer tracer;
+    std::vector<std::atomic<bool>> workerNamed(threads);
+    if (!manifest.tracePath.empty()) tracer.start();
+
+    std::cout << "[2] 并行评估...\n";
+    auto start = std::chrono::steady_clock::now();
+    parallelFor(count, threads, [&](size_t i, unsigned worker) {
+        if (!manifest.tracePath.empty() && !workerNamed[worker].exchange(true)) {
+            tracer.setThreadName("worker " + std::to_string(worker));
+        }
+        try {
+            evaluateScenario(i, manifest.scenarios[i], manifest, demCache, results[i]);
+        } catch (const std::exception& e) {
+            results[i].error = e.what();
+        }
+    }, 1);
+    double wallSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    tracer.stop();
+
+    size_t failed = 0;
+    double stageTotals[kStageCount] = {};
+    PerfStats perfTotals;
+    for (const auto& r : results) {
+        if (!r.error.empty()) failed++;
+        perfTotals.merge(r.perf);
+        for (int s = 0; s < kStageCount; s++) stageTotals[s] += r.stageMs[s];
+    }
+
+    std::cout << "[3] 写出统计...\n";
+    try {
+        writeStatsCSV((fs::path(manifest.outputDir) / "batch_stats.csv").string(),
+                      manifest.scenarios, results);
+        writeSummaryJSON((fs::path(manifest.outputDir) / "batch_summary.json").string(),
+                         count, failed, threads, wallSeconds, stageTotals, perfTotals);
+        if (!manifest.tracePath.empty()) {
+            rc::writeChromeTrace(manifest.tracePath, tracer);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n[吞吐量]\n";
+    std::cout << "    - 完成: " << (count - failed) << " / " << count
+              << " (失败 " << failed << ")\n";
+    std::cout << "    - 耗时: " << std::fixed << std::setprecision(3) << wallSeconds << " s\n";
+    std::cout << "    - 吞吐: " << std::setprecision(1)
+              << (wallSeconds > 0 ? count / wallSeconds : 0.0) << " 场景/秒\n";
+    std::cout << "    - DEM:  " << demCache.size() << " 个栅格, 缓存命中 "
+              << demCache.hits() << " 次\n";
+
+    std::cout << "\n[各阶段累计耗时 (所有线程)]\n";
+    double cpuTotal = 0;
+    for (double ms : stageTotals) cpuTotal += ms;
+    for (int s = 0; s < kStageCount; s++) {
+        std::cout << "    - " << std::left << std::setw(12) << kStageNames[s] << std::right
+                  << std::setw(12) << std::setprecision(1) << stageTotals[s] << " ms  ("
+                  << std::setw(5) << (cpuTotal > 0 ? 100.0 * stageTotals[s] / cpuTotal : 0.0)
+                  << "%)\n";
+    }
+
+    if (PerfStats::enabled) {
+        std::cout << "\n[热点计数]\n";
+        std::cout << "    - 高程采样: " << perfTotals.elevationEvaluations << "\n";
+        std::cout << "    - 视线检查: " << perfTotals.losChecks << "\n";
+        std::cout << "    - 二分迭代: " << perfTotals.bisectionIterations << "\n";
+        std::cout << "    - Clipper 顶点: " << perfTotals.clipperInputVertices << " -> "
+                  << perfTotals.clipperOutputVertices << "\n";
+        std::cout << "    - 堆分配:   " << perfTotals.allocations << " 次, "
+                  << perfTotals.allocatedBytes / 1024 << " KiB\n";
+    }
+
+    for (size_t i = 0; i < count && failed > 0; i++) {
+        if (!results[i].error.empty()) {
+            std::cerr << "失败: " << manifest.scenarios[i] << ": " << results[i].error << "\n";
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
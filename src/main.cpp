@@ -18,6 +18,8 @@
 
 #include "polygon_boolean.hpp"
 #include "radar_coverage.hpp"
+#include "geojson_writer.hpp"
+#include "scenario.hpp"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -236,64 +238,86 @@ void exportToSVG(const std::string& filename,
 // ============================================================================
 
 void exportToGeoJSON(const std::string& filename, const MultiPolygon& merged) {
-    std::ofstream json(filename);
+    // 流式写出：逐区域格式化进缓冲区，不在内存中拼接整个文档
+    radar_coverage::GeoJSONOptions options;
+    options.precision = 3;
+    radar_coverage::writeGeoJSON(filename, merged, options);
     
-    json << "{\n"
-         << "  \"type\": \"FeatureCollection\",\n"
-         << "  \"features\": [\n";
+    std::cout << "已导出: " << filename << std::endl;
+}
+
+// ============================================================================
+// 场景文件模式
+// ============================================================================
+
+int runScenario(const std::string& path) {
+    namespace rc = radar_coverage;
     
-    for (size_t i = 0; i < merged.size(); i++) {
-        const auto& pwh = merged[i];
-        
-        json << "    {\n"
-             << "      \"type\": \"Feature\",\n"
-             << "      \"properties\": {\n"
-             << "        \"type\": \"radar_coverage\",\n"
-             << "        \"region_id\": " << i << ",\n"
-             << "        \"hole_count\": " << pwh.holes.size() << "\n"
-             << "      },\n"
-             << "      \"geometry\": {\n"
-             << "        \"type\": \"Polygon\",\n"
-             << "        \"coordinates\": [\n";
-        
-        // 外边界
-        json << "          [";
-        for (size_t j = 0; j < pwh.outer.size(); j++) {
-            if (j > 0) json << ", ";
-            json << "[" << pwh.outer[j].x << ", " << pwh.outer[j].y << "]";
-        }
-        // 闭合
-        json << ", [" << pwh.outer[0].x << ", " << pwh.outer[0].y << "]]";
-        
-        // 孔洞
-        for (const auto& hole : pwh.holes) {
-            json << ",\n          [";
-            for (size_t j = 0; j < hole.size(); j++) {
-                if (j > 0) json << ", ";
-                json << "[" << hole[j].x << ", " << hole[j].y << "]";
-            }
-            json << ", [" << hole[0].x << ", " << hole[0].y << "]]";
-        }
-        
-        json << "\n        ]\n"
-             << "      }\n"
-             << "    }";
-        
-        if (i < merged.size() - 1) json << ",";
-        json << "\n";
+    std::cout << "[1] 加载场景: " << path << "\n";
+    rc::Scenario scenario = rc::loadScenario(path);
+    std::cout << "    - " << scenario.radars.size() << " 部雷达, "
+              << scenario.obstacles.size() << " 个地形障碍, "
+              << scenario.dems.size() << " 个 DEM\n";
+    
+    rc::CoverageMergeManager manager;
+    rc::applyScenario(scenario, manager);
+    
+    std::cout << "[2] 计算合并覆盖...\n";
+    const MultiPolygon& merged = manager.getMergedCoverage();
+    
+    PolygonStats stats = PolygonStats::compute(merged);
+    std::cout << "\n[统计信息]\n";
+    std::cout << "    - 分离区域数量: " << stats.regionCount << "\n";
+    std::cout << "    - 总孔洞数量:   " << stats.totalHoleCount << "\n";
+    std::cout << "    - 总覆盖面积:   " << std::fixed << std::setprecision(0) 
+              << stats.totalArea << "\n";
+    
+    if (PerfStats::enabled) {
+        const PerfStats& perf = manager.getPerfStats();
+        std::cout << "\n[性能计数]\n";
+        std::cout << "    - 高程采样 / 视线检查: " << perf.elevationEvaluations << " / "
+                  << perf.losChecks << "\n";
+        std::cout << "    - 生成 / 合并 / 简化 / 平滑: " << std::setprecision(2)
+                  << perf.generateMs << " / " << perf.unionMs << " / "
+                  << perf.simplifyMs << " / " << perf.smoothMs << " ms\n";
     }
     
-    json << "  ]\n}\n";
-    json.close();
+    std::cout << "\n[3] 导出文件...\n";
+    if (!merged.empty()) {
+        PolygonUtils::BoundingBox bounds = PolygonUtils::boundingBox(merged[0].outer);
+        for (const auto& pwh : merged) {
+            PolygonUtils::BoundingBox b = PolygonUtils::boundingBox(pwh.outer);
+            bounds.minX = std::min(bounds.minX, b.minX);
+            bounds.minY = std::min(bounds.minY, b.minY);
+            bounds.maxX = std::max(bounds.maxX, b.maxX);
+            bounds.maxY = std::max(bounds.maxY, b.maxY);
+        }
+        rc::exportToSVGFile("radar_coverage_result.svg", manager.getRadars(),
+                            manager.getIndividualCoverages(), merged, manager.terrain(),
+                            rc::SvgViewport::fitTo(bounds, 800, 600));
+        std::cout << "已导出: radar_coverage_result.svg" << std::endl;
+    }
+    exportToGeoJSON("radar_coverage_result.geojson", merged);
     
-    std::cout << "已导出: " << filename << std::endl;
+    return 0;
 }
 
 // ============================================================================
 // 主程序
 // ============================================================================
 
-int main() {
+int main(int argc, char** argv) {
+    // radar_coverage_demo <scenario.json|scenario.rcscn>
+    if (argc > 1) {
+        try {
+            return runScenario(argv[1]);
+        } catch (const std::exception& e) {
+            std::cerr << "错误: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
+
     std::cout << "======================================\n";
     std::cout << " 雷达覆盖区域合并 - 完整多边形布尔运算\n";
     std::cout << "======================================\n\n";
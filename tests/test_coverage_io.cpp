@@ -0,0 +1,854 @@
+/**
+ * test_coverage_io.cpp
+ * 
+ * 覆盖结果导入/导出格式单元测试
+ */
+
+#include <gtest/gtest.h>
+#include "geojson_writer.hpp"
+#include "wkb_io.hpp"
+#include "coverage_patch.hpp"
+#include "mvt_encoder.hpp"
+#include "radar_coverage.hpp"
+#include "scenario.hpp"
+#include "scenario_generator.hpp"
+#include "tiled_dem.hpp"
+#include <algorithm>
+#include <mutex>
+#include <filesystem>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+using namespace polygon_ops;
+using namespace radar_coverage;
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+namespace {
+
+std::string formatDouble(double v, int precision) {
+    char buf[BufferedWriter::kMaxNumberChars];
+    return std::string(buf, BufferedWriter::formatDouble(buf, v, precision));
+}
+
+MultiPolygon createSquareWithHole() {
+    PolygonWithHoles pwh;
+    pwh.outer = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    pwh.holes.push_back({{4, 4}, {6, 4}, {6, 6}, {4, 6}});
+    return {pwh};
+}
+
+} // namespace
+
+// ============================================================================
+// 缓冲写入器
+// ============================================================================
+
+TEST(BufferedWriter, NumberFormatting) {
+    // 最短往返表示
+    EXPECT_EQ(formatDouble(0.1, -1), "0.1");
+    EXPECT_EQ(formatDouble(1234.5, -1), "1234.5");
+    EXPECT_EQ(std::stod(formatDouble(M_PI, -1)), M_PI);
+    
+    // 定点精度，去除末尾 0
+    EXPECT_EQ(formatDouble(1.5, 3), "1.5");
+    EXPECT_EQ(formatDouble(2.0, 3), "2");
+    EXPECT_EQ(formatDouble(3.14159, 2), "3.14");
+    EXPECT_EQ(formatDouble(-0.0001, 2), "0");
+    EXPECT_EQ(formatDouble(-0.0, -1), "0");
+}
+
+TEST(BufferedWriter, SmallBufferFlushesThroughSink) {
+    std::string out;
+    size_t chunks = 0;
+    {
+        BufferedWriter writer([&](const char* data, size_t size) {
+            out.append(data, size);
+            chunks++;
+        }, 16);
+        for (int i = 0; i < 1000; i++) {
+            writer.writeInt(i);
+            writer.put(' ');
+        }
+    }
+    
+    EXPECT_GT(chunks, 1u);
+    EXPECT_EQ(out.substr(0, 10), "0 1 2 3 4 ");
+    EXPECT_EQ(out.substr(out.size() - 4), "999 ");
+}
+
+// ============================================================================
+// GeoJSON
+// ============================================================================
+
+TEST(GeoJSONWriter, WritesClosedRingsAndProperties) {
+    std::string out;
+    BufferedWriter writer([&](const char* data, size_t size) { out.append(data, size); });
+    
+    GeoJSONOptions options;
+    options.newlinePerFeature = false;
+    writeGeoJSON(writer, createSquareWithHole(), options,
+        [](size_t, const PolygonWithHoles& pwh, GeoJSONProperties& props) {
+            props.add("vertices", pwh.outer.size());
+            props.add("label", std::string("a\"b"));
+        });
+    writer.flush();
+    
+    EXPECT_EQ(out,
+        "{\"type\":\"FeatureCollection\",\"features\":["
+        "{\"type\":\"Feature\",\"properties\":{\"type\":\"radar_coverage\","
+        "\"region_id\":0,\"hole_count\":1,\"vertices\":4,\"label\":\"a\\\"b\"},"
+        "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":["
+        "[[0,0],[10,0],[10,10],[0,10],[0,0]],"
+        "[[4,4],[6,4],[6,6],[4,6],[4,4]]]}}"
+        "]}\n");
+}
+
+TEST(GeoJSONWriter, RejectsNonFiniteCoordinates) {
+    BufferedWriter writer([](const char*, size_t) {});
+    MultiPolygon mp = createSquareWithHole();
+    mp[0].outer[1].x = std::nan("");
+    
+    EXPECT_THROW(writeGeoJSON(writer, mp), std::runtime_error);
+}
+
+// ============================================================================
+// WKB / WKT
+// ============================================================================
+
+TEST(WKB, RoundTripWithSRID) {
+    MultiPolygon mp = createSquareWithHole();
+    PolygonWithHoles second;
+    second.outer = {{20, 0}, {30, 0}, {25, 8}};
+    mp.push_back(second);
+    
+    std::vector<uint8_t> bytes = toWKB(mp, 4326);
+    EXPECT_EQ(bytes.size(), wkbSize(mp, 4326));
+    
+    // 小端 + EWKB SRID 标志
+    EXPECT_EQ(bytes[0], 1);
+    EXPECT_EQ(bytes[4], 0x20);
+    
+    int32_t srid = 0;
+    MultiPolygon decoded = readWKB(bytes, &srid);
+    EXPECT_EQ(srid, 4326);
+    ASSERT_EQ(decoded.size(), 2u);
+    ASSERT_EQ(decoded[0].holes.size(), 1u);
+    EXPECT_EQ(decoded[0].outer.size(), 4u);  // 闭合点已去除
+    EXPECT_EQ(decoded[1].outer[2].x, 25);
+    EXPECT_EQ(decoded[1].outer[2].y, 8);
+}
+
+TEST(WKB, HexMatchesBinary) {
+    MultiPolygon mp = createSquareWithHole();
+    std::vector<uint8_t> bytes = toWKB(mp);
+    
+    std::string hex;
+    {
+        BufferedWriter out([&](const char* data, size_t size) { hex.append(data, size); });
+        writeHexWKB(out, mp);
+    }
+    
+    ASSERT_EQ(hex.size(), bytes.size() * 2);
+    EXPECT_EQ(hex.substr(0, 10), "0106000000");
+}
+
+TEST(WKB, RejectsTruncatedInput) {
+    std::vector<uint8_t> bytes = toWKB(createSquareWithHole());
+    bytes.resize(bytes.size() - 3);
+    EXPECT_THROW(readWKB(bytes), std::runtime_error);
+}
+
+// ============================================================================
+// 覆盖增量补丁
+// ============================================================================
+
+TEST(CoveragePatch, LosslessRoundTrip) {
+    CoverageDelta delta;
+    delta.fromVersion = 7;
+    delta.toVersion = 8;
+    delta.region = {-1, -1, 31, 11};
+    delta.gained = createSquareWithHole();
+    PolygonWithHoles lost;
+    lost.outer = {{20, 0}, {30, 0}, {25, 8.125}};
+    delta.lost.push_back(lost);
+
+    CoverageDelta decoded = readCoveragePatch(toCoveragePatch(delta, 0));
+    EXPECT_EQ(decoded.fromVersion, 7u);
+    EXPECT_EQ(decoded.toVersion, 8u);
+    EXPECT_EQ(decoded.region.maxX, 31);
+    ASSERT_EQ(decoded.gained.size(), 1u);
+    ASSERT_EQ(decoded.gained[0].holes.size(), 1u);
+    EXPECT_EQ(decoded.gained[0].holes[0][2].x, 6);
+    ASSERT_EQ(decoded.lost.size(), 1u);
+    EXPECT_EQ(decoded.lost[0].outer[2].y, 8.125);
+}
+
+TEST(CoveragePatch, QuantizedIsCompactAndWithinResolution) {
+    CoverageDelta delta;
+    delta.region = {1000, 2000, 1100, 2100};
+    PolygonWithHoles pwh;
+    for (int i = 0; i < 64; i++) {
+        double a = 2 * M_PI * i / 64;
+        pwh.outer.emplace_back(1050 + 40 * std::cos(a), 2050 + 40 * std::sin(a));
+    }
+    delta.gained.push_back(pwh);
+    // 量化后退化的环被丢弃
+    PolygonWithHoles sliver;
+    sliver.outer = {{1010, 2010}, {1010.001, 2010}, {1010, 2010.001}};
+    delta.lost.push_back(sliver);
+
+    std::vector<uint8_t> bytes = toCoveragePatch(delta, 0.01);
+    EXPECT_LT(bytes.size(), toWKB(delta.gained).size() / 3);
+
+    CoverageDelta decoded = readCoveragePatch(bytes);
+    ASSERT_EQ(decoded.gained.size(), 1u);
+    ASSERT_EQ(decoded.gained[0].outer.size(), 64u);
+    for (size_t i = 0; i < 64; i++) {
+        EXPECT_NEAR(decoded.gained[0].outer[i].x, pwh.outer[i].x, 0.005 + 1e-9);
+        EXPECT_NEAR(decoded.gained[0].outer[i].y, pwh.outer[i].y, 0.005 + 1e-9);
+    }
+    EXPECT_TRUE(decoded.lost.empty());
+
+    bytes.resize(bytes.size() - 2);
+    EXPECT_THROW(readCoveragePatch(bytes), std::runtime_error);
+    bytes[0] = 'X';
+    EXPECT_THROW(readCoveragePatch(bytes), std::runtime_error);
+}
+
+TEST(CoveragePatch, RejectsOversizedRingCount) {
+    // 点数乘以每点字节数会溢出：应报告截断而不是尝试预留
+    for (double resolution : {0.0, 0.01}) {
+        std::vector<uint8_t> bytes = toCoveragePatch(CoverageDelta(), resolution);
+        bytes.resize(bytes.size() - 2);             // 去掉 gained / lost 的区域数
+        bytes.push_back(1);                         // 1 个区域
+        bytes.push_back(1);                         // 1 个环
+        uint64_t n = uint64_t(1) << 63;
+        for (; n >= 0x80; n >>= 7) bytes.push_back(static_cast<uint8_t>(n | 0x80));
+        bytes.push_back(static_cast<uint8_t>(n));
+        bytes.insert(bytes.end(), 32, 0);
+        EXPECT_THROW(readCoveragePatch(bytes), std::runtime_error);
+    }
+}
+
+TEST(WKT, ExportsClosedRings) {
+    EXPECT_EQ(exportToWKT({}), "MULTIPOLYGON EMPTY");
+    EXPECT_EQ(exportToWKT(createSquareWithHole()),
+        "MULTIPOLYGON (((0 0, 10 0, 10 10, 0 10, 0 0), (4 4, 6 4, 6 6, 4 6, 4 4)))");
+}
+
+// ============================================================================
+// Mapbox Vector Tile
+// ============================================================================
+
+namespace {
+
+// 极简 protobuf 读取，仅用于校验 MVT 结构
+struct ProtoReader {
+    const std::string& buf;
+    size_t pos = 0;
+    
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; ; shift += 7) {
+            uint8_t b = static_cast<uint8_t>(buf[pos++]);
+            v |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+    }
+    
+    bool next(uint32_t& field, std::string& bytes, uint64_t& value) {
+        if (pos >= buf.size()) return false;
+        uint64_t key = varint();
+        field = static_cast<uint32_t>(key >> 3);
+        if ((key & 7) == 2) {
+            size_t len = varint();
+            bytes = buf.substr(pos, len);
+            pos += len;
+        } else {
+            value = varint();
+        }
+        return true;
+    }
+};
+
+std::vector<uint32_t> firstFeatureGeometry(const std::string& tile, std::string* layerName) {
+    ProtoReader t{tile};
+    uint32_t f; std::string bytes; uint64_t v;
+    std::string layer;
+    while (t.next(f, bytes, v)) if (f == 3) layer = bytes;
+    
+    ProtoReader l{layer};
+    std::string feature;
+    while (l.next(f, bytes, v)) {
+        if (f == 1) *layerName = bytes;
+        if (f == 2 && feature.empty()) feature = bytes;
+    }
+    
+    ProtoReader fr{feature};
+    std::string packed;
+    while (fr.next(f, bytes, v)) if (f == 4) packed = bytes;
+    
+    std::vector<uint32_t> geometry;
+    ProtoReader g{packed};
+    while (g.pos < packed.size()) geometry.push_back(static_cast<uint32_t>(g.varint()));
+    return geometry;
+}
+
+int32_t unzigzag(uint32_t v) { return static_cast<int32_t>((v >> 1) ^ (~(v & 1) + 1)); }
+
+} // namespace
+
+TEST(MVTEncoder, EncodesSquareWithTileOrientation) {
+    MultiPolygon mp;
+    PolygonWithHoles pwh;
+    pwh.outer = {{0, 0}, {50, 0}, {50, 50}, {0, 50}};   // 逆时针
+    mp.push_back(pwh);
+    
+    TileGrid grid;
+    grid.minX = 0; grid.minY = 0; grid.size = 100;
+    MVTOptions options;
+    options.extent = 100;
+    options.buffer = 0;
+    
+    std::string name;
+    std::vector<uint32_t> geom = firstFeatureGeometry(
+        MVTEncoder(options).encodeTile(mp, grid, {0, 0, 0}), &name);
+    EXPECT_EQ(name, "coverage");
+    
+    // MoveTo(1) + 2, LineTo(3) + 6, ClosePath
+    ASSERT_EQ(geom.size(), 11u);
+    EXPECT_EQ(geom[0], mvt::command(mvt::kMoveTo, 1));
+    EXPECT_EQ(geom[3], mvt::command(mvt::kLineTo, 3));
+    EXPECT_EQ(geom[10], mvt::command(mvt::kClosePath, 1));
+    
+    // 还原顶点，外环在瓦片坐标（y 向下）中面积应为正
+    mvt::TileRing ring;
+    int32_t x = 0, y = 0;
+    for (size_t i : {1u, 4u, 6u, 8u}) {
+        x += unzigzag(geom[i]);
+        y += unzigzag(geom[i + 1]);
+        ring.push_back({x, y});
+        EXPECT_TRUE(x == 0 || x == 50);
+        EXPECT_TRUE(y == 50 || y == 100);
+    }
+    EXPECT_GT(mvt::ringArea2(ring), 0);
+}
+
+TEST(MVTEncoder, HoleTouchingExteriorIsKeptWhenClipSplitsRegion) {
+    // U 形区域的底部在瓦片之外，裁剪后分为左右两臂；
+    // 孔洞位于左臂内，其首个顶点恰好落在左臂右边界上
+    MultiPolygon mp;
+    PolygonWithHoles pwh;
+    pwh.outer = {{10, -50}, {90, -50}, {90, 90}, {70, 90}, {70, -20},
+                 {30, -20}, {30, 90}, {10, 90}};
+    pwh.holes.push_back({{30, 50}, {20, 60}, {15, 50}, {20, 40}});
+    mp.push_back(pwh);
+
+    TileGrid grid;
+    grid.minX = 0; grid.minY = 0; grid.size = 100;
+    MVTOptions options;
+    options.extent = 100;
+    options.buffer = 0;
+
+    std::string name;
+    std::vector<uint32_t> geom = firstFeatureGeometry(
+        MVTEncoder(options).encodeTile(mp, grid, {0, 0, 0}), &name);
+
+    // 逐环还原，按面积符号统计外环 / 孔洞
+    size_t exteriors = 0, holes = 0;
+    int32_t x = 0, y = 0;
+    for (size_t i = 0; i < geom.size();) {
+        ASSERT_EQ(geom[i] & 0x7, mvt::kMoveTo);
+        mvt::TileRing ring;
+        x += unzigzag(geom[i + 1]);
+        y += unzigzag(geom[i + 2]);
+        ring.push_back({x, y});
+        uint32_t count = geom[i + 3] >> 3;
+        for (uint32_t k = 0; k < count; k++) {
+            x += unzigzag(geom[i + 4 + 2 * k]);
+            y += unzigzag(geom[i + 5 + 2 * k]);
+            ring.push_back({x, y});
+        }
+        i += 4 + 2 * count + 1;
+        (mvt::ringArea2(ring) > 0 ? exteriors : holes)++;
+    }
+    EXPECT_GE(exteriors, 1u);
+    EXPECT_EQ(holes, 1u);
+}
+
+TEST(MVTEncoder, PyramidSkipsEmptyTiles) {
+    MultiPolygon mp;
+    PolygonWithHoles pwh;
+    pwh.outer = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    mp.push_back(pwh);
+    
+    TileGrid grid;
+    grid.minX = 0; grid.minY = 0; grid.size = 100;
+    MVTOptions options;
+    options.maxZoom = 3;
+    options.buffer = 0;
+    
+    std::mutex mutex;
+    std::vector<TileId> written;
+    TilePyramidStats stats = generateTilePyramid(mp, grid, options,
+        [&](const TileId& t, const std::string& data) {
+            std::lock_guard<std::mutex> lock(mutex);
+            EXPECT_FALSE(data.empty());
+            written.push_back(t);
+        });
+    
+    // 每级只有左下角瓦片（z=3 时瓦片边长 12.5 仍只覆盖一块）
+    EXPECT_EQ(stats.tilesWritten, 4u);
+    ASSERT_EQ(written.size(), 4u);
+    for (const auto& t : written) {
+        EXPECT_EQ(t.x, 0u);
+        EXPECT_EQ(t.y, (1u << t.z) - 1);
+    }
+}
+
+TEST(MVTEncoder, TileArchiveFooterIndexesTiles) {
+    std::string path = (std::filesystem::temp_directory_path() / "rc_tiles_test.rctiles").string();
+    {
+        TileArchiveWriter archive(path);
+        archive({0, 0, 0}, "abc");
+        archive({1, 1, 0}, "defg");
+        archive.close();
+    }
+    
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(f, nullptr);
+    std::string bytes;
+    char buf[256];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) bytes.append(buf, n);
+    std::fclose(f);
+    std::remove(path.c_str());
+    
+    EXPECT_EQ(bytes.substr(0, 8), "RCTILES1");
+    EXPECT_EQ(bytes.substr(8, 7), "abcdefg");
+    EXPECT_EQ(bytes.substr(bytes.size() - 8), "RCTILEND");
+    
+    // 索引 2 × 21 字节 + 页脚 20 字节
+    EXPECT_EQ(bytes.size(), 8u + 7u + 2u * 21u + 20u);
+    uint32_t count;
+    std::memcpy(&count, bytes.data() + bytes.size() - 12, 4);
+    EXPECT_EQ(count, 2u);
+}
+
+// ============================================================================
+// 视口 SVG 导出
+// ============================================================================
+
+TEST(SvgExport, CullsOffscreenAndDecimatesSubPixelVertices) {
+    // 一个视口内的密集圆（10000 顶点）+ 一个视口外的区域
+    MultiPolygon merged(2);
+    for (int i = 0; i < 10000; i++) {
+        double a = 2 * M_PI * i / 10000;
+        merged[0].outer.push_back({50 + 40 * std::cos(a), 50 + 40 * std::sin(a)});
+    }
+    merged[1].outer = {{1000, 1000}, {1100, 1000}, {1100, 1100}};
+    
+    SvgViewport vp;
+    vp.minX = 0; vp.minY = 0; vp.maxX = 100; vp.maxY = 100;
+    vp.width = 100; vp.height = 100;
+    
+    std::string svg;
+    SvgExportStats stats;
+    {
+        BufferedWriter out([&](const char* data, size_t size) { svg.append(data, size); });
+        stats = exportToSVG(out, {}, {}, merged, TerrainModel(), vp);
+    }
+    
+    EXPECT_EQ(stats.ringsWritten, 1u);
+    EXPECT_EQ(stats.ringsCulled, 1u);
+    EXPECT_EQ(stats.verticesIn, 10003u);
+    // 周长约 251 像素，抽稀后顶点数应与像素周长同量级
+    EXPECT_LT(stats.verticesWritten, 400u);
+    EXPECT_GT(stats.verticesWritten, 100u);
+    EXPECT_EQ(svg.find("1000"), std::string::npos);
+    EXPECT_NE(svg.find("</svg>"), std::string::npos);
+}
+
+TEST(SvgExport, FitToFlipsYAxis) {
+    PolygonUtils::BoundingBox b = {0, 0, 100, 50};
+    SvgViewport vp = SvgViewport::fitTo(b, 200, 100, 0.0);
+    
+    Point2D top = vp.toPixel({0, 50});
+    Point2D bottom = vp.toPixel({100, 0});
+    EXPECT_NEAR(top.x, 0, 1e-9);
+    EXPECT_NEAR(top.y, 0, 1e-9);
+    EXPECT_NEAR(bottom.x, 200, 1e-9);
+    EXPECT_NEAR(bottom.y, 100, 1e-9);
+}
+
+// ============================================================================
+// 场景文件测试
+// ============================================================================
+
+TEST(Scenario, ParseJSONWithDefaults) {
+    std::string text = R"({
+        "name": "t",
+        "settings": {"numRays": 36},
+        "obstacles": [{"name": "山", "center": [1, 2], "rx": 10, "ry": 20, "height": 300}],
+        "radars": [{"id": 7, "position": [5, 6], "range": 100, "height": 30, "azimuthEnd": 180}]
+    })";
+    Scenario sc = parseScenarioJSON(text.data(), text.size());
+    
+    EXPECT_EQ(sc.name, "t");
+    EXPECT_EQ(sc.settings.numRays, 36);
+    EXPECT_DOUBLE_EQ(sc.settings.simplifyEpsilon, ManagerSettings().simplifyEpsilon);
+    ASSERT_EQ(sc.obstacles.size(), 1u);
+    EXPECT_EQ(sc.obstacles[0].name, "山");
+    EXPECT_DOUBLE_EQ(sc.obstacles[0].ry, 20);
+    ASSERT_EQ(sc.radars.size(), 1u);
+    EXPECT_EQ(sc.radars[0].id, 7);
+    EXPECT_DOUBLE_EQ(sc.radars[0].azimuthEnd, 180);
+    EXPECT_DOUBLE_EQ(sc.radars[0].azimuthStart, RadarParams().azimuthStart);
+    
+    std::string bad = R"({"radars": [{"id": 1, "position": [0]}]})";
+    EXPECT_THROW(parseScenarioJSON(bad.data(), bad.size()), std::runtime_error);
+    // 超出 int 的整数字段抛出而不是未定义地截断
+    for (const char* text : {R"({"radars": [{"id": 3e9, "position": [0, 0], "range": 1, "height": 1}]})",
+                             R"({"settings": {"numRays": -1e300}})",
+                             R"({"settings": {"losSamples": 2147483648}})"}) {
+        EXPECT_THROW(parseScenarioJSON(text, std::strlen(text)), std::runtime_error) << text;
+    }
+    EXPECT_EQ(JsonParser::parse("[2147483647.5]")[0].asInt<int>(), 2147483647);
+    EXPECT_EQ(JsonParser::parse("[-9223372036854775808]")[0].asInt(), INT64_MIN);
+    EXPECT_THROW(JsonParser::parse("[9223372036854775808]")[0].asInt(), std::runtime_error);
+}
+
+TEST(Scenario, JSONParserRejectsNonStandardInput) {
+    EXPECT_DOUBLE_EQ(JsonParser::parse("[-0.5e+2]")[0].asNumber(), -50.0);
+    EXPECT_TRUE(JsonParser::parse("0").isNumber());
+
+    for (const char* text : {"inf", "-inf", "nan", "NaN", "Infinity", "01", "-01", "00",
+                             "1.", ".5", "1e", "+1", "0x10"}) {
+        EXPECT_THROW(JsonParser::parse(text), std::runtime_error) << text;
+    }
+    EXPECT_THROW(JsonParser::parse(std::string("\"a\nb\"")), std::runtime_error);
+    EXPECT_THROW(JsonParser::parse(std::string("\"a\tb\"")), std::runtime_error);
+    EXPECT_EQ(JsonParser::parse("\"a\\tb\"").asString(), "a\tb");
+}
+
+TEST(Scenario, BinaryAndJSONRoundTrip) {
+    Scenario sc;
+    sc.name = "round \"trip\"";
+    sc.settings.numRays = 90;
+    sc.settings.simplifyEpsilon = 1.25;
+    sc.settings.sampling.losSamples = 60;
+    sc.settings.sampling.rangeTolerance = 0.005;
+    sc.dems.push_back({"dem.rcdem"});
+    sc.obstacles.emplace_back(Point2D{10, 20}, 30, 40, 500, "A");
+    sc.radars.emplace_back(3, "R", Point2D{0.1, -0.2}, 150, 25);
+    
+    auto dir = std::filesystem::temp_directory_path();
+    for (bool binary : {true, false}) {
+        std::string path = (dir / (binary ? "rc_test.rcscn" : "rc_test.json")).string();
+        saveScenario(path, sc, binary);
+        Scenario back = loadScenario(path);
+        std::filesystem::remove(path);
+        
+        EXPECT_EQ(back.name, sc.name);
+        EXPECT_EQ(back.settings.numRays, 90);
+        EXPECT_DOUBLE_EQ(back.settings.simplifyEpsilon, 1.25);
+        EXPECT_EQ(back.settings.sampling.losSamples, 60);
+        EXPECT_DOUBLE_EQ(back.settings.sampling.rangeTolerance, 0.005);
+        ASSERT_EQ(back.dems.size(), 1u);
+        EXPECT_EQ(back.resolvePath(back.dems[0].path), (dir / "dem.rcdem").string());
+        ASSERT_EQ(back.obstacles.size(), 1u);
+        EXPECT_DOUBLE_EQ(back.obstacles[0].height, 500);
+        ASSERT_EQ(back.radars.size(), 1u);
+        EXPECT_DOUBLE_EQ(back.radars[0].position.y, -0.2);
+        EXPECT_EQ(back.radars[0].name, "R");
+    }
+}
+
+TEST(Scenario, TruncatedBinaryThrows) {
+    std::vector<uint8_t> data;
+    {
+        BufferedWriter out([&](const char* p, size_t n) { data.insert(data.end(), p, p + n); });
+        Scenario sc;
+        sc.radars.emplace_back(1, "R", Point2D{0, 0}, 100, 10);
+        writeScenarioBinary(out, sc);
+    }
+    EXPECT_NO_THROW(parseScenarioBinary(data.data(), data.size()));
+    EXPECT_THROW(parseScenarioBinary(data.data(), data.size() - 3), std::runtime_error);
+}
+
+TEST(Scenario, ReadsVersion1BinaryWithDefaultSampling) {
+    std::vector<uint8_t> data;
+    {
+        BufferedWriter out([&](const char* p, size_t n) { data.insert(data.end(), p, p + n); });
+        Scenario sc;
+        sc.settings.sampling.losSamples = 99;
+        sc.radars.emplace_back(1, "R", Point2D{0, 0}, 100, 10);
+        writeScenarioBinary(out, sc);
+    }
+    // 去掉 v2 新增的 losSamples / rangeTolerance 字段，改写为 v1 魔数
+    data[7] = '1';
+    data.erase(data.begin() + 24, data.begin() + 36);
+    
+    Scenario back = parseScenarioBinary(data.data(), data.size());
+    EXPECT_EQ(back.settings.sampling.losSamples, SamplingSettings().losSamples);
+    ASSERT_EQ(back.radars.size(), 1u);
+    EXPECT_DOUBLE_EQ(back.radars[0].range, 100);
+}
+
+TEST(ElevationGrid, SaveLoadAndBilinearSample) {
+    ElevationGrid grid(3, 2, 100, 200, 10);
+    grid.at(1, 0) = 10;
+    grid.at(1, 1) = 30;
+    
+    std::string path = (std::filesystem::temp_directory_path() / "rc_test.rcdem").string();
+    grid.save(path);
+    {
+        ElevationGrid loaded = ElevationGrid::load(path);
+        EXPECT_EQ(loaded.cols(), 3u);
+        EXPECT_EQ(loaded.rows(), 2u);
+        EXPECT_DOUBLE_EQ(loaded.sample(110, 200), 10);
+        EXPECT_DOUBLE_EQ(loaded.sample(110, 205), 20);
+        EXPECT_DOUBLE_EQ(loaded.sample(105, 210), 15);
+        EXPECT_DOUBLE_EQ(loaded.sample(90, 200), 0);
+        
+        ElevationGridCache cache;
+        auto a = cache.get(path);
+        auto b = cache.get(path);
+        EXPECT_EQ(a.get(), b.get());
+        EXPECT_EQ(cache.hits(), 1u);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(Scenario, MultipleDemsKeepBelowSeaLevelElevations) {
+    auto dir = std::filesystem::temp_directory_path();
+    ElevationGrid low(2, 2, 0, 0, 100);
+    ElevationGrid high(2, 2, 50, 0, 100);
+    for (uint32_t r = 0; r < 2; r++) {
+        for (uint32_t c = 0; c < 2; c++) {
+            low.at(c, r) = -40;
+            high.at(c, r) = -10;
+        }
+    }
+    Scenario sc;
+    sc.baseDir = dir.string();
+    low.save((dir / "rc_low.rcdem").string());
+    high.save((dir / "rc_high.rcdem").string());
+    sc.dems = {{"rc_low.rcdem"}, {"rc_high.rcdem"}};
+
+    CoverageMergeManager manager;
+    applyScenario(sc, manager);
+    std::filesystem::remove(dir / "rc_low.rcdem");
+    std::filesystem::remove(dir / "rc_high.rcdem");
+
+    EXPECT_DOUBLE_EQ(manager.terrain().getElevation(20, 50), -40);    // 仅 low 覆盖
+    EXPECT_DOUBLE_EQ(manager.terrain().getElevation(80, 50), -10);    // 重叠取较高者
+    EXPECT_DOUBLE_EQ(manager.terrain().getElevation(140, 50), -10);   // 仅 high 覆盖
+    EXPECT_DOUBLE_EQ(manager.terrain().getElevation(500, 50), 0);     // 均未覆盖
+}
+
+TEST(TiledDem, MatchesGridAndStaysWithinCacheBudget) {
+    FractalTerrainOptions options;
+    options.seed = 11;
+    options.cols = 70;
+    options.rows = 45;
+    options.cellSize = 30.0;
+    options.originX = 1000.0;
+    options.originY = -500.0;
+    ElevationGrid grid = generateFractalTerrain(options);
+
+    std::string path = (std::filesystem::temp_directory_path() / "rc_test.rctdem").string();
+    TiledDem::write(grid, path, 16);
+    {
+        TiledDem dem(path, 0x4000);
+        EXPECT_EQ(dem.tilesX(), 5u);                   // 69 个间隔 / 16
+        EXPECT_EQ(dem.tilesY(), 3u);
+        EXPECT_THROW(dem.setCacheBudget(dem.tileBytes() - 1), std::invalid_argument);
+        dem.setCacheBudget(3 * dem.tileBytes());
+
+        for (double y = grid.originY(); y <= grid.maxY(); y += 7.3) {
+            for (double x = grid.originX(); x <= grid.maxX(); x += 11.1) {
+                ASSERT_NEAR(dem.sample(x, y), grid.sample(x, y), 1e-9) << x << "," << y;
+            }
+        }
+        EXPECT_DOUBLE_EQ(dem.sample(grid.maxX(), grid.maxY()), grid.sample(grid.maxX(), grid.maxY()));
+        EXPECT_EQ(dem.sample(grid.originX() - 1, grid.originY()), 0.0);
+
+        DemCacheStats s = dem.stats();
+        EXPECT_LE(s.peakResidentBytes, s.budgetBytes);
+        EXPECT_GT(s.evictions, 0u);
+        EXPECT_EQ(s.bytesRead, s.misses * dem.tileBytes());
+
+        // 反复访问同一瓦片内的点只在第一次读盘
+        dem.resetStats();
+        for (int i = 0; i < 10; i++) {
+            dem.sample(grid.originX() + 5, grid.originY() + 5);
+            dem.sample(grid.originX() + 500, grid.originY() + 5);
+        }
+        s = dem.stats();
+        EXPECT_LE(s.misses, 2u);
+        EXPECT_GT(s.hitRate(), 0.8);
+
+        // 同一瓦片内连续采样走线程快速路径，同样计入命中（换瓦片时计入）
+        dem.resetStats();
+        for (int i = 0; i < 200; i++) dem.sample(grid.originX() + 5 + i % 7, grid.originY() + 5);
+        dem.sample(grid.originX() + 500, grid.originY() + 5);
+        s = dem.stats();
+        EXPECT_EQ(s.threadHits, 199u);
+        EXPECT_EQ(s.hits + s.misses, 201u);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(SpatialOrder, HilbertVisitsNeighboursConsecutively) {
+    std::vector<Point2D> points;
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) points.emplace_back(x, y);
+    }
+    std::vector<size_t> order = hilbertOrder(points);
+    ASSERT_EQ(order.size(), 64u);
+    for (size_t i = 1; i < order.size(); i++) {
+        const Point2D& a = points[order[i - 1]];
+        const Point2D& b = points[order[i]];
+        EXPECT_DOUBLE_EQ(std::abs(a.x - b.x) + std::abs(a.y - b.y), 1.0);
+    }
+}
+
+TEST(Scenario, ApplyPopulatesManager) {
+    Scenario sc;
+    sc.settings.numRays = 24;
+    sc.obstacles.emplace_back(Point2D{50, 0}, 10, 10, 1000, "wall");
+    sc.radars.emplace_back(1, "A", Point2D{0, 0}, 100, 10);
+    sc.radars.emplace_back(2, "B", Point2D{300, 0}, 100, 10);
+    
+    CoverageMergeManager manager;
+    manager.addRadar(RadarParams(9, "old", {0, 0}, 10, 10));
+    applyScenario(sc, manager);
+    
+    EXPECT_EQ(manager.getRadars().size(), 2u);
+    EXPECT_EQ(manager.getNumRays(), 24);
+    EXPECT_EQ(manager.terrain().getObstacles().size(), 1u);
+    EXPECT_EQ(manager.getMergedCoverage().size(), 2u);
+}
+
+// ============================================================================
+// 合成场景生成测试
+// ============================================================================
+
+TEST(SyntheticScenario, SameSeedIsBitIdentical) {
+    SyntheticScenarioOptions options;
+    options.seed = 42;
+    options.numRadars = 500;
+    options.numObstacles = 120;
+
+    std::string a, b;
+    {
+        BufferedWriter out([&](const char* p, size_t n) { a.append(p, n); });
+        writeScenarioBinary(out, generateSyntheticScenario(options));
+    }
+    {
+        BufferedWriter out([&](const char* p, size_t n) { b.append(p, n); });
+        writeScenarioBinary(out, generateSyntheticScenario(options));
+    }
+    EXPECT_EQ(a, b);
+
+    options.seed = 43;
+    Scenario other = generateSyntheticScenario(options);
+    Scenario first = parseScenarioBinary(reinterpret_cast<const uint8_t*>(a.data()), a.size());
+    EXPECT_NE(first.radars[0].position.x, other.radars[0].position.x);
+}
+
+TEST(SyntheticScenario, RespectsCountsExtentAndRanges) {
+    SyntheticScenarioOptions options;
+    options.numRadars = 2000;
+    options.numObstacles = 301;
+    options.numRanges = 7;
+    options.extentX = 50000;
+    options.extentY = 20000;
+    Scenario sc = generateSyntheticScenario(options);
+
+    ASSERT_EQ(sc.radars.size(), 2000u);
+    ASSERT_EQ(sc.obstacles.size(), 301u);
+
+    size_t sectors = 0;
+    for (const auto& r : sc.radars) {
+        EXPECT_GE(r.position.x, 0);
+        EXPECT_LE(r.position.x, options.extentX);
+        EXPECT_GE(r.position.y, 0);
+        EXPECT_LE(r.position.y, options.extentY);
+        EXPECT_GE(r.range, options.minRadarRange);
+        EXPECT_LE(r.range, options.maxRadarRange);
+        EXPECT_GT(r.height, 0);
+        if (!r.isOmnidirectional()) sectors++;
+    }
+    // 约 20% 为扇区雷达
+    EXPECT_GT(sectors, 200u);
+    EXPECT_LT(sectors, 600u);
+
+    for (const auto& o : sc.obstacles) {
+        EXPECT_GE(o.center.x, 0);
+        EXPECT_LE(o.center.x, options.extentX);
+        EXPECT_GT(o.height, 0);
+    }
+}
+
+TEST(FractalTerrain, DeterministicAcrossThreadCountsAndCropped) {
+    FractalTerrainOptions options;
+    options.seed = 11;
+    options.cols = 300;
+    options.rows = 130;
+    options.cellSize = 25;
+    options.relief = 1200;
+    options.baseElevation = 100;
+
+    options.threads = 1;
+    ElevationGrid a = generateFractalTerrain(options);
+    options.threads = 4;
+    ElevationGrid b = generateFractalTerrain(options);
+
+    ASSERT_EQ(a.cols(), 300u);
+    ASSERT_EQ(a.rows(), 130u);
+    EXPECT_EQ(std::memcmp(a.data(), b.data(), 300 * 130 * sizeof(float)), 0);
+
+    auto [lo, hi] = std::minmax_element(a.data(), a.data() + 300 * 130);
+    EXPECT_NEAR(*lo, 100.0, 1e-3);
+    EXPECT_NEAR(*hi, 1300.0, 1e-2);
+
+    options.seed = 12;
+    ElevationGrid c = generateFractalTerrain(options);
+    EXPECT_NE(std::memcmp(a.data(), c.data(), 300 * 130 * sizeof(float)), 0);
+}
+
+TEST(FractalTerrain, RoughnessControlsLocalVariation) {
+    auto meanSlope = [](double roughness) {
+        FractalTerrainOptions options;
+        options.cols = options.rows = 257;
+        options.roughness = roughness;
+        ElevationGrid g = generateFractalTerrain(options);
+        double sum = 0.0;
+        for (uint32_t r = 0; r < g.rows(); r++) {
+            for (uint32_t c = 1; c < g.cols(); c++) sum += std::abs(g.at(c, r) - g.at(c - 1, r));
+        }
+        return sum / (g.rows() * (g.cols() - 1));
+    };
+    EXPECT_GT(meanSlope(0.75), 2 * meanSlope(0.4));
+
+    FractalTerrainOptions bad;
+    bad.roughness = 1.0;
+    EXPECT_THROW(generateFractalTerrain(bad), std::invalid_argument);
+}
+
+TEST(FractalTerrain, PlugsIntoTerrainModel) {
+    FractalTerrainOptions options;
+    options.cols = options.rows = 65;
+    options.cellSize = 10;
+    auto dem = std::make_shared<const ElevationGrid>(generateFractalTerrain(options));
+
+    TerrainModel terrain;
+    terrain.setElevationFunction(ElevationGrid::asFunction(dem));
+    EXPECT_DOUBLE_EQ(terrain.getElevation(320, 160), dem->at(32, 16));
+}
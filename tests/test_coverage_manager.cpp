@@ -0,0 +1,1358 @@
+/**
+ * test_coverage_manager.cpp
+ *
+ * 覆盖合并管理器单元测试
+ */
+
+#include <gtest/gtest.h>
+#include "radar_coverage.hpp"
+#include "trace_events.hpp"
+#include "async_coverage.hpp"
+#include "coverage_patch.hpp"
+#include "geodetic.hpp"
+#include "tiled_coverage.hpp"
+#include "dem_prefetch.hpp"
+#include "horizon_store.hpp"
+#include "scenario_generator.hpp"
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <random>
+#include <cmath>
+#include <string>
+#include <thread>
+
+using namespace polygon_ops;
+using namespace radar_coverage;
+
+// ============================================================================
+// 性能计数器测试
+// ============================================================================
+
+TEST(PerfStats, CountsTerrainSamplingPerUpdate) {
+    if (!PerfStats::enabled) GTEST_SKIP() << "RADAR_COVERAGE_PERF_STATS=0";
+
+    CoverageMergeManager manager;
+    manager.setNumRays(8);
+    manager.setSimplifyEpsilon(0);
+    manager.setSmoothIterations(0);
+    manager.addRadar(RadarParams(1, "A", {0, 0}, 100, 10));
+    manager.getMergedCoverage();
+
+    const PerfStats& stats = manager.getPerfStats();
+    EXPECT_EQ(stats.updates, 1u);
+    EXPECT_EQ(stats.raysCast, 8u);
+    // 无遮挡：二分直到区间 < 1% 量程需 7 次迭代，每次一次视线检查
+    EXPECT_EQ(stats.bisectionIterations, 8u * 7u);
+    EXPECT_EQ(stats.losChecks, stats.bisectionIterations);
+    EXPECT_EQ(stats.elevationEvaluations,
+              stats.losChecks * (manager.getSamplingSettings().losSamples - 1));
+    EXPECT_GE(stats.updateMs, stats.generateMs);
+    EXPECT_EQ(stats.smoothMs, 0.0);
+}
+
+TEST(PerfStats, AccumulatesOnlyOnRecomputeAndResets) {
+    if (!PerfStats::enabled) GTEST_SKIP() << "RADAR_COVERAGE_PERF_STATS=0";
+
+    CoverageMergeManager manager;
+    manager.setNumRays(16);
+    manager.addRadar(RadarParams(1, "A", {0, 0}, 100, 10));
+    manager.addRadar(RadarParams(2, "B", {120, 0}, 100, 10));
+    manager.getMergedCoverage();
+    manager.getMergedCoverage();     // 未变脏，不重算
+
+    EXPECT_EQ(manager.getPerfStats().updates, 1u);
+    EXPECT_EQ(manager.getPerfStats().clipperInputVertices, 32u);
+    EXPECT_GT(manager.getPerfStats().clipperOutputVertices, 0u);
+
+    manager.resetPerfStats();
+    EXPECT_EQ(manager.getPerfStats().raysCast, 0u);
+
+    manager.invalidate();
+    manager.getMergedCoverage();
+    EXPECT_EQ(manager.getPerfStats().updates, 1u);
+    EXPECT_EQ(manager.getPerfStats().raysCast, 32u);
+}
+
+TEST(PerfStats, SinkScopeNestsAndRestores) {
+    if (!PerfStats::enabled) GTEST_SKIP() << "RADAR_COVERAGE_PERF_STATS=0";
+
+    TerrainModel terrain;
+    PerfStats outer, inner;
+    {
+        PerfSinkScope a(&outer);
+        terrain.getElevation(0, 0);
+        {
+            PerfSinkScope b(&inner);
+            terrain.getElevation(0, 0);
+            terrain.getElevation(0, 0);
+        }
+        terrain.getElevation(0, 0);
+    }
+    terrain.getElevation(0, 0);      // 无接收者，不计数
+
+    EXPECT_EQ(outer.elevationEvaluations, 2u);
+    EXPECT_EQ(inner.elevationEvaluations, 2u);
+
+    outer.merge(inner);
+    EXPECT_EQ(outer.elevationEvaluations, 4u);
+}
+
+TEST(PerfStats, ParallelGenerationMergesWorkerCounters) {
+    if (!PerfStats::enabled) GTEST_SKIP() << "RADAR_COVERAGE_PERF_STATS=0";
+
+    CoverageMergeManager manager;
+    manager.setNumRays(12);
+    manager.setNumThreads(4);
+    for (int i = 0; i < 16; i++) {
+        manager.addRadar(RadarParams(i, "R", {i * 50.0, 0}, 100, 10));
+    }
+    manager.getMergedCoverage();
+
+    EXPECT_EQ(manager.getPerfStats().raysCast, 16u * 12u);
+    EXPECT_EQ(manager.getPerfStats().updates, 1u);
+}
+
+// ============================================================================
+// 时间步进测试
+// ============================================================================
+
+namespace {
+
+CoverageMergeManager makeSteppedManager() {
+    CoverageMergeManager manager;
+    manager.setNumRays(16);
+    manager.setSimplifyEpsilon(0);
+    manager.setSmoothIterations(0);
+    manager.terrain().addObstacle({60, 40}, 20, 20, 500);
+    for (int i = 0; i < 6; i++) {
+        manager.addRadar(RadarParams(i + 1, "R", {i * 80.0, 0}, 100, 10));
+    }
+    return manager;
+}
+
+} // namespace
+
+TEST(Step, RecomputesOnlyMovedRadars) {
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.getMergedCoverage();
+
+    StepResult r1 = manager.step(0.05, {{2, {90, 10}, 12}, {5, {330, -5}, 10}, {99, {0, 0}, 1}});
+    EXPECT_EQ(r1.step, 1u);
+    EXPECT_DOUBLE_EQ(r1.time, 0.05);
+    EXPECT_EQ(r1.timings.radarsRecomputed, 2u);
+    EXPECT_EQ(manager.getMovingRadarCount(), 2u);
+    EXPECT_EQ(manager.getRadars()[1].position.x, 90);
+
+    // 位姿未变：不重算
+    StepResult r2 = manager.step(0.05, {{2, {90, 10}, 12}});
+    EXPECT_EQ(r2.timings.radarsRecomputed, 0u);
+    EXPECT_EQ(r2.timings.totalMs, 0.0);
+
+    StepResult r3 = manager.step(0.05, {{5, {340, -5}, 10}});
+    EXPECT_EQ(r3.timings.radarsRecomputed, 1u);
+    EXPECT_EQ(&r3.coverage, &manager.getMergedCoverage());
+}
+
+TEST(Step, MatchesFullRecompute) {
+    CoverageMergeManager stepped = makeSteppedManager();
+    stepped.setWarmStartRays(false);     // 热启动结果只在容差内一致
+    stepped.getMergedCoverage();
+    for (int k = 1; k <= 5; k++) {
+        stepped.step(0.1, {{1, {k * 7.0, k * 3.0}, 10}, {4, {240.0 - k * 5, 0}, 10.0 + k}});
+    }
+
+    CoverageMergeManager full = makeSteppedManager();
+    for (const auto& r : stepped.getRadars()) full.updateRadar(r.id, r);
+
+    PolygonStats a = stepped.getStats();
+    PolygonStats b = full.getStats();
+    EXPECT_EQ(a.regionCount, b.regionCount);
+    EXPECT_NEAR(a.totalArea, b.totalArea, 1e-6 * b.totalArea);
+    EXPECT_NEAR(a.totalPerimeter, b.totalPerimeter, 1e-6 * b.totalPerimeter);
+}
+
+TEST(Step, TerrainEditWithoutInvalidateRefreshesOtherRadars) {
+    // addRadar / updateRadar 只标记单部雷达，地形修改须经版本跟踪使受影响雷达重算
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.getMergedCoverage();
+    manager.terrain().addObstacle({430, 0}, 15, 15, 500);
+    manager.addRadar(RadarParams(7, "N", {0, 400}, 50, 10));
+
+    CoverageMergeManager fresh = makeSteppedManager();
+    fresh.terrain().addObstacle({430, 0}, 15, 15, 500);
+    fresh.addRadar(RadarParams(7, "N", {0, 400}, 50, 10));
+
+    PolygonStats a = manager.getStats();
+    PolygonStats b = fresh.getStats();
+    EXPECT_EQ(a.regionCount, b.regionCount);
+    EXPECT_NEAR(a.totalArea, b.totalArea, 1e-6 * b.totalArea);
+}
+
+TEST(Step, RotatesSectorAndSettlesIdleRadars) {
+    CoverageMergeManager manager = makeSteppedManager();
+    RadarParams sector(7, "S", {0, 200}, 100, 10);
+    sector.azimuthStart = 0;
+    sector.azimuthEnd = M_PI / 2;
+    manager.addRadar(sector);
+    manager.setMovingSettleTime(0.25);
+
+    RadarPose pose{7, {0, 200}, 10};
+    pose.azimuthStart = M_PI;
+    manager.step(0.1, {pose});
+    EXPECT_DOUBLE_EQ(manager.getRadars().back().azimuthEnd, 1.5 * M_PI);
+    EXPECT_EQ(manager.getMovingRadarCount(), 1u);
+
+    manager.step(0.1, {});
+    manager.step(0.1, {});
+    EXPECT_EQ(manager.getMovingRadarCount(), 1u);
+    StepResult settled = manager.step(0.1, {});
+    EXPECT_EQ(manager.getMovingRadarCount(), 0u);
+    EXPECT_EQ(settled.timings.radarsRecomputed, 0u);
+}
+
+// ============================================================================
+// 热启动测试
+// ============================================================================
+
+TEST(WarmStart, AgreesWithColdSearchWithinTolerance) {
+    TerrainModel terrain;
+    terrain.addObstacle({50, 0}, 10, 10, 1000);
+    const double maxRange = 100;
+    const double tol = maxRange * terrain.getSamplingSettings().rangeTolerance;
+
+    for (double azimuth : {0.0, 0.3, M_PI / 2, M_PI}) {
+        double cold = terrain.computeMaxVisibleRange({0, 0}, 10, azimuth, maxRange);
+        for (double hint : {cold, cold + 0.5 * tol, 0.0, 30.0, maxRange}) {
+            double warm = terrain.computeMaxVisibleRangeNear({0, 0}, 10, azimuth, maxRange, hint);
+            EXPECT_NEAR(warm, cold, tol) << "azimuth " << azimuth << " hint " << hint;
+        }
+    }
+}
+
+TEST(WarmStart, SlowMotionHitsBracketAndCutsBisection) {
+    if (!PerfStats::enabled) GTEST_SKIP() << "RADAR_COVERAGE_PERF_STATS=0";
+
+    auto run = [](bool warm) {
+        CoverageMergeManager manager = makeSteppedManager();
+        manager.setWarmStartRays(warm);
+        manager.getMergedCoverage();
+        manager.resetPerfStats();
+        for (int k = 1; k <= 4; k++) manager.step(0.05, {{1, {0.2 * k, 0}, 10}});
+        return manager.getPerfStats();
+    };
+    PerfStats cold = run(false);
+    PerfStats warm = run(true);
+
+    EXPECT_EQ(warm.raysCast, cold.raysCast);
+    EXPECT_EQ(cold.warmStartHits, 0u);
+    EXPECT_GT(warm.warmStartHits, 3 * warm.warmStartMisses);
+    EXPECT_LT(warm.losChecks * 2, cold.losChecks);
+}
+
+TEST(WarmStart, HintsDoNotSurviveNonStepUpdates) {
+    // 热启动保持开启：step 积累 hint 后，updateRadar / invalidate 的结果与新建管理器逐位一致
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.getMergedCoverage();
+    for (int k = 1; k <= 4; k++) manager.step(0.05, {{1, {3.0 * k, 2.0 * k}, 10}});
+
+    RadarParams moved(1, "R", {45, 10}, 100, 10);
+    manager.updateRadar(1, moved);
+    CoverageMergeManager fresh = makeSteppedManager();
+    fresh.updateRadar(1, moved);
+    auto expectSame = [](const Polygon& a, const Polygon& b) {
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            EXPECT_EQ(a[i].x, b[i].x);
+            EXPECT_EQ(a[i].y, b[i].y);
+        }
+    };
+    expectSame(manager.getIndividualCoverages()[0], fresh.getIndividualCoverages()[0]);
+
+    manager.step(0.05, {{1, {40, 12}, 10}});
+    manager.invalidate();
+    CoverageMergeManager cold = makeSteppedManager();
+    cold.setWarmStartRays(false);
+    cold.updateRadar(1, manager.getRadars()[0]);
+    expectSame(manager.getIndividualCoverages()[0], cold.getIndividualCoverages()[0]);
+}
+
+// ============================================================================
+// 异步重算测试
+// ============================================================================
+
+TEST(AsyncCoverage, ReadersSeeLastSnapshotWhileWorkerIsBusy) {
+    AsyncCoverageManager async(makeSteppedManager());
+    auto first = async.waitFor(async.submit([](CoverageMergeManager&) {}));
+    EXPECT_EQ(first->generation, 1u);
+    EXPECT_EQ(first->radarCount, 6u);
+    EXPECT_FALSE(first->coverage.empty());
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    uint64_t blocked = async.submit([gate](CoverageMergeManager&) { gate.wait(); });
+    uint64_t added = async.addRadar(RadarParams(50, "N", {0, 300}, 100, 10));
+
+    // 工作线程被阻塞，读者立即拿到旧快照
+    auto stale = async.snapshot();
+    EXPECT_EQ(stale.get(), first.get());
+    EXPECT_FALSE(async.isCurrent(*stale));
+    EXPECT_EQ(async.generation(), added);
+
+    release.set_value();
+    auto fresh = async.waitFor(added);
+    EXPECT_GE(fresh->generation, blocked);
+    EXPECT_TRUE(async.isCurrent(*fresh));
+    EXPECT_EQ(fresh->radarCount, 7u);
+    // 旧快照在读者释放前保持有效
+    EXPECT_EQ(stale->radarCount, 6u);
+}
+
+TEST(AsyncCoverage, DestructionReleasesWaiters) {
+    auto async = std::make_unique<AsyncCoverageManager>(makeSteppedManager());
+    const AsyncCoverageManager* manager = async.get();
+    uint64_t never = async->generation() + 1;           // 不会有这一代
+    std::promise<void> started;
+    auto waiter = std::async(std::launch::async, [&started, manager, never]() {
+        started.set_value();
+        return manager->waitFor(never);
+    });
+    started.get_future().wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));    // 让等待者进入 waitFor
+
+    async.reset();
+    ASSERT_EQ(waiter.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(waiter.get());
+}
+
+TEST(AsyncCoverage, CoalescesStepsAndReportsErrors) {
+    AsyncCoverageManager async(makeSteppedManager());
+    for (int k = 1; k <= 10; k++) async.step(0.1, {{3, {160.0 + k, 0}, 10}});
+    auto snap = async.waitForCurrent();
+    EXPECT_EQ(snap->step, 10u);
+    EXPECT_NEAR(snap->time, 1.0, 1e-9);
+
+    async.submit([](CoverageMergeManager&) { throw std::runtime_error("bad edit"); });
+    auto failed = async.waitForCurrent();
+    EXPECT_EQ(failed->error, "bad edit");
+    EXPECT_EQ(failed->coverage.size(), snap->coverage.size());
+    EXPECT_EQ(failed->timings.radarsRecomputed, 0u);    // 未触发重算，不沿用旧计时
+    EXPECT_EQ(failed->timings.totalMs, 0.0);
+}
+
+TEST(AsyncCoverage, FailedEditDoesNotDropRestOfBatch) {
+    AsyncCoverageManager async(makeSteppedManager());
+    async.waitForCurrent();
+
+    // 阻塞工作线程，使以下修改落在同一批
+    std::promise<void> entered, release;
+    std::shared_future<void> gate = release.get_future().share();
+    async.submit([&entered, gate](CoverageMergeManager&) {
+        entered.set_value();
+        gate.wait();
+    });
+    entered.get_future().wait();
+    async.addRadar(RadarParams(20, "A", {0, 500}, 50, 10));
+    async.submit([](CoverageMergeManager&) { throw std::runtime_error("first"); });
+    async.submit([](CoverageMergeManager&) { throw 42; });
+    uint64_t last = async.addRadar(RadarParams(21, "B", {0, 700}, 50, 10));
+    release.set_value();
+
+    auto snap = async.waitFor(last);
+    EXPECT_TRUE(async.isCurrent(*snap));
+    EXPECT_EQ(snap->radarCount, 8u);
+    EXPECT_EQ(snap->error, "first\nunknown exception");
+    EXPECT_GT(snap->timings.radarsRecomputed, 0u);
+}
+
+// ============================================================================
+// 追踪测试
+// ============================================================================
+
+TEST(Tracer, RecordsPipelineSpansAsChromeTrace) {
+    if (!RADAR_COVERAGE_TRACING) GTEST_SKIP() << "RADAR_COVERAGE_TRACING=0";
+
+    CoverageMergeManager manager;
+    manager.setNumRays(8);
+    manager.addRadar(RadarParams(7, "A", {0, 0}, 100, 10));
+    manager.addRadar(RadarParams(8, "B", {50, 0}, 100, 10));
+
+    Tracer tracer;
+    tracer.start();
+    tracer.setThreadName("main");
+    manager.getMergedCoverage();
+    tracer.stop();
+    manager.invalidate();
+    manager.getMergedCoverage();     // 停止后不再记录
+
+    std::string json;
+    {
+        BufferedWriter out([&](const char* p, size_t n) { json.append(p, n); });
+        writeChromeTrace(out, tracer);
+    }
+
+    auto count = [&json](const std::string& needle) {
+        size_t n = 0;
+        for (size_t pos = json.find(needle); pos != std::string::npos;
+             pos = json.find(needle, pos + 1)) n++;
+        return n;
+    };
+    EXPECT_EQ(count("\"name\":\"updateIfDirty\""), 1u);
+    EXPECT_EQ(count("\"name\":\"generateCoverage\""), 2u);
+    EXPECT_EQ(count("\"radar\":8"), 1u);
+    EXPECT_EQ(count("\"name\":\"unionAll\""), 1u);
+    EXPECT_EQ(count("\"thread_name\""), 1u);
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+}
+
+TEST(Tracer, SeparatesThreadsWithoutLosingEvents) {
+    if (!RADAR_COVERAGE_TRACING) GTEST_SKIP() << "RADAR_COVERAGE_TRACING=0";
+
+    Tracer tracer;
+    tracer.start();
+    // 超过单块容量，覆盖跨块追加
+    const size_t kEvents = TraceThreadBuffer::kChunkEvents * 2 + 10;
+    parallelFor(kEvents, 4, [](size_t i, size_t) {
+        RADAR_COVERAGE_TRACE_SCOPE_ARG("work", "test", "i", i);
+    }, 64);
+    tracer.stop();
+
+    size_t events = 0;
+    size_t buffers = 0;
+    tracer.forEachBuffer([&](const TraceThreadBuffer& buf) {
+        buffers++;
+        buf.forEach([&](const TraceEvent& e) {
+            EXPECT_GE(e.durationNs, 0);
+            events++;
+        });
+    });
+    EXPECT_EQ(events, kEvents);
+    EXPECT_GE(buffers, 1u);
+    EXPECT_LE(buffers, 4u);
+}
+
+// ============================================================================
+// 渐进式细化测试
+// ============================================================================
+
+TEST(Progressive, RefinesToFullRayCountAndPublishesEachPass) {
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.setNumRays(48);
+    RadarParams sector(9, "S", {0, 200}, 100, 10);
+    sector.azimuthStart = 0;
+    sector.azimuthEnd = M_PI;
+    manager.addRadar(sector);
+
+    ProgressiveOptions options;
+    options.initialRays = 6;
+    std::vector<ProgressivePass> passes;
+    std::vector<size_t> vertexCounts;
+    ProgressiveStatus status = manager.refineProgressive(options, [&](const ProgressivePass& p) {
+        passes.push_back(p);
+        size_t v = 0;
+        for (const auto& pwh : p.coverage) v += pwh.outer.size();
+        vertexCounts.push_back(v);
+    });
+
+    EXPECT_EQ(status, ProgressiveStatus::Complete);
+    ASSERT_GE(passes.size(), 4u);
+    EXPECT_EQ(passes[0].pass, 0);
+    EXPECT_EQ(passes[0].raysInterpolated, 0u);
+    EXPECT_TRUE(passes.back().complete);
+    for (size_t i = 1; i < vertexCounts.size(); i++) EXPECT_GE(vertexCounts[i], vertexCounts[i - 1]);
+
+    // 平坦区域插值，只在遮挡边缘补射：总投射数少于全分辨率
+    size_t cast = 0, interpolated = 0;
+    for (const auto& p : passes) {
+        cast += p.raysCast;
+        interpolated += p.raysInterpolated;
+    }
+    EXPECT_GT(interpolated, 0u);
+    EXPECT_LT(cast - passes[0].raysCast, 7u * 48u);
+
+    // 管理器缓存不受影响
+    EXPECT_EQ(manager.getIndividualCoverages()[0].size(), 48u);
+}
+
+TEST(Progressive, StopsOnDeadlineAndCancellation) {
+    CoverageMergeManager manager = makeSteppedManager();
+
+    ProgressiveOptions expired;
+    expired.deadline = std::chrono::steady_clock::now();
+    int published = 0;
+    EXPECT_EQ(manager.refineProgressive(expired, [&](const ProgressivePass& p) {
+        published++;
+        EXPECT_FALSE(p.complete);
+        EXPECT_EQ(p.raysCast, 0u);
+    }), ProgressiveStatus::DeadlineReached);
+    EXPECT_EQ(published, 1);
+
+    manager.setNumRays(72);
+    std::atomic<bool> cancel{false};
+    ProgressiveOptions cancellable;
+    cancellable.cancel = &cancel;
+    int passes = 0;
+    EXPECT_EQ(manager.refineProgressive(cancellable, [&](const ProgressivePass& p) {
+        passes++;
+        if (p.pass == 1) cancel = true;
+    }), ProgressiveStatus::Cancelled);
+    EXPECT_EQ(passes, 3);
+}
+
+// ============================================================================
+// 地形版本测试
+// ============================================================================
+
+TEST(TerrainVersion, RecordsChangedRegions) {
+    TerrainModel terrain;
+    EXPECT_EQ(terrain.version(), 0u);
+    terrain.addObstacle({100, 50}, 10, 20, 300);
+    terrain.addObstacle({-40, 0}, 5, 5, 100);
+    EXPECT_EQ(terrain.version(), 2u);
+
+    TerrainChangeSet since1 = terrain.changesSince(1);
+    ASSERT_EQ(since1.regions.size(), 1u);
+    EXPECT_FALSE(since1.global);
+    EXPECT_DOUBLE_EQ(since1.regions[0].minX, -45);
+    EXPECT_DOUBLE_EQ(since1.regions[0].maxY, 5);
+    EXPECT_EQ(terrain.changesSince(0).regions.size(), 2u);
+    EXPECT_TRUE(terrain.changesSince(2).empty());
+
+    terrain.setElevationFunction([](double, double) { return 1.0; });
+    EXPECT_TRUE(terrain.changesSince(1).global);
+
+    for (size_t i = 0; i < TerrainModel::kMaxChangeLog; i++) {
+        terrain.markChanged({0, 0, 1, 1});
+    }
+    EXPECT_TRUE(terrain.changesSince(2).global);     // 版本 3 已被截断
+    EXPECT_FALSE(terrain.changesSince(3).global);
+    EXPECT_FALSE(terrain.changesSince(terrain.version() - 5).global);
+}
+
+TEST(TerrainVersion, RecomputesOnlyRadarsReachingTheEdit) {
+    CoverageMergeManager manager = makeSteppedManager();     // 雷达位于 x = 0..400，量程 100
+    manager.getMergedCoverage();
+    Polygon before = manager.getIndividualCoverages()[5];
+
+    // 新山位于 x = 440，只在最后一部雷达 (x = 400) 的量程内
+    manager.terrain().addObstacle({440, 0}, 10, 10, 1000);
+    manager.getMergedCoverage();
+    EXPECT_EQ(manager.getLastUpdateTimings().radarsRecomputed, 1u);
+    EXPECT_LT(PolygonUtils::area(manager.getIndividualCoverages()[5]), PolygonUtils::area(before));
+
+    // 远离所有雷达：不重算任何雷达
+    manager.terrain().addObstacle({5000, 5000}, 10, 10, 1000);
+    manager.getMergedCoverage();
+    EXPECT_EQ(manager.getLastUpdateTimings().radarsRecomputed, 1u);   // 未发生重算
+
+    manager.terrain().removeObstacle(manager.terrain().getObstacles().size() - 1);
+    manager.terrain().setObstacle(0, TerrainObstacle({140, 40}, 20, 20, 500));
+    manager.getMergedCoverage();
+    EXPECT_EQ(manager.getLastUpdateTimings().radarsRecomputed, 4u);   // x = 0, 80, 160, 240
+
+    manager.terrain().setElevationFunction([](double, double) { return 0.0; });
+    manager.getMergedCoverage();
+    EXPECT_EQ(manager.getLastUpdateTimings().radarsRecomputed, 6u);
+}
+
+TEST(TerrainVersion, AssigningAnotherTerrainRecomputesEverything) {
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.terrain().addObstacle({440, 0}, 10, 10, 1000);
+    manager.getMergedCoverage();
+    ASSERT_GT(manager.terrain().version(), 0u);
+
+    // 新实例版本为 0（不大于已同步版本），且不含旧实例的障碍
+    TerrainModel flat;
+    manager.terrain() = flat;
+    CoverageMergeManager reference = makeSteppedManager();
+    reference.terrain() = flat;
+    EXPECT_NEAR(manager.getStats().totalArea, reference.getStats().totalArea, 1e-9);
+    EXPECT_EQ(manager.getLastUpdateTimings().radarsRecomputed, 6u);
+
+    // 版本更高的另一实例：只回放其自身日志会漏掉旧障碍的移除
+    TerrainModel other;
+    for (int k = 0; k < 5; k++) other.addObstacle({5000.0 + k, 5000}, 10, 10, 100);
+    manager.terrain().addObstacle({140, 40}, 20, 20, 800);
+    manager.getMergedCoverage();
+    manager.terrain() = std::move(other);
+    EXPECT_NEAR(manager.getStats().totalArea, reference.getStats().totalArea, 1e-9);
+}
+
+// ============================================================================
+// 覆盖增量
+// ============================================================================
+
+namespace {
+
+double totalArea(const MultiPolygon& mp) {
+    double a = 0;
+    for (const auto& pwh : mp) {
+        a += PolygonUtils::area(pwh.outer);
+        for (const auto& hole : pwh.holes) a -= PolygonUtils::area(hole);
+    }
+    return a;
+}
+
+} // namespace
+
+TEST(CoverageDelta, RestrictedToMovedRadarAndReconstructsResult) {
+    CoverageMergeManager manager = makeSteppedManager();     // 雷达位于 x = 0..400，量程 100
+    manager.setDeltaTracking(true);
+    MultiPolygon base = manager.getMergedCoverage();
+    uint64_t version = manager.getCoverageVersion();
+
+    // 首个结果相对版本 0（空）：全部为新增
+    EXPECT_EQ(manager.getCoverageDelta().fromVersion, 0u);
+    EXPECT_EQ(manager.getCoverageDelta().toVersion, version);
+    EXPECT_NEAR(totalArea(manager.getCoverageDelta().gained), totalArea(base), 1.0);
+
+    manager.step(0.1, {{6, {430, 0}, 10}});
+    const CoverageDelta& delta = manager.getCoverageDelta();
+    EXPECT_EQ(delta.fromVersion, version);
+    EXPECT_EQ(delta.toVersion, version + 1);
+    EXPECT_NEAR(delta.region.minX, 300, 1);                  // 旧覆盖 ∪ 新覆盖
+    EXPECT_NEAR(delta.region.maxX, 530, 1);
+    EXPECT_FALSE(delta.gained.empty());
+    EXPECT_GT(totalArea(delta.gained), 0.0);
+
+    MultiPolygon patched = applyCoveragePatch(base, readCoveragePatch(toCoveragePatch(delta, 0)));
+    EXPECT_NEAR(totalArea(patched), totalArea(manager.getMergedCoverage()), 1.0);
+}
+
+TEST(CoverageDelta, RemovalAndPostProcessingChanges) {
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.setDeltaTracking(true);
+    manager.getMergedCoverage();
+
+    manager.removeRadar(1);                                   // x = 0
+    const CoverageDelta& removed = manager.getCoverageDelta();
+    EXPECT_TRUE(removed.gained.empty());
+    EXPECT_FALSE(removed.lost.empty());
+    EXPECT_NEAR(removed.region.minX, -100, 1);
+    EXPECT_NEAR(removed.region.maxX, 100, 1);
+
+    // 后处理参数变化影响整个结果
+    manager.setSimplifyEpsilon(2.0);
+    const CoverageDelta& simplified = manager.getCoverageDelta();
+    EXPECT_NEAR(simplified.region.minX, -20, 1);
+    EXPECT_NEAR(simplified.region.maxX, 500, 1);
+
+    // 关闭跟踪后不再保留上一结果
+    manager.setDeltaTracking(false);
+    manager.step(0.1, {{3, {170, 0}, 10}});
+    EXPECT_TRUE(manager.getCoverageDelta().empty());
+}
+
+TEST(CoverageDelta, EnablingOnDirtyManagerCoversPendingChanges) {
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.getMergedCoverage();
+
+    // 关闭跟踪时删除的雷达没有记录范围，开启后的首个增量仍须包含它
+    manager.removeRadar(1);                                   // x = 0
+    manager.setDeltaTracking(true);
+    const CoverageDelta& delta = manager.getCoverageDelta();
+    EXPECT_NEAR(delta.region.minX, -100, 1);
+    EXPECT_NEAR(delta.region.maxX, 500, 1);
+    EXPECT_FALSE(delta.lost.empty());
+}
+
+TEST(CoverageDelta, FailedRecomputeKeepsPreviousResultAsBase) {
+    CoverageMergeManager manager = makeSteppedManager();
+    manager.setDeltaTracking(true);
+    MultiPolygon base = manager.getMergedCoverage();
+    uint64_t version = manager.getCoverageVersion();
+
+    manager.terrain().setElevationFunction([](double, double) -> double {
+        throw std::runtime_error("elevation source offline");
+    });
+    manager.updateRadar(6, RadarParams(6, "R", {430, 0}, 100, 10));
+    EXPECT_THROW(manager.getMergedCoverage(), std::runtime_error);
+
+    manager.terrain().setElevationFunction([](double, double) { return 0.0; });
+    const CoverageDelta& delta = manager.getCoverageDelta();
+    EXPECT_EQ(delta.fromVersion, version);
+    EXPECT_EQ(delta.toVersion, version + 1);
+    MultiPolygon patched = applyCoveragePatch(base, delta);
+    EXPECT_NEAR(totalArea(patched), totalArea(manager.getMergedCoverage()), 1.0);
+}
+
+// ============================================================================
+// 大地坐标
+// ============================================================================
+
+TEST(Geodetic, AeqdRoundTripsAndPreservesDistanceFromCenter) {
+    AeqdFrame frame({45.0, 10.0});
+
+    // 正北 1 度：距离为 R * 1°
+    Point2D north = frame.forward(GeoPoint{46.0, 10.0});
+    EXPECT_NEAR(north.x, 0.0, 1e-6);
+    EXPECT_NEAR(north.y, frame.radius() * M_PI / 180, 1e-6);
+
+    std::vector<double> lat = {45.0, 45.3, 44.1, 46.2, 45.0};
+    std::vector<double> lon = {10.0, 10.4, 9.2, 11.7, 8.5};
+    std::vector<double> x(lat.size()), y(lat.size()), lat2(lat.size()), lon2(lat.size());
+    frame.forward(lat.data(), lon.data(), x.data(), y.data(), lat.size());
+    frame.inverse(x.data(), y.data(), lat2.data(), lon2.data(), lat.size());
+    for (size_t i = 0; i < lat.size(); i++) {
+        EXPECT_NEAR(lat2[i], lat[i], 1e-9);
+        EXPECT_NEAR(lon2[i], lon[i], 1e-9);
+        Point2D p = frame.forward(GeoPoint{lat[i], lon[i]});
+        EXPECT_DOUBLE_EQ(p.x, x[i]);
+        EXPECT_DOUBLE_EQ(p.y, y[i]);
+    }
+    EXPECT_NEAR(x[0], 0.0, 1e-9);
+
+    // 跨越 ±180° 经线
+    AeqdFrame dateline({0.0, 179.9});
+    GeoPoint east = dateline.inverse(Point2D(50000, 0));
+    EXPECT_LT(east.lon, -179.0);
+    Point2D back = dateline.forward(east);
+    EXPECT_NEAR(back.x, 50000, 1e-6);
+    EXPECT_NEAR(back.y, 0, 1e-6);
+}
+
+TEST(Geodetic, GeneratorMatchesFlatFrameAndSeesDemRidge) {
+    AeqdFrame work({30.0, 100.0});
+    Point2D site = work.forward(GeoPoint{30.2, 100.1});
+
+    auto makeManager = []() {
+        CoverageMergeManager manager;
+        manager.setNumRays(16);
+        manager.setSimplifyEpsilon(0);
+        manager.setSmoothIterations(0);
+        return manager;
+    };
+
+    CoverageMergeManager flat = makeManager();
+    flat.addRadar(RadarParams(1, "R", site, 20000, 200));
+    Polygon expected = flat.getIndividualCoverages()[0];
+
+    CoverageMergeManager geo = makeManager();
+    geo.setCoverageGenerator(GeodeticCoverageGenerator(work,
+        [](const double*, const double*, double* h, size_t n) { std::fill(h, h + n, 0.0); }));
+    geo.addRadar(RadarParams(1, "R", site, 20000, 200));
+    Polygon actual = geo.getIndividualCoverages()[0];
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); i++) {
+        EXPECT_NEAR((actual[i] - site).length(), (expected[i] - site).length(), 0.01 * 20000);
+    }
+
+    // 雷达以东约 4.8 km 处南北走向的高墙
+    geo.setCoverageGenerator(GeodeticCoverageGenerator(work,
+        [](const double*, const double* lon, double* h, size_t n) {
+            for (size_t i = 0; i < n; i++) h[i] = lon[i] > 100.15 ? 2000.0 : 0.0;
+        }));
+    Polygon blocked = geo.getIndividualCoverages()[0];
+    EXPECT_GT((expected[0] - site).length(), 6000);
+    EXPECT_LT((blocked[0] - site).length(), 4900);                        // 方位 0 = 正东
+    EXPECT_GT((blocked[0] - site).length(), 4000);
+    EXPECT_NEAR((blocked[8] - site).length(), (expected[8] - site).length(), 0.01 * 20000);
+
+    MultiPolygon wgs = toWgs84({PolygonWithHoles{blocked, {}}}, work);
+    EXPECT_GT(wgs[0].outer[0].x, 100.14);                                 // x = 经度
+    EXPECT_LT(wgs[0].outer[0].x, 100.15);
+    EXPECT_NEAR(wgs[0].outer[0].y, 30.2, 1e-3);
+}
+
+// ============================================================================
+// 分块计算测试
+// ============================================================================
+
+TEST(TiledCoverage, PlansTilesByRangeCircle) {
+    TiledCoverageOptions opt;
+    opt.tileSize = 1000;
+    // 靠近四块交点但量程圆不触及对角瓦片 (-1, -1)
+    std::vector<RadarParams> radars = {RadarParams(1, "A", {150, 150}, 200, 10),
+                                       RadarParams(2, "B", {5500, 500}, 100, 10)};
+    TiledCoverageStats stats;
+    std::vector<CoverageTile> tiles = planTiles(radars, opt, &stats);
+
+    auto find = [&](int64_t x, int64_t y) -> const CoverageTile* {
+        for (const auto& t : tiles) {
+            if (t.id.level == 0 && t.id.x == x && t.id.y == y) return &t;
+        }
+        return nullptr;
+    };
+    ASSERT_NE(find(0, 0), nullptr);
+    ASSERT_NE(find(-1, 0), nullptr);
+    ASSERT_NE(find(0, -1), nullptr);
+    EXPECT_EQ(find(-1, -1), nullptr);           // 包围盒相交但圆不相交
+    ASSERT_NE(find(5, 0), nullptr);
+    EXPECT_EQ(find(5, 0)->radars, std::vector<size_t>{1});
+    EXPECT_EQ(stats.tiles, 4u);
+    EXPECT_EQ(stats.radarAssignments, 4u);
+    EXPECT_DOUBLE_EQ(find(-1, 0)->bounds.minX, -1000);
+    EXPECT_DOUBLE_EQ(find(-1, 0)->bounds.maxX, 0);
+}
+
+TEST(TiledCoverage, SubdividesCrowdedTiles) {
+    TiledCoverageOptions opt;
+    opt.tileSize = 4000;
+    opt.maxRadarsPerTile = 2;
+    std::vector<RadarParams> radars;
+    for (int i = 0; i < 4; i++) {
+        radars.push_back(RadarParams(i, "R", {500.0 + (i % 2) * 2000, 500.0 + (i / 2) * 2000}, 300, 10));
+    }
+    TiledCoverageStats stats;
+    std::vector<CoverageTile> tiles = planTiles(radars, opt, &stats);
+
+    EXPECT_EQ(stats.subdividedTiles, 1u);
+    ASSERT_EQ(tiles.size(), 4u);
+    for (const auto& t : tiles) {
+        EXPECT_EQ(t.id.level, 1);
+        EXPECT_EQ(t.radars.size(), 1u);
+        EXPECT_DOUBLE_EQ(t.bounds.width(), 2000);
+    }
+    EXPECT_EQ(stats.maxTileRadars, 1u);
+}
+
+TEST(TiledCoverage, TilesStayInBoundsAndReleaseRadarCoverages) {
+    TiledCoverageOptions opt;
+    opt.tileSize = 500;
+    opt.numRays = 16;
+    opt.numThreads = 2;
+    std::vector<RadarParams> radars;
+    for (int i = 0; i < 6; i++) radars.push_back(RadarParams(i, "R", {i * 1000.0 + 250, 250}, 100, 10));
+    TerrainModel terrain;
+
+    std::vector<CoverageTile> tiles;
+    TiledCoverageStats stats = computeTiledCoverage(radars, terrain, opt, [&](CoverageTile&& t) {
+        tiles.push_back(std::move(t));
+    });
+
+    EXPECT_EQ(tiles.size(), 6u);
+    EXPECT_EQ(stats.tiles, 6u);
+    EXPECT_LE(stats.maxLiveCoverages, opt.numThreads);     // 互不重叠的雷达用完即释放
+    for (const auto& t : tiles) {
+        ASSERT_FALSE(t.coverage.empty());
+        PolygonUtils::BoundingBox b = multiPolygonBounds(t.coverage);
+        EXPECT_GE(b.minX, t.bounds.minX - 1e-9);
+        EXPECT_LE(b.maxX, t.bounds.maxX + 1e-9);
+    }
+}
+
+TEST(TiledCoverage, StitchedTilesMatchManagerResult) {
+    TiledCoverageOptions opt;
+    opt.tileSize = 300;
+    opt.numRays = 32;
+    opt.simplifyEpsilon = 0;
+    opt.smoothIterations = 0;
+    std::vector<RadarParams> radars = {RadarParams(1, "A", {0, 0}, 200, 10),
+                                       RadarParams(2, "B", {250, 100}, 200, 10)};
+    TerrainModel terrain;
+
+    std::vector<CoverageTile> tiles;
+    computeTiledCoverage(radars, terrain, opt, [&](CoverageTile&& t) { tiles.push_back(std::move(t)); });
+    EXPECT_GT(tiles.size(), 1u);
+    MultiPolygon stitched = stitchTiles(tiles);
+
+    CoverageMergeManager manager;
+    manager.setNumRays(opt.numRays);
+    manager.setSimplifyEpsilon(0);
+    manager.setSmoothIterations(0);
+    for (const auto& r : radars) manager.addRadar(r);
+    EXPECT_EQ(stitched.size(), 1u);
+    EXPECT_NEAR(totalArea(stitched), totalArea(manager.getMergedCoverage()), 1.0);
+}
+
+// ============================================================================
+// 分块 DEM 预取测试
+// ============================================================================
+
+namespace {
+
+/** 按当前测试名加随机后缀生成的临时文件，ctest -j 并行时互不冲突；析构时连同 .tmp 一起删除 */
+class TempFile {
+public:
+    explicit TempFile(const std::string& extension) {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        std::string name = std::string("rc_") + info->test_suite_name() + "_" + info->name() + "_" +
+                           std::to_string(std::random_device{}()) + extension;
+        path_ = (std::filesystem::temp_directory_path() / name).string();
+    }
+    ~TempFile() {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+        std::filesystem::remove_all(path_ + ".tmp", ec);
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+} // namespace
+
+TEST(DemPrefetch, RayTilesRunOutwardFromSite) {
+    ElevationGrid grid(129, 129, 0, 0, 10);            // 8 x 8 块，每块 160 米
+    TempFile file(".rctdem");
+    const std::string& path = file.path();
+    TiledDem::write(grid, path, 16);
+    {
+        TiledDem dem(path, 4 * 17 * 17 * sizeof(float));
+        std::vector<DemTileRef> tiles = rayTiles(dem, RadarParams(1, "R", {560, 560}, 350, 10), 4);
+
+        ASSERT_EQ(tiles.size(), 9u);                   // 站址所在块 + 四个方向各两块
+        EXPECT_EQ(tiles[0].tx, 3u);
+        EXPECT_EQ(tiles[0].ty, 3u);
+        for (size_t i = 1; i < 5; i++) {
+            EXPECT_EQ(std::abs(int(tiles[i].tx) - 3) + std::abs(int(tiles[i].ty) - 3), 1);
+        }
+        for (size_t i = 5; i < 9; i++) {
+            EXPECT_EQ(std::abs(int(tiles[i].tx) - 3) + std::abs(int(tiles[i].ty) - 3), 2);
+        }
+    }
+}
+
+TEST(DemPrefetch, ScheduledTilesAreReadAheadWithoutChangingResults) {
+    FractalTerrainOptions options;
+    options.seed = 3;
+    options.cols = options.rows = 257;
+    options.cellSize = 50.0;
+    options.relief = 300.0;
+    TempFile file(".rctdem");
+    const std::string& path = file.path();
+    TiledDem::write(generateFractalTerrain(options), path, 32);
+    {
+        auto plain = std::make_shared<TiledDem>(path, 64 * 33 * 33 * sizeof(float));
+        auto dem = std::make_shared<TiledDem>(path, 64 * 33 * 33 * sizeof(float));
+
+        CoverageMergeManager expected, prefetched;
+        expected.terrain().setElevationFunction(TiledDem::asFunction(plain));
+        prefetched.terrain().setElevationFunction(TiledDem::asFunction(dem));
+        for (int i = 0; i < 6; i++) {
+            RadarParams r(i, "R", {1500.0 + i * 1800.0, 2000.0 + (i % 3) * 3000.0}, 3000, 40);
+            expected.addRadar(r);
+            prefetched.addRadar(r);
+        }
+
+        // 计算前先排队并等领先窗口读满，计数不取决于预取与计算线程的竞争
+        DemPrefetcher prefetcher(dem, 2, 8);
+        std::vector<size_t> order = {0, 1, 2, 3, 4, 5};
+        prefetcher.schedule(prefetched.getRadars(), order, prefetched.getNumRays());
+        prefetcher.waitIdle();
+        EXPECT_EQ(dem->stats().prefetched, 8u);
+        EXPECT_EQ(dem->stats().prefetchUsed, 0u);
+
+        // 计算线程用到第一块后窗口前移，预取线程被唤醒读入下一块
+        const RadarParams& first = prefetched.getRadars()[0];
+        dem->sample(first.position.x, first.position.y);
+        prefetcher.waitIdle();
+        EXPECT_EQ(dem->stats().prefetchUsed, 1u);
+        EXPECT_EQ(dem->stats().prefetched, 9u);
+
+        prefetched.setScheduleHook(prefetcher.hook());
+        MultiPolygon a = expected.getMergedCoverage();
+        MultiPolygon b = prefetched.getMergedCoverage();
+        prefetcher.waitIdle();
+        prefetched.setScheduleHook({});
+
+        EXPECT_DOUBLE_EQ(totalArea(a), totalArea(b));
+        DemCacheStats s = dem->stats();
+        EXPECT_GE(s.prefetched, 9u);
+        EXPECT_LE(s.prefetchUsed, s.prefetched);
+        EXPECT_LE(s.peakResidentBytes, s.budgetBytes);
+        EXPECT_EQ(s.bytesRead, (s.misses - s.waits + s.prefetched) * dem->tileBytes());
+    }
+}
+
+TEST(DemPrefetch, RescheduleKeepsSequenceNumbersMonotonic) {
+    FractalTerrainOptions options;
+    options.seed = 5;
+    options.cols = options.rows = 257;
+    options.cellSize = 50.0;
+    TempFile file(".rctdem");
+    TiledDem::write(generateFractalTerrain(options), file.path(), 32);  // 8 x 8 块，每块 1600 米
+    auto dem = std::make_shared<TiledDem>(file.path(), 64 * 33 * 33 * sizeof(float));
+    const int rays = 16;
+    std::vector<RadarParams> radars = {RadarParams(1, "A", {1000, 1000}, 3000, 20),
+                                       RadarParams(2, "B", {11000, 11000}, 3000, 20)};
+    const std::vector<DemTileRef> first = rayTiles(*dem, radars[0], rays);
+    ASSERT_GE(first.size(), 2u);
+
+    DemPrefetcher prefetcher(dem, 1, 2);
+    prefetcher.schedule(radars, {0}, rays);
+    prefetcher.waitIdle();
+    EXPECT_EQ(dem->stats().prefetched, 2u);
+
+    // 改为只算 B：A 的两块已读入未用到，新队列从它们之后编号
+    prefetcher.schedule(radars, {1}, rays);
+    prefetcher.waitIdle();
+    EXPECT_EQ(dem->stats().prefetched, 4u);
+    EXPECT_GE(dem->prefetchProgress(), 2u);
+
+    // 用到旧调度的瓦片不推进新窗口
+    const double tileSize = dem->tileCells() * dem->cellSize();
+    dem->sample(dem->originX() + (first[1].tx + 0.5) * tileSize, dem->originY() + (first[1].ty + 0.5) * tileSize);
+    prefetcher.waitIdle();
+    EXPECT_EQ(dem->stats().prefetchUsed, 1u);
+    EXPECT_EQ(dem->stats().prefetched, 4u);
+}
+
+TEST(DemPrefetch, ThreadCachedTileReportsProgressAfterReload) {
+    ElevationGrid grid(33, 33, 0, 0, 10);              // 2 x 2 块，每块 160 米
+    TempFile file(".rctdem");
+    TiledDem::write(grid, file.path(), 16);
+    TiledDem dem(file.path(), 17 * 17 * sizeof(float));   // 只容得下一块
+
+    dem.sample(50, 50);                                 // 本线程记住块 (0, 0)
+    std::async(std::launch::async, [&] { dem.sample(250, 50); }).get();   // 其他线程挤掉它
+    ASSERT_TRUE(dem.prefetch(0, 0, 1));                 // 预取线程重新读入
+
+    // 本线程仍持有旧的那份，但必须报告用到了预取的块，否则预取窗口不再前移
+    dem.sample(60, 60);
+    EXPECT_EQ(dem.prefetchProgress(), 1u);
+    EXPECT_EQ(dem.stats().prefetchUsed, 1u);
+}
+
+// ============================================================================
+// 地平剖面测试
+// ============================================================================
+
+TEST(HorizonProfile, MatchesBisectionAndSeesOverRidgeWithTallTargets) {
+    TerrainModel terrain;
+    terrain.addObstacle({3000, 0}, 300, 5000, 150);          // 东侧南北向山脊
+    RadarParams radar(1, "R", {0, 0}, 4000, 100);            // 量程内不受地球曲率限制
+    const int rays = 36;
+    const double spacing = radar.range * terrain.getSamplingSettings().rangeTolerance;
+    HorizonProfile profile = HorizonProfile::compute(terrain, radar, rays, radar.range, spacing);
+
+    EXPECT_EQ(profile.samplesPerRay(), 100u);
+    Polygon viaProfile = profile.coveragePolygon(radar);
+    Polygon viaBisection = generateCoveragePolygon(radar, terrain, rays);
+    ASSERT_EQ(viaProfile.size(), viaBisection.size());
+    for (size_t i = 0; i < viaProfile.size(); i++) {
+        EXPECT_NEAR((viaProfile[i] - radar.position).length(),
+                    (viaBisection[i] - radar.position).length(), 2 * spacing) << "ray " << i;
+    }
+
+    double east = profile.visibleRange(0, radar.range);
+    EXPECT_GT(east, 2000);
+    EXPECT_LT(east, 3000);
+    EXPECT_DOUBLE_EQ(profile.visibleRange(0, 1500), 1500);      // 缩短量程不需重新采样
+    EXPECT_DOUBLE_EQ(profile.visibleRange(0, radar.range, 2000), radar.range);
+    EXPECT_DOUBLE_EQ(profile.visibleRange(rays / 2, radar.range), radar.range);
+}
+
+TEST(HorizonProfile, ManagerReusesProfileWhenOnlyRangeChanges) {
+    CoverageMergeManager manager;
+    manager.setNumRays(36);
+    manager.setHorizonCache(true);
+    manager.terrain().addObstacle({3000, 0}, 300, 5000, 150);
+    RadarParams radar(1, "R", {0, 0}, 8000, 30);
+    manager.addRadar(radar);
+    manager.getMergedCoverage();
+    auto profile = manager.getHorizonProfile(1);
+    ASSERT_TRUE(profile);
+
+    manager.resetPerfStats();
+    radar.range = 6000;
+    manager.updateRadar(1, radar);
+    manager.getMergedCoverage();
+    EXPECT_EQ(manager.getHorizonProfile(1), profile);
+    if (PerfStats::enabled) {
+        EXPECT_EQ(manager.getPerfStats().elevationEvaluations, 0u);
+    }
+    for (const auto& p : manager.getIndividualCoverages()[0]) {
+        EXPECT_LE((p - radar.position).length(), radar.range + 1e-9);
+    }
+
+    // 剖面范围内（超出当前量程）的地形变化同样使其失效
+    manager.terrain().addObstacle({7000, 0}, 100, 100, 50);
+    manager.getMergedCoverage();
+    EXPECT_NE(manager.getHorizonProfile(1), profile);
+
+    radar.height = 60;
+    manager.updateRadar(1, radar);
+    profile = manager.getHorizonProfile(1);
+    manager.getMergedCoverage();
+    EXPECT_NE(manager.getHorizonProfile(1), profile);
+    EXPECT_DOUBLE_EQ(manager.getHorizonProfile(1)->antennaHeight(), 60);
+}
+
+namespace {
+
+/** 带起伏的 DEM，地平存储测试共用 */
+std::shared_ptr<ElevationGrid> makeHorizonStoreGrid() {
+    auto grid = std::make_shared<ElevationGrid>(81, 81, -4000, -4000, 100);
+    for (uint32_t r = 0; r < grid->rows(); r++) {
+        for (uint32_t c = 0; c < grid->cols(); c++) grid->at(c, r) = static_cast<float>((c * 7 + r * 3) % 40);
+    }
+    return grid;
+}
+
+/** 以 grid 为高程、挂接 store 的管理器，加入雷达 1 并计算一次覆盖 */
+std::unique_ptr<CoverageMergeManager> runWithStore(HorizonStore& store,
+                                                   const std::shared_ptr<ElevationGrid>& grid) {
+    auto manager = std::make_unique<CoverageMergeManager>();
+    manager->setNumRays(36);
+    manager->terrain().setElevationFunction(ElevationGrid::asFunction(grid));
+    manager->terrain().addObstacle({2000, 0}, 200, 3000, 120);
+    manager->setHorizonCache(true);
+    manager->setHorizonStore(store.hooks());
+    manager->addRadar(RadarParams(1, "R", {0, 0}, 3500, 30));
+    manager->resetPerfStats();
+    manager->getMergedCoverage();
+    return manager;
+}
+
+} // namespace
+
+TEST(HorizonStore, ReusesProfilesAcrossRestarts) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    Polygon first;
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        first = runWithStore(store, grid)->getIndividualCoverages()[0];
+        EXPECT_EQ(store.stats().misses, 1u);
+        EXPECT_EQ(store.stats().writes, 1u);
+    }
+
+    // 重新打开：剖面取自映射文件，不再采样地形
+    HorizonStore store(file.path(), grid->checksum());
+    EXPECT_EQ(store.stats().entries, 1u);
+    auto manager = runWithStore(store, grid);
+    EXPECT_EQ(store.stats().hits, 1u);
+    EXPECT_EQ(manager->getHorizonProfile(1)->memoryBytes(), 0u);
+    if (PerfStats::enabled) {
+        EXPECT_EQ(manager->getPerfStats().elevationEvaluations, 0u);
+    }
+    const Polygon& again = manager->getIndividualCoverages()[0];
+    ASSERT_EQ(again.size(), first.size());
+    for (size_t i = 0; i < first.size(); i++) {
+        EXPECT_DOUBLE_EQ(again[i].x, first[i].x);
+        EXPECT_DOUBLE_EQ(again[i].y, first[i].y);
+    }
+}
+
+TEST(HorizonStore, ConcurrentFindsLoadTheSameRecord) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    SamplingSettings sampling;
+    uint64_t terrainChecksum = 0;
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        auto manager = runWithStore(store, grid);
+        sampling = manager->getSamplingSettings();
+        terrainChecksum = manager->terrain().contentChecksum();
+    }
+
+    // 重新打开后记录尚未解码，并发查找各自在锁外校验，结果都命中同一份数据
+    HorizonStore store(file.path(), grid->checksum());
+    const RadarParams radar(1, "R", {0, 0}, 3500, 30);
+    std::vector<std::future<std::shared_ptr<const HorizonProfile>>> lookups;
+    for (int i = 0; i < 8; i++) {
+        lookups.push_back(std::async(std::launch::async, [&] {
+            return store.find(radar, 36, sampling, terrainChecksum);
+        }));
+    }
+    for (auto& f : lookups) {
+        auto profile = f.get();
+        ASSERT_TRUE(profile);
+        EXPECT_TRUE(profile->matches(radar, 36));
+    }
+    EXPECT_EQ(store.stats().hits, 8u);
+    EXPECT_EQ(store.stats().corrupt, 0u);
+    EXPECT_EQ(store.find(radar, 36, sampling, terrainChecksum)->data(),
+              store.find(radar, 36, sampling, terrainChecksum)->data());
+}
+
+TEST(HorizonStore, ObstacleEditsAfterAttachKeepUsingStore) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        auto manager = runWithStore(store, grid);
+        EXPECT_EQ(store.stats().writes, 1u);
+
+        // 障碍变化改变键：未命中，新剖面按新键写入；之后的每次修改同样如此
+        manager->terrain().addObstacle({-2000, 0}, 200, 200, 80);
+        manager->getMergedCoverage();
+        EXPECT_EQ(store.stats().misses, 2u);
+        EXPECT_EQ(store.stats().writes, 2u);
+
+        // 撤销修改后内容与挂接时相同，命中最初写入的剖面
+        manager->terrain().removeObstacle(1);
+        manager->getMergedCoverage();
+        EXPECT_EQ(store.stats().hits, 1u);
+        EXPECT_EQ(store.stats().writes, 2u);
+    }
+
+    HorizonStore store(file.path(), grid->checksum());
+    EXPECT_EQ(store.stats().entries, 2u);
+    auto manager = runWithStore(store, grid);
+    manager->terrain().addObstacle({-2000, 0}, 200, 200, 80);
+    manager->getMergedCoverage();
+    EXPECT_EQ(store.stats().hits, 2u);
+    EXPECT_EQ(store.stats().writes, 0u);
+}
+
+TEST(HorizonStore, ElevationChangeAfterAttachBypassesStore) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    HorizonStore store(file.path(), grid->checksum());
+    auto manager = runWithStore(store, grid);
+    EXPECT_EQ(store.stats().writes, 1u);
+
+    // DEM 校验和不变，存储无法区分新旧高程，只能绕过
+    grid->at(50, 40) += 500.0f;
+    manager->terrain().markChanged({0, 0, 4000, 4000});
+    manager->getMergedCoverage();
+    EXPECT_EQ(store.stats().misses, 1u);
+    EXPECT_EQ(store.stats().writes, 1u);
+
+    manager->terrain().addObstacle({-2000, 0}, 200, 200, 80);
+    manager->getMergedCoverage();
+    EXPECT_EQ(store.stats().misses, 1u);
+    EXPECT_EQ(store.stats().writes, 1u);
+}
+
+TEST(HorizonStore, ReplacedTerrainInstanceBypassesStore) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    HorizonStore store(file.path(), grid->checksum());
+    auto manager = runWithStore(store, grid);
+    EXPECT_EQ(store.stats().writes, 1u);
+
+    // 整体替换为版本号相同的另一地形实例
+    TerrainModel other;
+    other.setElevationFunction([](double, double) { return 0.0; });
+    other.addObstacle({2000, 0}, 200, 3000, 120);
+    ASSERT_EQ(other.version(), manager->terrain().version());
+    manager->terrain() = other;
+    manager->getMergedCoverage();
+    EXPECT_EQ(store.stats().misses, 1u);
+    EXPECT_EQ(store.stats().writes, 1u);
+}
+
+TEST(HorizonStore, TruncatesPartialTailRecord) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        runWithStore(store, grid);
+    }
+    const auto intactBytes = std::filesystem::file_size(file.path());
+
+    std::FILE* f = std::fopen(file.path().c_str(), "ab");
+    ASSERT_NE(f, nullptr);
+    std::fputs("partial", f);
+    std::fclose(f);
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        EXPECT_EQ(store.stats().entries, 1u);
+    }
+    EXPECT_EQ(std::filesystem::file_size(file.path()), intactBytes);
+}
+
+TEST(HorizonStore, DemChangeMakesRecordsStaleAndCompactDropsThem) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        runWithStore(store, grid);
+    }
+    const auto oneRecordBytes = std::filesystem::file_size(file.path());
+
+    // DEM 变化：校验和不同，旧剖面不再命中
+    grid->at(50, 40) += 500.0f;
+    HorizonStore store(file.path(), grid->checksum());
+    EXPECT_EQ(store.stats().entries, 0u);
+    EXPECT_EQ(store.stats().staleRecords, 1u);
+    runWithStore(store, grid);
+    EXPECT_EQ(store.stats().misses, 1u);
+    EXPECT_EQ(store.stats().writes, 1u);
+
+    store.compact();
+    EXPECT_EQ(store.stats().staleRecords, 0u);
+    EXPECT_EQ(store.stats().entries, 1u);
+    EXPECT_EQ(store.stats().fileBytes, oneRecordBytes);
+}
+
+TEST(HorizonStore, FailedCompactLeavesStoreWritable) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        auto manager = runWithStore(store, grid);
+
+        // 临时文件位置被非空目录占据，compact 无法创建临时文件
+        const std::string tmp = file.path() + ".tmp";
+        std::filesystem::create_directory(tmp);
+        std::FILE* touch = std::fopen((tmp + "/keep").c_str(), "wb");
+        ASSERT_NE(touch, nullptr);
+        std::fclose(touch);
+        EXPECT_THROW(store.compact(), std::runtime_error);
+        std::filesystem::remove_all(tmp);
+
+        store.put(manager->getHorizonProfile(1), manager->getSamplingSettings(), 12345);
+        EXPECT_EQ(store.stats().writes, 2u);
+        EXPECT_EQ(store.stats().entries, 2u);
+    }
+    HorizonStore store(file.path(), grid->checksum());
+    EXPECT_EQ(store.stats().entries, 2u);
+}
+
+TEST(HorizonStore, SkipsCorruptRecordInTheMiddle) {
+    TempFile file(".rchz");
+    auto grid = makeHorizonStoreGrid();
+    {
+        HorizonStore store(file.path(), grid->checksum());
+        auto manager = runWithStore(store, grid);
+        store.put(manager->getHorizonProfile(1), manager->getSamplingSettings(), 12345);
+    }
+    const auto twoRecordBytes = std::filesystem::file_size(file.path());
+
+    // 损坏第一条记录的头：跳过该记录，之后的记录保留，文件不截断
+    std::FILE* f = std::fopen(file.path().c_str(), "r+b");
+    ASSERT_NE(f, nullptr);
+    std::fseek(f, HorizonStore::kHeaderSize, SEEK_SET);
+    std::fputs("garbage", f);
+    std::fclose(f);
+
+    HorizonStore store(file.path(), grid->checksum());
+    EXPECT_EQ(store.stats().entries, 1u);
+    EXPECT_EQ(store.stats().corrupt, 1u);
+    EXPECT_EQ(store.stats().fileBytes, twoRecordBytes);
+    EXPECT_EQ(std::filesystem::file_size(file.path()), twoRecordBytes);
+
+    store.compact();
+    EXPECT_EQ(store.stats().entries, 1u);
+    EXPECT_LT(store.stats().fileBytes, twoRecordBytes);
+}
+
+TEST(HorizonStore, TighterRangeToleranceMissesCoarseProfiles) {
+    TempFile file(".rchz");
+    const std::string& path = file.path();
+    auto run = [&](HorizonStore& store, double rangeTolerance) {
+        CoverageMergeManager manager;
+        manager.setNumRays(24);
+        SamplingSettings sampling;
+        sampling.rangeTolerance = rangeTolerance;
+        manager.setSamplingSettings(sampling);
+        manager.terrain().addObstacle({2000, 0}, 200, 3000, 120);
+        manager.setHorizonCache(true);
+        manager.setHorizonStore(store.hooks());
+        manager.addRadar(RadarParams(1, "R", {0, 0}, 3500, 30));
+        manager.getMergedCoverage();
+        return manager.getHorizonProfile(1)->spacing();
+    };
+    {
+        HorizonStore store(path, 0);
+        run(store, 0.01);
+        EXPECT_EQ(store.stats().writes, 1u);
+    }
+    {
+        // 收紧 4 倍：粗剖面的间距仍在 usable 的 4 倍余量内，但不应由存储返回
+        HorizonStore store(path, 0);
+        EXPECT_DOUBLE_EQ(run(store, 0.0025), 3500 * 0.0025);
+        EXPECT_EQ(store.stats().hits, 0u);
+        EXPECT_EQ(store.stats().writes, 1u);
+        EXPECT_DOUBLE_EQ(run(store, 0.01), 3500 * 0.01);
+        EXPECT_EQ(store.stats().hits, 1u);
+    }
+}
@@ -90,6 +90,81 @@ TEST(PolygonUtils, PointInPolygon) {
     EXPECT_FALSE(PolygonUtils::pointInPolygon({-2, 0}, square));
 }
 
+// ============================================================================
+// 几何内核测试
+// ============================================================================
+
+namespace {
+
+// 参考实现：逐顶点取模的标量循环
+double referenceSignedArea(const Polygon& poly) {
+    if (poly.size() < 3) return 0.0;
+    double area = 0.0;
+    for (size_t i = 0; i < poly.size(); i++) {
+        const Point2D& a = poly[i];
+        const Point2D& b = poly[(i + 1) % poly.size()];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return area / 2.0;
+}
+
+double referencePerimeter(const Polygon& poly) {
+    if (poly.size() < 2) return 0.0;
+    double perim = 0.0;
+    for (size_t i = 0; i < poly.size(); i++) {
+        perim += (poly[(i + 1) % poly.size()] - poly[i]).length();
+    }
+    return perim;
+}
+
+} // namespace
+
+TEST(GeometryKernels, MatchScalarReferenceForAllTailLengths) {
+    // 覆盖 SIMD 主循环与各种尾部长度
+    for (int n = 0; n <= 37; n++) {
+        Polygon poly;
+        for (int i = 0; i < n; i++) {
+            double angle = 2 * M_PI * i / std::max(n, 1);
+            double r = 10.0 + 3.0 * std::sin(5.0 * angle);
+            poly.push_back({100.0 + r * std::cos(angle), -50.0 + r * std::sin(angle)});
+        }
+        
+        EXPECT_NEAR(PolygonUtils::signedArea(poly), referenceSignedArea(poly), 1e-9) << "n=" << n;
+        EXPECT_NEAR(PolygonUtils::perimeter(poly), referencePerimeter(poly), 1e-9) << "n=" << n;
+        
+        if (n > 0) {
+            auto bbox = PolygonUtils::boundingBox(poly);
+            double minX = poly[0].x, maxX = poly[0].x, minY = poly[0].y, maxY = poly[0].y;
+            for (const auto& p : poly) {
+                minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+                minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+            }
+            EXPECT_EQ(bbox.minX, minX);
+            EXPECT_EQ(bbox.maxX, maxX);
+            EXPECT_EQ(bbox.minY, minY);
+            EXPECT_EQ(bbox.maxY, maxY);
+        }
+    }
+}
+
+TEST(PolygonStats, ParallelMatchesSerial) {
+    MultiPolygon mp;
+    for (int i = 0; i < 50; i++) {
+        PolygonWithHoles pwh;
+        pwh.outer = createCircle(i * 100.0, 0, 40, 500);
+        pwh.holes.push_back(createCircle(i * 100.0, 0, 10, 100));
+        mp.push_back(pwh);
+    }
+    
+    PolygonStats serial = PolygonStats::compute(mp);
+    PolygonStats parallel = PolygonStats::computeParallel(mp, 4, 0);
+    
+    EXPECT_EQ(parallel.regionCount, serial.regionCount);
+    EXPECT_EQ(parallel.totalHoleCount, serial.totalHoleCount);
+    EXPECT_NEAR(parallel.totalArea, serial.totalArea, 1e-6 * serial.totalArea);
+    EXPECT_NEAR(parallel.totalPerimeter, serial.totalPerimeter, 1e-6 * serial.totalPerimeter);
+}
+
 // ============================================================================
 // 并集测试
 // ============================================================================